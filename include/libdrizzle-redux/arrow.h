@@ -0,0 +1,139 @@
+/* vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ * Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @file
+ * @brief Arrow C Data Interface export of result sets
+ *
+ * The structures are the stable ABI of the Arrow C data and C stream
+ * interfaces, declared here unless another header already did, so no
+ * Arrow library is needed to produce them.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema
+{
+  const char *format;
+  const char *name;
+  const char *metadata;
+  int64_t flags;
+  int64_t n_children;
+  struct ArrowSchema **children;
+  struct ArrowSchema *dictionary;
+  void (*release)(struct ArrowSchema *);
+  void *private_data;
+};
+
+struct ArrowArray
+{
+  int64_t length;
+  int64_t null_count;
+  int64_t offset;
+  int64_t n_buffers;
+  int64_t n_children;
+  const void **buffers;
+  struct ArrowArray **children;
+  struct ArrowArray *dictionary;
+  void (*release)(struct ArrowArray *);
+  void *private_data;
+};
+
+#endif /* ARROW_C_DATA_INTERFACE */
+
+#ifndef ARROW_C_STREAM_INTERFACE
+#define ARROW_C_STREAM_INTERFACE
+
+struct ArrowArrayStream
+{
+  int (*get_schema)(struct ArrowArrayStream *, struct ArrowSchema *out);
+  int (*get_next)(struct ArrowArrayStream *, struct ArrowArray *out);
+  const char *(*get_last_error)(struct ArrowArrayStream *);
+  void (*release)(struct ArrowArrayStream *);
+  void *private_data;
+};
+
+#endif /* ARROW_C_STREAM_INTERFACE */
+
+/**
+ * @addtogroup drizzle_result_client
+ * @{
+ */
+
+/**
+ * Exports the unread rows of a text result set as an Arrow record batch
+ * stream. Every get_next() call of the stream reads up to batch_rows rows
+ * into a struct array with one child array per column, which owns its
+ * buffers and stays valid after the result is freed. The stream itself
+ * reads from the result, which has to outlive it.
+ *
+ * Columns are mapped to Arrow types by their drizzle_column_type_t:
+ * integers to int64, unsigned BIGINT to uint64, FLOAT and DOUBLE to
+ * float64, DATE to date32, DATETIME and TIMESTAMP to timestamp[us], TIME to
+ * duration[us], binary strings, BLOB, BIT and GEOMETRY to large_binary and
+ * all other columns to large_utf8. Zero dates are exported as NULL.
+ *
+ * On a non-blocking connection get_next() returns EAGAIN when it has to
+ * wait for the server and continues the batch when called again.
+ *
+ * @param[in,out] result A result object whose rows were not buffered
+ * @param[in] batch_rows The maximum number of rows of a record batch
+ * @param[out] stream The stream to initialize, released by the caller
+ * @return DRIZZLE_RETURN_OK upon success, DRIZZLE_RETURN_INVALID_ARGUMENT
+ *         for binary rows, buffered rows or a batch_rows of 0
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_result_arrow_stream(drizzle_result_st *result,
+                                             uint64_t batch_rows,
+                                             struct ArrowArrayStream *stream);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
@@ -134,6 +134,24 @@ DRIZZLE_API
 drizzle_column_st *drizzle_column_index(drizzle_result_st *result,
                                         uint16_t column);
 
+/**
+ * Gets the number of a column from its name in a column buffered result
+ * set. The names are hashed into an index on the first lookup so later
+ * lookups do not scan the columns. When several columns have the same name
+ * the first one is returned.
+ *
+ * @param[in,out] result pointer to the structure to read from.
+ * @param[in]     column_name The column name to look up
+ * @param[out]    ret_ptr A pointer to a drizzle_return_t to store the return
+ *   status into, DRIZZLE_RETURN_NOT_FOUND if the column name cannot be found
+ * @return The column number, for use with drizzle_column_index() and the
+ *   row field arrays
+ */
+DRIZZLE_API
+uint16_t drizzle_column_lookup(drizzle_result_st *result,
+                               const char *column_name,
+                               drizzle_return_t *ret_ptr);
+
 /**
  * Gets the column number in a buffered or unbuffered column result set
  *
@@ -276,6 +276,66 @@ void drizzle_options_set_multi_statements(drizzle_options_st *options, bool stat
 DRIZZLE_API
 bool drizzle_options_get_multi_statements(drizzle_options_st *options);
 
+/**
+ * Sets/unsets the LOAD DATA LOCAL INFILE connect option. The data is supplied
+ * with drizzle_set_local_infile_fn() or drizzle_set_local_infile_fd().
+ *
+ * @param[in,out] options The options object to modify
+ * @param[in] state Set to true/false
+ */
+DRIZZLE_API
+void drizzle_options_set_local_infile(drizzle_options_st *options, bool state);
+
+/**
+ * Gets the LOAD DATA LOCAL INFILE connect option
+ *
+ * @param[in] options The options object to get the value from
+ * @return The state of the local infile option
+ */
+DRIZZLE_API
+bool drizzle_options_get_local_infile(drizzle_options_st *options);
+
+/**
+ * Sets/unsets the metadata caching connect option. When the server supports
+ * it, the column definitions of prepared statement result sets are only sent
+ * when they changed since the last execution.
+ *
+ * @param[in,out] options The options object to modify
+ * @param[in] state Set to true/false
+ */
+DRIZZLE_API
+void drizzle_options_set_cache_metadata(drizzle_options_st *options, bool state);
+
+/**
+ * Gets the metadata caching connect option
+ *
+ * @param[in] options The options object to get the value from
+ * @return The state of the metadata caching option
+ */
+DRIZZLE_API
+bool drizzle_options_get_cache_metadata(drizzle_options_st *options);
+
+/**
+ * Sets/unsets the bulk operations connect option, which is set by default.
+ * When the server supports it, drizzle_stmt_execute_bulk() sends the rows
+ * with as few COM_STMT_BULK_EXECUTE commands as fit into the connection
+ * buffer instead of one execution per row.
+ *
+ * @param[in,out] options The options object to modify
+ * @param[in] state Set to true/false
+ */
+DRIZZLE_API
+void drizzle_options_set_bulk_operations(drizzle_options_st *options, bool state);
+
+/**
+ * Gets the bulk operations connect option
+ *
+ * @param[in] options The options object to get the value from
+ * @return The state of the bulk operations option
+ */
+DRIZZLE_API
+bool drizzle_options_get_bulk_operations(drizzle_options_st *options);
+
 /**
  * Sets/unsets the auth plugin connect option
  *
@@ -79,6 +79,7 @@ extern "C" {
 #define DRIZZLE_MAX_COLUMN_NAME_SIZE     2048
 #define DRIZZLE_MAX_DEFAULT_VALUE_SIZE   2048
 #define DRIZZLE_MAX_PACKET_SIZE          UINT32_MAX
+#define DRIZZLE_MAX_PAYLOAD_SIZE         0xFFFFFF
 #define DRIZZLE_MAX_BUFFER_SIZE          1024*1024*1024
 #define DRIZZLE_DEFAULT_BUFFER_SIZE      1024*1024
 #define DRIZZLE_BUFFER_COPY_THRESHOLD    8192
@@ -87,6 +88,13 @@ extern "C" {
 #define DRIZZLE_MAX_SCRAMBLE_SIZE        20
 #define DRIZZLE_STATE_STACK_SIZE         8
 #define DRIZZLE_ROW_GROW_SIZE            8192
+#define DRIZZLE_RESULT_CHUNK_SIZE        1024*1024
+#define DRIZZLE_QUERY_BATCH_BUFFER_SIZE  64*1024
+#define DRIZZLE_QUERY_TEMPLATE_VALUES_SIZE 1024
+#define DRIZZLE_STMT_BULK_WINDOW         4096
+#define DRIZZLE_STMT_QUEUE_LIMIT         256
+#define DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE 1024*1024
+#define DRIZZLE_STMT_LONG_DATA_IOV_MAX   16
 #define DRIZZLE_DEFAULT_SOCKET_TIMEOUT   10
 #define DRIZZLE_DEFAULT_SOCKET_SEND_SIZE DRIZZLE_DEFAULT_BUFFER_SIZE
 #define DRIZZLE_DEFAULT_SOCKET_RECV_SIZE DRIZZLE_DEFAULT_BUFFER_SIZE
@@ -181,13 +189,31 @@ enum drizzle_result_options_t
   DRIZZLE_RESULT_BUFFER_ROW=    (1 << 3),
   DRIZZLE_RESULT_EOF_PACKET=    (1 << 4),
   DRIZZLE_RESULT_ROW_BREAK=     (1 << 5),
-  DRIZZLE_RESULT_BINARY_ROWS=   (1 << 6)
+  DRIZZLE_RESULT_BINARY_ROWS=   (1 << 6),
+  DRIZZLE_RESULT_BUFFER_COLUMNAR= (1 << 7)
 };
 
 #ifndef __cplusplus
 typedef enum drizzle_result_options_t drizzle_result_options_t;
 #endif
 
+/**
+ * @ingroup drizzle_result
+ * Value types of the column vectors of drizzle_result_buffer_columnar().
+ */
+enum drizzle_vector_type_t
+{
+  DRIZZLE_VECTOR_NONE,
+  DRIZZLE_VECTOR_INT64,
+  DRIZZLE_VECTOR_UINT64,
+  DRIZZLE_VECTOR_DOUBLE,
+  DRIZZLE_VECTOR_STRING
+};
+
+#ifndef __cplusplus
+typedef enum drizzle_vector_type_t drizzle_vector_type_t;
+#endif
+
 /**
  * @ingroup drizzle_column
  * Options for drizzle_column_st, currently unused.
@@ -593,6 +619,11 @@ typedef struct drizzle_binlog_st drizzle_binlog_st;
 typedef struct drizzle_binlog_event_st drizzle_binlog_event_st;
 typedef struct drizzle_stmt_st drizzle_stmt_st;
 typedef struct drizzle_bind_st drizzle_bind_st;
+typedef struct drizzle_datetime_st drizzle_datetime_st;
+typedef struct drizzle_query_batch_st drizzle_query_batch_st;
+typedef struct drizzle_query_template_st drizzle_query_template_st;
+typedef struct drizzle_field_view_st drizzle_field_view_st;
+typedef struct drizzle_decimal_st drizzle_decimal_st;
 typedef char *drizzle_field_t;
 typedef drizzle_field_t *drizzle_row_t;
 
@@ -603,6 +634,20 @@ typedef void (drizzle_binlog_error_fn)(drizzle_return_t error, drizzle_st *con,
 typedef drizzle_return_t (drizzle_state_fn)(drizzle_st *con);
 typedef void (drizzle_context_free_fn)(drizzle_st *con,
                                            void *context);
+/**
+ * Custom function called for every row by drizzle_result_visit().
+ *
+ * @param[in] result Result the row belongs to.
+ * @param[in] fields drizzle_result_column_count() views of the fields of the
+ *  row, valid until the function returns.
+ * @param[in] context Application context pointer passed to
+ *  drizzle_result_visit().
+ * @return DRIZZLE_RETURN_OK to continue with the next row, any other value
+ *  stops the visit.
+ */
+typedef drizzle_return_t (drizzle_row_visit_fn)(drizzle_result_st *result,
+                                                const drizzle_field_view_st *fields,
+                                                void *context);
 /**
  * Custom function to register or deregister interest in file descriptor
  * events. See drizzle_set_event_watch_fn().
@@ -619,6 +664,24 @@ typedef drizzle_return_t (drizzle_event_watch_fn)(drizzle_st *con,
                                                   short events,
                                                   void *context);
 
+/**
+ * Custom function supplying the data for a LOAD DATA LOCAL INFILE statement.
+ * See drizzle_set_local_infile_fn().
+ *
+ * @param[in] con Connection that is sending the file.
+ * @param[in] filename File name requested by the server.
+ * @param[out] buffer Buffer to read the data into.
+ * @param[in] size Maximum number of bytes to read into buffer.
+ * @param[in] context Application context pointer registered with
+ *  drizzle_set_local_infile_fn().
+ * @return The number of bytes read, 0 at the end of the data or -1 on error.
+ */
+typedef ssize_t (drizzle_local_infile_fn)(drizzle_st *con,
+                                          const char *filename,
+                                          unsigned char *buffer,
+                                          size_t size,
+                                          void *context);
+
 /** @} */
 
 /**
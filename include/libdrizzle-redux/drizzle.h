@@ -183,6 +183,36 @@ void drizzle_set_event_watch_fn(drizzle_st *con,
                                 drizzle_event_watch_fn *function,
                                 void *context);
 
+/**
+ * Set the function supplying the data for LOAD DATA LOCAL INFILE statements.
+ * The function is called repeatedly until it returns 0, each chunk it returns
+ * is sent to the server as it is read so the file is never buffered as a
+ * whole. The connection option must be enabled with
+ * drizzle_options_set_local_infile(). If the function returns an error the
+ * file is ended early and the query returns DRIZZLE_RETURN_ERROR_CODE with
+ * the reason in drizzle_error(), the connection stays usable. See
+ * drizzle_local_infile_fn().
+ *
+ * @param[in] con Drizzle structure previously initialized with drizzle_create().
+ * @param[in] function Function to call to read the data, NULL to unset.
+ * @param[in] context Argument to pass into the callback function.
+ */
+DRIZZLE_API
+void drizzle_set_local_infile_fn(drizzle_st *con,
+                                 drizzle_local_infile_fn *function,
+                                 void *context);
+
+/**
+ * Set a file descriptor to read the data for LOAD DATA LOCAL INFILE
+ * statements from. The file name requested by the server is ignored. The
+ * descriptor is not closed by libdrizzle. A function set with
+ * drizzle_set_local_infile_fn() takes precedence.
+ *
+ * @param[in] con Drizzle structure previously initialized with drizzle_create().
+ * @param[in] fd File descriptor to read from, -1 to unset.
+ */
+DRIZZLE_API
+void drizzle_set_local_infile_fd(drizzle_st *con, int fd);
 
 /**
  * Wait for I/O on connections.
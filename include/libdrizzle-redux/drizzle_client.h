@@ -58,6 +58,7 @@
 #include <libdrizzle-redux/conn_client.h>
 #include <libdrizzle-redux/query.h>
 #include <libdrizzle-redux/result_client.h>
+#include <libdrizzle-redux/arrow.h>
 #include <libdrizzle-redux/column_client.h>
 #include <libdrizzle-redux/row_client.h>
 #include <libdrizzle-redux/field_client.h>
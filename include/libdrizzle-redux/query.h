@@ -117,6 +117,341 @@ ssize_t drizzle_escape_string(drizzle_st *con, char **to, const char *from, cons
 DRIZZLE_API
 ssize_t drizzle_escape_str(drizzle_st *con, char **to, const char *from, const size_t from_size, bool is_pattern);
 
+/**
+ * Create a batch builder for multi-row queries such as
+ * "INSERT INTO t1 (a, b) VALUES ". Rows are appended to the prefix as value
+ * tuples, escaped directly into a buffer which is reused between queries.
+ *
+ * The batch is sent with drizzle_query() whenever the next row would make the
+ * query larger than the maximum packet size, see
+ * drizzle_query_batch_set_max_packet_size(), and when
+ * drizzle_query_batch_flush() is called. Queries are completed before the
+ * batch functions return, also on non-blocking connections.
+ *
+ * @param[in] con connection to send the queries on.
+ * @param[in] prefix statement text that precedes the value tuples.
+ * @param[in] prefix_size length of the prefix, if 0 strlen() is used.
+ * @param[out] ret_ptr pointer to the result code.
+ * @return a newly allocated batch, or NULL on error.
+ */
+DRIZZLE_API
+drizzle_query_batch_st *drizzle_query_batch_create(drizzle_st *con,
+                                                   const char *prefix,
+                                                   size_t prefix_size,
+                                                   drizzle_return_t *ret_ptr);
+
+/**
+ * Lower the size limit of the queries sent by a batch. By default this is
+ * drizzle_max_packet_size(), capped to the largest single packet. Set it to
+ * the server's max_allowed_packet if that is smaller.
+ *
+ * @param[in] batch the batch to modify.
+ * @param[in] size the maximum packet size in bytes.
+ * @return DRIZZLE_RETURN_INVALID_ARGUMENT if the prefix or the pending rows
+ *         would not fit, DRIZZLE_RETURN_OK otherwise.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_set_max_packet_size(drizzle_query_batch_st *batch,
+                                                         uint32_t size);
+
+/**
+ * Start a new value tuple.
+ *
+ * @param[in] batch the batch to add the row to.
+ * @return a drizzle return code.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_row_begin(drizzle_query_batch_st *batch);
+
+/**
+ * Add a quoted and escaped string value to the current row, escaped as
+ * drizzle_query_template_set_string() does for the connection charset and
+ * the NO_BACKSLASH_ESCAPES SQL mode. A NULL value is added as SQL NULL.
+ *
+ * @param[in] batch the batch to add the value to.
+ * @param[in] value the string value.
+ * @param[in] size the length of the value in bytes.
+ * @return DRIZZLE_RETURN_TRUNCATED if the row can not fit into a single
+ *         query, in which case the row is dropped, or another drizzle
+ *         return code.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_add_string(drizzle_query_batch_st *batch,
+                                                const char *value,
+                                                size_t size);
+
+/**
+ * Add a value to the current row as is, without quoting or escaping. Use this
+ * for numbers, expressions and hex literals.
+ *
+ * @param[in] batch the batch to add the value to.
+ * @param[in] value the SQL text of the value.
+ * @param[in] size the length of the value in bytes.
+ * @return see drizzle_query_batch_add_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_add_literal(drizzle_query_batch_st *batch,
+                                                 const char *value,
+                                                 size_t size);
+
+/**
+ * Add SQL NULL to the current row.
+ *
+ * @param[in] batch the batch to add the value to.
+ * @return see drizzle_query_batch_add_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_add_null(drizzle_query_batch_st *batch);
+
+/**
+ * Add a signed integer to the current row.
+ *
+ * @param[in] batch the batch to add the value to.
+ * @param[in] value the value to add.
+ * @return see drizzle_query_batch_add_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_add_int64(drizzle_query_batch_st *batch,
+                                               int64_t value);
+
+/**
+ * Add an unsigned integer to the current row.
+ *
+ * @param[in] batch the batch to add the value to.
+ * @param[in] value the value to add.
+ * @return see drizzle_query_batch_add_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_add_uint64(drizzle_query_batch_st *batch,
+                                                uint64_t value);
+
+/**
+ * End the current value tuple. If the row does not fit into the pending
+ * query, the rows before it are sent first and the row starts the next
+ * query.
+ *
+ * @param[in] batch the batch the row was added to.
+ * @return the return code of the query if one was sent, otherwise
+ *         DRIZZLE_RETURN_OK. The rows of a failed query are discarded, the
+ *         row just ended is kept.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_row_end(drizzle_query_batch_st *batch);
+
+/**
+ * Send the pending rows, if any.
+ *
+ * @param[in] batch the batch to flush.
+ * @return the return code of the query. The pending rows are discarded even
+ *         if the query fails.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_batch_flush(drizzle_query_batch_st *batch);
+
+/**
+ * Get the number of complete rows which have not been sent yet.
+ *
+ * @param[in] batch a batch object.
+ * @return the number of pending rows.
+ */
+DRIZZLE_API
+uint32_t drizzle_query_batch_row_count(const drizzle_query_batch_st *batch);
+
+/**
+ * Get the sum of the affected rows of all queries sent by the batch.
+ *
+ * @param[in] batch a batch object.
+ * @return the number of affected rows.
+ */
+DRIZZLE_API
+uint64_t drizzle_query_batch_affected_rows(const drizzle_query_batch_st *batch);
+
+/**
+ * Free a batch. Pending rows are not sent, call drizzle_query_batch_flush()
+ * first.
+ *
+ * @param[in] batch the batch to free.
+ */
+DRIZZLE_API
+void drizzle_query_batch_free(drizzle_query_batch_st *batch);
+
+/**
+ * Create a client side template for a query with ? placeholders, an
+ * alternative to server side prepared statements for queries which run only
+ * a few times. The placeholders are found once, outside of quoted strings,
+ * identifiers and comments. Parameter values are turned into escaped SQL
+ * literals when they are set and interpolated into a buffer which is sent
+ * with drizzle_query(), so executing costs no extra round trip and no server
+ * side statement.
+ *
+ * @param[in] con connection to send the queries on.
+ * @param[in] query the query text.
+ * @param[in] size length of the query, if 0 strlen() is used.
+ * @param[out] ret_ptr pointer to the result code.
+ * @return a newly allocated template, or NULL on error.
+ */
+DRIZZLE_API
+drizzle_query_template_st *drizzle_query_template_create(drizzle_st *con,
+                                                         const char *query,
+                                                         size_t size,
+                                                         drizzle_return_t *ret_ptr);
+
+/**
+ * Get the number of ? placeholders of a template.
+ *
+ * @param[in] query_template a template object.
+ * @return the number of parameters.
+ */
+DRIZZLE_API
+uint16_t drizzle_query_template_param_count(const drizzle_query_template_st *query_template);
+
+/**
+ * Set a parameter to a quoted string literal. The value is escaped for the
+ * connection charset, multi-byte characters of big5, sjis, cp932 and gbk
+ * are kept whole, and for the NO_BACKSLASH_ESCAPES SQL mode if the server
+ * reported it. A NULL value sets SQL NULL. Parameters keep their value
+ * between executions until they are set again.
+ *
+ * The connection charset is the one agreed on in the handshake, see
+ * drizzle_charset(). A charset set later with SET NAMES is not tracked and
+ * values are still escaped for the handshake charset.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the string value.
+ * @param[in] size the length of the value in bytes.
+ * @return DRIZZLE_RETURN_INVALID_ARGUMENT if there is no such parameter, or
+ *         another drizzle return code.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_string(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   const char *value,
+                                                   size_t size);
+
+/**
+ * Set a parameter to a hexadecimal literal of binary data, see
+ * drizzle_hex_string(). A NULL value sets SQL NULL.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the binary data.
+ * @param[in] size the length of the data in bytes.
+ * @return see drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_binary(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   const unsigned char *value,
+                                                   size_t size);
+
+/**
+ * Set a parameter to SQL text as is, without quoting or escaping. Use this
+ * for expressions only, never for untrusted input.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the SQL text.
+ * @param[in] size the length of the text in bytes.
+ * @return see drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_literal(drizzle_query_template_st *query_template,
+                                                    uint16_t param,
+                                                    const char *value,
+                                                    size_t size);
+
+/**
+ * Set a parameter to SQL NULL.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @return see drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_null(drizzle_query_template_st *query_template,
+                                                 uint16_t param);
+
+/**
+ * Set a parameter to a signed integer.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the value.
+ * @return see drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_int64(drizzle_query_template_st *query_template,
+                                                  uint16_t param,
+                                                  int64_t value);
+
+/**
+ * Set a parameter to an unsigned integer.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the value.
+ * @return see drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_uint64(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   uint64_t value);
+
+/**
+ * Set a parameter to a floating point number, written with the fewest
+ * digits which read back as the same value.
+ *
+ * @param[in] query_template the template to modify.
+ * @param[in] param the parameter number, starting at 0.
+ * @param[in] value the value.
+ * @return DRIZZLE_RETURN_INVALID_ARGUMENT for infinities and NaN, which
+ *         have no SQL literal, otherwise see
+ *         drizzle_query_template_set_string().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_query_template_set_double(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   double value);
+
+/**
+ * Build the query text with the current parameter values without sending
+ * it.
+ *
+ * @param[in] query_template the template to build.
+ * @param[out] size the length of the query, may be NULL.
+ * @param[out] ret_ptr pointer to the result code,
+ *             DRIZZLE_RETURN_INVALID_ARGUMENT if a parameter is not set.
+ * @return the NUL terminated query, valid until the template is built or
+ *         freed, or NULL on error.
+ */
+DRIZZLE_API
+const char *drizzle_query_template_build(drizzle_query_template_st *query_template,
+                                         size_t *size,
+                                         drizzle_return_t *ret_ptr);
+
+/**
+ * Send the query with the current parameter values, the same as
+ * drizzle_query() would. A query which fits into the connection buffer is
+ * built straight into it. On IO_WAIT call again to continue sending the
+ * same query.
+ *
+ * @param[in] query_template the template to execute.
+ * @param[out] ret_ptr pointer to the result code.
+ * @return the result of the query, see drizzle_query().
+ */
+DRIZZLE_API
+drizzle_result_st *drizzle_query_template_execute(drizzle_query_template_st *query_template,
+                                                  drizzle_return_t *ret_ptr);
+
+/**
+ * Free a template.
+ *
+ * @param[in] query_template the template to free.
+ */
+DRIZZLE_API
+void drizzle_query_template_free(drizzle_query_template_st *query_template);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -75,6 +75,158 @@ drizzle_result_st *drizzle_result_read(drizzle_st *con,
 DRIZZLE_API
 drizzle_return_t drizzle_result_buffer(drizzle_result_st *result);
 
+/**
+ * Buffers a result set as drizzle_result_buffer() does, but keeps at most
+ * memory_limit bytes of rows on the heap. Further rows and their index are
+ * appended to an unlinked temporary file in TMPDIR, or /tmp, which is mapped
+ * into memory as a whole so that drizzle_row_next(), drizzle_row_prev() and
+ * drizzle_row_index() work as usual while the kernel pages the rows in and
+ * out. A row read from the file, and its field sizes, stay valid until the
+ * next of these calls. The file is removed when the result is freed. The
+ * disk space is reserved as the file grows, with posix_fallocate() or, where
+ * it is missing as on macOS, with fcntl(F_PREALLOCATE) or by writing zeros.
+ * The limit is ignored on Windows.
+ *
+ * @param[in,out] result A result object
+ * @param[in] memory_limit Bytes of rows to keep on the heap, 0 to map all
+ *            rows from the file
+ * @return DRIZZLE_RETURN_OK upon success, DRIZZLE_RETURN_ERRNO if the file
+ *         cannot be created or extended, else DRIZZLE_RETURN_MEMORY
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_result_buffer_spill(drizzle_result_st *result,
+                                             size_t memory_limit);
+
+/**
+ * Gets the size of the temporary file of a result buffered with
+ * drizzle_result_buffer_spill()
+ *
+ * @param[in] result A result object
+ * @return The bytes of rows and row index in the file, 0 if every row is
+ *         on the heap
+ */
+DRIZZLE_API
+uint64_t drizzle_result_spill_size(drizzle_result_st *result);
+
+/**
+ * Reads the rows of a result set without buffering them and calls visit_fn
+ * once for every row. The fields passed are views as returned by
+ * drizzle_row_view(), valid only during the call. If visit_fn returns
+ * anything but DRIZZLE_RETURN_OK the visit stops, the remaining rows are
+ * left unread and can be read by calling this function again.
+ *
+ * @param[in,out] result A result object
+ * @param[in] visit_fn The function to call for every row
+ * @param[in] context Application context pointer passed to visit_fn
+ * @return DRIZZLE_RETURN_OK once all rows are visited, the return value of
+ *         visit_fn if it stopped the visit, else the error reading a row
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_result_visit(drizzle_result_st *result,
+                                      drizzle_row_visit_fn *visit_fn,
+                                      void *context);
+
+/**
+ * Buffers a text result set column by column instead of row by row. Integer
+ * columns are decoded into int64_t vectors, or uint64_t for unsigned
+ * BIGINT, FLOAT and DOUBLE columns into double vectors and all other
+ * columns into string vectors of offsets and data. The rows are not
+ * available through drizzle_row_next() afterwards.
+ * @param[in,out] result A result object
+ * @return DRIZZLE_RETURN_OK upon success, DRIZZLE_RETURN_INVALID_ARGUMENT
+ *         for binary rows or rows already buffered, else
+ *         DRIZZLE_RETURN_MEMORY
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_result_buffer_columnar(drizzle_result_st *result);
+
+/**
+ * Gets the value type of a column buffered with
+ * drizzle_result_buffer_columnar()
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The vector type, DRIZZLE_VECTOR_NONE if there is no such vector
+ */
+DRIZZLE_API
+drizzle_vector_type_t drizzle_result_vector_type(drizzle_result_st *result,
+                                                 uint16_t column);
+
+/**
+ * Gets the values of a DRIZZLE_VECTOR_INT64 column, one for every row and 0
+ * for NULL
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The values, NULL if the column has another type
+ */
+DRIZZLE_API
+const int64_t *drizzle_result_vector_int64(drizzle_result_st *result,
+                                           uint16_t column);
+
+/**
+ * Gets the values of a DRIZZLE_VECTOR_UINT64 column, one for every row and 0
+ * for NULL
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The values, NULL if the column has another type
+ */
+DRIZZLE_API
+const uint64_t *drizzle_result_vector_uint64(drizzle_result_st *result,
+                                             uint16_t column);
+
+/**
+ * Gets the values of a DRIZZLE_VECTOR_DOUBLE column, one for every row and 0
+ * for NULL
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The values, NULL if the column has another type
+ */
+DRIZZLE_API
+const double *drizzle_result_vector_double(drizzle_result_st *result,
+                                           uint16_t column);
+
+/**
+ * Gets the offsets of a DRIZZLE_VECTOR_STRING column: row n is the data from
+ * offsets[n] up to offsets[n + 1], which is empty for NULL
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return Row count + 1 offsets, NULL if the column has another type
+ */
+DRIZZLE_API
+const int64_t *drizzle_result_vector_offsets(drizzle_result_st *result,
+                                             uint16_t column);
+
+/**
+ * Gets the string data of a DRIZZLE_VECTOR_STRING column, which is not
+ * terminated
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The data, NULL if the column has another type or no data
+ */
+DRIZZLE_API
+const char *drizzle_result_vector_data(drizzle_result_st *result,
+                                       uint16_t column);
+
+/**
+ * Gets the validity bitmap of a column: bit n % 8 of byte n / 8 is set when
+ * row n is not NULL
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The bitmap, NULL if there is no such vector
+ */
+DRIZZLE_API
+const uint8_t *drizzle_result_vector_validity(drizzle_result_st *result,
+                                              uint16_t column);
+
+/**
+ * Gets the number of NULL values of a column
+ * @param[in] result A result object
+ * @param[in] column The column number
+ * @return The NULL count
+ */
+DRIZZLE_API
+uint64_t drizzle_result_vector_null_count(drizzle_result_st *result,
+                                          uint16_t column);
+
 /**
  * Get result row packet size in bytes.
  *
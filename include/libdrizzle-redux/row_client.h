@@ -82,6 +82,48 @@ DRIZZLE_API
 drizzle_row_t drizzle_row_buffer(drizzle_result_st *result,
                                  drizzle_return_t *ret_ptr);
 
+/**
+ * A field of a row read with drizzle_row_view()
+ */
+struct drizzle_field_view_st
+{
+  const char *data; /**< The field value, not terminated, NULL for NULL */
+  size_t size;      /**< The size of the value */
+};
+
+/**
+ * Read one row without copying its fields. The views point into the read
+ * buffer of the connection and are valid until the next row is read or the
+ * connection is used otherwise. Only rows larger than a protocol packet are
+ * copied into the field buffers of the result.
+ *
+ * @param[in,out] result pointer to the result structure to read from.
+ * @param[out] ret_ptr Standard drizzle return value.
+ * @return drizzle_result_column_count() views, or NULL if there are no more
+ *         rows.
+ */
+DRIZZLE_API
+const drizzle_field_view_st *drizzle_row_view(drizzle_result_st *result,
+                                              drizzle_return_t *ret_ptr);
+
+/**
+ * Read up to max rows without copying their fields. Text rows whose packets
+ * are in the read buffer of the connection already are parsed in one pass,
+ * only the first row of a batch may wait for data from the server. The
+ * views are valid until the next row is read, as with drizzle_row_view().
+ *
+ * @param[in,out] result pointer to the result structure to read from.
+ * @param[out] rows Array of max pointers to store the field views of every
+ *             row into.
+ * @param[in] max The maximum number of rows to read.
+ * @param[out] ret_ptr Standard drizzle return value.
+ * @return The number of rows read, 0 if there are no more rows.
+ */
+DRIZZLE_API
+size_t drizzle_row_read_batch(drizzle_result_st *result,
+                              const drizzle_field_view_st **rows, size_t max,
+                              drizzle_return_t *ret_ptr);
+
 /**
  * Free a row that was buffered with drizzle_row_buffer().
  *
@@ -146,6 +188,98 @@ drizzle_row_t drizzle_row_index(drizzle_result_st *result, uint64_t row);
 DRIZZLE_API
 uint64_t drizzle_row_current(drizzle_result_st *result);
 
+/**
+ * Gets a field of the current text row as a signed integer. The current row
+ * is the one last returned by drizzle_row_buffer(), drizzle_row_next() or
+ * drizzle_row_prev(). Integer, DECIMAL and floating point columns can be
+ * read, a dropped fraction or a value out of range returns
+ * DRIZZLE_RETURN_TRUNCATED.
+ *
+ * @param[in] result A result object with buffered columns
+ * @param[in] column The column number of the field
+ * @param[out] ret_ptr A pointer to a drizzle_return_t to store the return
+ *             status into, DRIZZLE_RETURN_NULL_SIZE for a NULL field
+ * @return The value of the field
+ */
+DRIZZLE_API
+int64_t drizzle_row_get_int64(drizzle_result_st *result, uint16_t column,
+                              drizzle_return_t *ret_ptr);
+
+/**
+ * Gets a field of the current text row as an unsigned integer, as
+ * drizzle_row_get_int64(). Negative values return 0 and
+ * DRIZZLE_RETURN_TRUNCATED.
+ *
+ * @param[in] result A result object with buffered columns
+ * @param[in] column The column number of the field
+ * @param[out] ret_ptr A pointer to a drizzle_return_t to store the return
+ *             status into
+ * @return The value of the field
+ */
+DRIZZLE_API
+uint64_t drizzle_row_get_uint64(drizzle_result_st *result, uint16_t column,
+                                drizzle_return_t *ret_ptr);
+
+/**
+ * Gets a field of an integer, DECIMAL or floating point column of the
+ * current text row as a double.
+ *
+ * @param[in] result A result object with buffered columns
+ * @param[in] column The column number of the field
+ * @param[out] ret_ptr A pointer to a drizzle_return_t to store the return
+ *             status into
+ * @return The value of the field
+ */
+DRIZZLE_API
+double drizzle_row_get_double(drizzle_result_st *result, uint16_t column,
+                              drizzle_return_t *ret_ptr);
+
+/**
+ * Gets a field of a DATE, DATETIME, TIMESTAMP or TIME column of the current
+ * text row. Hours of a TIME beyond a day are stored as days, as the binary
+ * protocol sends them.
+ *
+ * @param[in] result A result object with buffered columns
+ * @param[in] column The column number of the field
+ * @param[out] datetime The structure to store the value into
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_row_get_datetime(drizzle_result_st *result,
+                                          uint16_t column,
+                                          drizzle_datetime_st *datetime);
+
+/**
+ * An exact decimal number read by drizzle_row_get_decimal_as_int128(). The
+ * value is the 128 bit unsigned magnitude high * 2^64 + low, negated if
+ * negative, divided by 10 to the power of scale.
+ */
+struct drizzle_decimal_st
+{
+  uint64_t high;  /**< The upper 64 bits of the unscaled magnitude */
+  uint64_t low;   /**< The lower 64 bits of the unscaled magnitude */
+  bool negative;  /**< Whether the value is below zero */
+  uint8_t scale;  /**< The number of fraction digits */
+};
+
+/**
+ * Gets a field of a DECIMAL or integer column of the current text row as an
+ * unscaled 128 bit integer, which holds every DECIMAL of up to 38 digits
+ * exactly. Fraction digits beyond 128 bits are dropped and return
+ * DRIZZLE_RETURN_TRUNCATED, an integer part beyond 128 bits returns
+ * DRIZZLE_RETURN_INVALID_CONVERSION.
+ *
+ * @param[in] result A result object with buffered columns
+ * @param[in] column The column number of the field
+ * @param[out] decimal The structure to store the value into
+ * @return A return status code, DRIZZLE_RETURN_OK upon success,
+ *         DRIZZLE_RETURN_NULL_SIZE for a NULL field
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_row_get_decimal_as_int128(drizzle_result_st *result,
+                                                   uint16_t column,
+                                                   drizzle_decimal_st *decimal);
+
 /** @} */
 
 #ifdef __cplusplus
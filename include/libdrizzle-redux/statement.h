@@ -42,9 +42,41 @@
 extern "C" {
 #endif
 
+/* Defined in <sys/uio.h> */
+struct iovec;
+
+/**
+ * A TIME, DATE, DATETIME or TIMESTAMP value, as stored by
+ * drizzle_stmt_bind_result()
+ */
+struct drizzle_datetime_st
+{
+  uint16_t year;
+  uint8_t month;
+  uint32_t day;
+  uint16_t hour;
+  uint8_t minute;
+  uint8_t second;
+  uint32_t microsecond;
+  bool negative;
+  bool show_microseconds;
+};
+
 /**
  * Prepare a new statement
  *
+ * On a non-blocking connection the statement functions return
+ * DRIZZLE_RETURN_IO_WAIT instead of waiting for the server. Once
+ * drizzle_wait() returns, or drizzle_fd() is ready in an external event
+ * loop, call the same function again with the same arguments to continue
+ * where it stopped. Buffers passed to
+ * the function must stay valid until it stops returning
+ * DRIZZLE_RETURN_IO_WAIT. No other command can be sent on the connection
+ * meanwhile.
+ *
+ * Until a statement is prepared it is only known to the connection, so this
+ * function returns NULL while returning DRIZZLE_RETURN_IO_WAIT.
+ *
  * @param con A connection object
  * @param statement The prepared statement with question marks ('?') for the
  *  elements to be provided as parameters
@@ -65,6 +97,149 @@ drizzle_stmt_st *drizzle_stmt_prepare(drizzle_st *con, const char *statement,
 DRIZZLE_API
 drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt);
 
+/**
+ * Executes a prepared statement with parameters the caller has encoded in
+ * the binary protocol already, bypassing the parameters bound with the
+ * drizzle_stmt_set_* functions. This is what the typed C++ interface in
+ * libdrizzle-redux/statement.hpp uses.
+ *
+ * params holds the COM_STMT_EXECUTE payload after the iteration count: the
+ * NULL bitmap, a new parameters bound flag of 1, two type bytes per
+ * parameter and the parameter values. On IO_WAIT call again with the same
+ * parameters.
+ *
+ * @param stmt The prepared statement object
+ * @param param_count The number of parameters encoded, which must be the
+ *   parameter count of the statement
+ * @param params The encoded parameters
+ * @param size The size of params in bytes
+ * @return A return status code, DRIZZLE_RETURN_OK upon success,
+ *   DRIZZLE_RETURN_STMT_ERROR if long data was sent for a parameter
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_execute_packed(drizzle_stmt_st *stmt,
+                                             uint16_t param_count,
+                                             const unsigned char *params,
+                                             size_t size);
+
+/**
+ * Executes a prepared statement once for each of row_count parameter rows.
+ * Parameters bound with drizzle_stmt_set_param_array() take the value of the
+ * row, all other parameters are the same for every row. The executions are
+ * pipelined: up to DRIZZLE_STMT_BULK_WINDOW of them are sent with as few
+ * writes as possible before their replies are read. If the server supports
+ * MariaDB bulk operations, see drizzle_options_set_bulk_operations(), the
+ * rows are sent with COM_STMT_BULK_EXECUTE instead, as many as fit into the
+ * connection buffer per command, unless a parameter is sent as long data.
+ * Only statements without a result set, such as INSERT, UPDATE and DELETE,
+ * can be executed this way.
+ *
+ * On success drizzle_stmt_affected_rows() returns the sum over all rows and
+ * drizzle_stmt_insert_id() the first generated ID. A failed
+ * COM_STMT_BULK_EXECUTE does not tell which of its rows failed,
+ * drizzle_stmt_bulk_error_row() returns its first row.
+ *
+ * @param stmt The prepared statement object
+ * @param row_count The number of rows to execute
+ * @return A return status code, DRIZZLE_RETURN_OK upon success. If a row
+ *  fails DRIZZLE_RETURN_ERROR_CODE is returned once the replies of the rows
+ *  already sent have been read, and no further rows are sent. See
+ *  drizzle_stmt_bulk_error_row().
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_execute_bulk(drizzle_stmt_st *stmt,
+                                           uint32_t row_count);
+
+/**
+ * Gets the index of the first row that failed in the last call to
+ * drizzle_stmt_execute_bulk()
+ *
+ * @param stmt The prepared statement object
+ * @return The row index
+ */
+DRIZZLE_API
+uint32_t drizzle_stmt_bulk_error_row(drizzle_stmt_st *stmt);
+
+/**
+ * Queues an execution of a prepared statement with its current parameters.
+ * The parameters are copied, so they can be changed for the next execution
+ * right away. Executions of any statements of the connection can be queued.
+ *
+ * Queued executions are sent together by drizzle_stmt_queue_flush(), or by
+ * drizzle_stmt_queue_read() when no earlier ones wait for their reply, and
+ * their replies are read in order with drizzle_stmt_queue_read(). Until all
+ * replies are read, no other statement command can be sent on the
+ * connection. Executions with long data cannot be queued.
+ *
+ * @param stmt The prepared statement object
+ * @return A return status code, DRIZZLE_RETURN_OK upon success.
+ *  DRIZZLE_RETURN_NOT_READY if the queue limit is reached, see
+ *  drizzle_set_stmt_queue_limit(); read replies first.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_queue(drizzle_stmt_st *stmt);
+
+/**
+ * Sends the queued executions with as few writes as possible. Replies to
+ * executions sent earlier do not have to be read first, so new executions
+ * can be sent while the server works on the earlier ones.
+ *
+ * @param con A connection object
+ * @return A return status code, DRIZZLE_RETURN_OK upon success.
+ *  DRIZZLE_RETURN_NOT_READY while a reply is partly read after
+ *  drizzle_stmt_queue_read() returned DRIZZLE_RETURN_IO_WAIT.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_queue_flush(drizzle_st *con);
+
+/**
+ * Reads the reply to the oldest queued execution, sending the queued
+ * executions first if needed. The returned statement is in the state
+ * drizzle_stmt_execute() leaves it in, so its rows can be fetched or
+ * buffered. Rows that are not read are skipped by the next call.
+ *
+ * @param con A connection object
+ * @param ret_ptr A pointer to a drizzle_return_t to store the return status
+ *  of the execution into
+ * @return The statement the reply belongs to, or NULL if no executions are
+ *  queued or on a connection error
+ */
+DRIZZLE_API
+drizzle_stmt_st *drizzle_stmt_queue_read(drizzle_st *con,
+                                         drizzle_return_t *ret_ptr);
+
+/**
+ * Gets the number of queued executions whose reply has not been read
+ *
+ * @param con A connection object
+ * @return The number of queued executions
+ */
+DRIZZLE_API
+uint32_t drizzle_stmt_queue_count(const drizzle_st *con);
+
+/**
+ * Sets how many queued executions can wait for their reply at once,
+ * DRIZZLE_STMT_QUEUE_LIMIT by default. The replies of sent executions pile up
+ * in the socket buffers until they are read, so statements returning large
+ * result sets need a lower limit.
+ *
+ * @param con A connection object
+ * @param limit The maximum number of queued executions
+ * @return A return status code, DRIZZLE_RETURN_OK upon success.
+ *  DRIZZLE_RETURN_NOT_READY while executions are queued.
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_set_stmt_queue_limit(drizzle_st *con, uint32_t limit);
+
+/**
+ * Gets the maximum number of queued executions
+ *
+ * @param con A connection object
+ * @return The queue limit
+ */
+DRIZZLE_API
+uint32_t drizzle_stmt_queue_limit(const drizzle_st *con);
+
 /**
  * Send long binary data packet
  *
@@ -80,6 +255,38 @@ drizzle_return_t drizzle_stmt_send_long_data(drizzle_stmt_st *stmt,
                                              unsigned char *data,
                                              size_t len);
 
+/**
+ * Send long data for a parameter from a list of buffers. The data is sent
+ * in packets of up to DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE bytes, written
+ * together with their headers without being copied.
+ *
+ * @param stmt The prepared statement object
+ * @param param_num The parameter number this data is for
+ * @param iov The buffers holding the data
+ * @param iovcnt The number of buffers
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_send_long_data_iov(drizzle_stmt_st *stmt,
+                                                 uint16_t param_num,
+                                                 const struct iovec *iov,
+                                                 int iovcnt);
+
+/**
+ * Send long data for a parameter read from a file descriptor until end of
+ * file. The data is read and sent in packets of up to
+ * DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE bytes, so it is never held in memory
+ * as a whole. The descriptor is not closed.
+ *
+ * @param stmt The prepared statement object
+ * @param param_num The parameter number this data is for
+ * @param fd The file descriptor to read the data from
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_send_long_data_fd(drizzle_stmt_st *stmt,
+                                                uint16_t param_num, int fd);
+
 /** Reset a statement to the prepared state
  *
  * @param stmt The prepared statement object
@@ -97,6 +304,52 @@ drizzle_return_t drizzle_stmt_reset(drizzle_stmt_st *stmt);
 DRIZZLE_API
 drizzle_return_t drizzle_stmt_fetch(drizzle_stmt_st *stmt);
 
+/**
+ * Binds a column of the result set to a buffer of the caller. Once a
+ * column is bound drizzle_stmt_fetch() decodes the columns of each row
+ * straight into their buffers, without copying the row first, and the
+ * drizzle_stmt_get functions are not available. Columns which are not bound
+ * are skipped.
+ *
+ * The buffer holds a uint8_t, uint16_t, uint32_t or uint64_t for the
+ * integer types, a float or double for the floating point types and a
+ * drizzle_datetime_st for DRIZZLE_COLUMN_TYPE_TIME, DRIZZLE_COLUMN_TYPE_DATE,
+ * DRIZZLE_COLUMN_TYPE_DATETIME and DRIZZLE_COLUMN_TYPE_TIMESTAMP. Integers
+ * are signed unless the column is unsigned. For the string and blob types
+ * up to buffer_size bytes are copied, followed by a NUL if there is room.
+ * Numbers and decimal or string columns are converted into each other.
+ *
+ * @param stmt A prepared statement object
+ * @param column_number The column number to bind (starting at 0)
+ * @param type The type of the value to store in buffer
+ * @param buffer The buffer for the value, which must stay valid until the
+ *  columns are unbound or the statement is closed
+ * @param buffer_size The size of buffer for the string and blob types
+ * @param length Set to the length of the value, which is larger than
+ *  buffer_size if the value was truncated. Can be NULL
+ * @param is_null Set to whether the value is NULL. Can be NULL
+ * @return A return status code, DRIZZLE_RETURN_OK upon success.
+ *  drizzle_stmt_fetch() returns DRIZZLE_RETURN_TRUNCATED if a value did not
+ *  fit into its buffer and DRIZZLE_RETURN_INVALID_CONVERSION if it could
+ *  not be converted
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_bind_result(drizzle_stmt_st *stmt,
+                                          uint16_t column_number,
+                                          drizzle_column_type_t type,
+                                          void *buffer, size_t buffer_size,
+                                          size_t *length, bool *is_null);
+
+/**
+ * Removes the buffers bound with drizzle_stmt_bind_result(), so rows are
+ * read with the drizzle_stmt_get functions again
+ *
+ * @param stmt A prepared statement object
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_unbind_result(drizzle_stmt_st *stmt);
+
 /**
  * Buffer the entire result set
  *
@@ -109,12 +362,93 @@ drizzle_return_t drizzle_stmt_buffer(drizzle_stmt_st *stmt);
 /**
  * Close and free a prepared statement
  *
+ * The server does not reply to closing a statement. On a non-blocking
+ * connection the close is sent along with the next command instead, so
+ * this function never returns DRIZZLE_RETURN_IO_WAIT. A statement from
+ * drizzle_stmt_prepare_cached() is released back to the cache instead.
+ *
  * @param stmt The prepared statement object
  * @return A return status code, DRIZZLE_RETURN_OK upon success
  */
 DRIZZLE_API
 drizzle_return_t drizzle_stmt_close(drizzle_stmt_st *stmt);
 
+/**
+ * Sets the number of prepared statements kept in the statement cache of a
+ * connection. The cache is disabled by default (size 0). When the size is
+ * reduced the least recently used statements not in use are evicted.
+ *
+ * @param con A connection object
+ * @param size The maximum number of cached statements, 0 to disable
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_set_stmt_cache_size(drizzle_st *con, uint32_t size);
+
+/**
+ * Gets the maximum number of statements in the statement cache
+ *
+ * @param con A connection object
+ * @return The statement cache size
+ */
+DRIZZLE_API
+uint32_t drizzle_stmt_cache_size(const drizzle_st *con);
+
+/**
+ * Gets the number of statements currently in the statement cache
+ *
+ * @param con A connection object
+ * @return The number of cached statements
+ */
+DRIZZLE_API
+uint32_t drizzle_stmt_cache_count(const drizzle_st *con);
+
+/**
+ * Prepares a statement through the statement cache. If the same statement
+ * text was prepared before on this connection the cached statement is
+ * returned without a round trip to the server, otherwise it is prepared and
+ * added to the cache, evicting the least recently used statement when the
+ * cache is full.
+ *
+ * Each returned statement must be released with drizzle_stmt_close(), which
+ * keeps it prepared in the cache. Statements are only evicted while no caller
+ * holds them, so the cache can exceed its size until they are released.
+ * Evicted statements are closed on the server along with the next command
+ * sent on the connection. Cached statements are freed with the connection.
+ * With a cache size of 0 this is the same as drizzle_stmt_prepare().
+ *
+ * @param con A connection object
+ * @param statement The statement text
+ * @param size The length of the statement
+ * @param ret_ptr A pointer to a drizzle_return_t to store the return status into
+ * @return The prepared statement object (or NULL on error)
+ */
+DRIZZLE_API
+drizzle_stmt_st *drizzle_stmt_prepare_cached(drizzle_st *con,
+                                             const char *statement,
+                                             size_t size,
+                                             drizzle_return_t *ret_ptr);
+
+/**
+ * Gets the number of drizzle_stmt_prepare_cached() calls answered from the
+ * statement cache
+ *
+ * @param con A connection object
+ * @return The number of cache hits
+ */
+DRIZZLE_API
+uint64_t drizzle_stmt_cache_hits(const drizzle_st *con);
+
+/**
+ * Gets the number of drizzle_stmt_prepare_cached() calls which had to
+ * prepare the statement on the server
+ *
+ * @param con A connection object
+ * @return The number of cache misses
+ */
+DRIZZLE_API
+uint64_t drizzle_stmt_cache_misses(const drizzle_st *con);
+
 /**
  * Gets the column count for a result set which has been executed using drizzle_stmt_execute
  *
@@ -124,6 +458,23 @@ drizzle_return_t drizzle_stmt_close(drizzle_stmt_st *stmt);
 DRIZZLE_API
 uint16_t drizzle_stmt_column_count(drizzle_stmt_st *stmt);
 
+/**
+ * Resolves a column name of a prepared statement to its column number. The
+ * number stays valid for every execution of the statement, so it can be
+ * looked up once and passed to the drizzle_stmt_get_* functions instead of
+ * calling the *_from_name variants for every row.
+ *
+ * @param stmt The prepared statement object
+ * @param column_name The column name to look up
+ * @param ret_ptr A pointer to a drizzle_return_t to store the return status into,
+ *   DRIZZLE_RETURN_NOT_FOUND if the column name cannot be found
+ * @return The column number
+ */
+DRIZZLE_API
+uint16_t drizzle_stmt_column_lookup(drizzle_stmt_st *stmt,
+                                    const char *column_name,
+                                    drizzle_return_t *ret_ptr);
+
 /**
  * Gets the affected rows count for a result set which has been executed using
  * drizzle_stmt_execute
@@ -162,6 +513,35 @@ uint16_t drizzle_stmt_param_count(drizzle_stmt_st *stmt);
 DRIZZLE_API
 uint64_t drizzle_stmt_row_count(drizzle_stmt_st *stmt);
 
+/**
+ * Binds a parameter of a prepared statement to a column of values for
+ * drizzle_stmt_execute_bulk(). The arrays are not copied and must stay valid
+ * until the statement is executed. drizzle_stmt_execute() uses the first row.
+ *
+ * The element type of values depends on type: uint8_t, uint16_t, uint32_t,
+ * uint64_t, float or double for the numeric types and const char * for the
+ * string, blob and decimal types. Temporal values can be sent as strings.
+ * values is ignored for DRIZZLE_COLUMN_TYPE_NULL.
+ *
+ * @param stmt A prepared statement object
+ * @param param_num The parameter number to set (starting at 0)
+ * @param type The column type of the values
+ * @param values The array of values
+ * @param lengths The lengths of string values, or NULL to use strlen()
+ * @param nulls Set to true for rows where the parameter is NULL, or NULL if
+ *  no row is. A NULL string pointer is also sent as NULL
+ * @param is_unsigned Set to true if the parameter is unsigned
+ * @return A return status code, DRIZZLE_RETURN_OK upon success
+ */
+DRIZZLE_API
+drizzle_return_t drizzle_stmt_set_param_array(drizzle_stmt_st *stmt,
+                                              uint16_t param_num,
+                                              drizzle_column_type_t type,
+                                              const void *values,
+                                              const size_t *lengths,
+                                              const bool *nulls,
+                                              bool is_unsigned);
+
 /**
  *Sets a parameter of a prepared statement to a tinyint value
  *
@@ -372,6 +752,9 @@ const char *drizzle_stmt_get_string_from_name(drizzle_stmt_st *stmt,
  * Get the string value for a column of a fetched row (int types are
  * automatically converted)
  *
+ * Floating point values are converted to the shortest string which reads
+ * back as the same value. The string stays valid until the next fetch.
+ *
  * @param stmt The prepared statement object
  * @param column_number The column number to get (starting at 0)
  * @param len: A pointer to a size_t to store the result length into
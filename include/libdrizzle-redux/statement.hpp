@@ -0,0 +1,434 @@
+/* vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ * Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+/**
+ * @file
+ * Typed prepared statement parameters for C++
+ *
+ * drizzle::statement deduces the binary protocol type of every parameter
+ * from its C++ type at compile time and encodes the parameters straight
+ * into the execute packet, without drizzle_bind_st copies or a switch on
+ * the type at runtime:
+ *
+ * @code
+ * drizzle::statement insert(drizzle_stmt_prepare(con, query, size, &ret));
+ * ret= insert.execute(id, name, timestamp);
+ * @endcode
+ *
+ * Supported are the integer types, bool, float, double, const char * and
+ * std::string, drizzle::blob, drizzle_datetime_st (sent as a TIMESTAMP),
+ * drizzle::time_value (sent as a TIME) and nullptr for NULL. A NULL
+ * const char * is sent as NULL too. Other types fail to compile.
+ */
+
+#include <libdrizzle-redux/libdrizzle.h>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace drizzle {
+
+/** Binary data for a BLOB parameter */
+struct blob
+{
+  const void *data;
+  size_t size;
+};
+
+/** A TIME parameter, the day field holds whole days of the interval */
+struct time_value
+{
+  drizzle_datetime_st value;
+};
+
+namespace detail {
+
+/* Unsupported parameter types end up here */
+template <typename T, typename Enable= void>
+struct param
+{
+  static_assert(sizeof(T) == 0,
+                "this type cannot be a prepared statement parameter");
+};
+
+template <size_t N>
+inline unsigned char *store(unsigned char *ptr, uint64_t value)
+{
+  for (size_t x= 0; x < N; x++)
+  {
+    ptr[x]= (unsigned char)(value >> (8 * x));
+  }
+  return ptr + N;
+}
+
+inline size_t length_size(size_t length)
+{
+  return length < 251 ? 1 : length < 65536 ? 3 : length < 16777216 ? 4 : 9;
+}
+
+inline unsigned char *store_binary(unsigned char *ptr, const void *data,
+                                   size_t length)
+{
+  if (length < 251)
+  {
+    *ptr++= (unsigned char)length;
+  }
+  else if (length < 65536)
+  {
+    *ptr++= 252;
+    ptr= store<2>(ptr, length);
+  }
+  else if (length < 16777216)
+  {
+    *ptr++= 253;
+    ptr= store<3>(ptr, length);
+  }
+  else
+  {
+    *ptr++= 254;
+    ptr= store<8>(ptr, length);
+  }
+
+  if (length > 0)
+  {
+    memcpy(ptr, data, length);
+  }
+  return ptr + length;
+}
+
+template <typename T>
+struct param<T, typename std::enable_if<std::is_integral<T>::value &&
+                                        !std::is_same<T, bool>::value>::type>
+{
+  static const uint16_t type=
+    (sizeof(T) == 1 ? DRIZZLE_COLUMN_TYPE_TINY :
+     sizeof(T) == 2 ? DRIZZLE_COLUMN_TYPE_SHORT :
+     sizeof(T) == 4 ? DRIZZLE_COLUMN_TYPE_LONG : DRIZZLE_COLUMN_TYPE_LONGLONG)
+    | (std::is_unsigned<T>::value ? 0x8000 : 0);
+
+  static_assert(sizeof(T) <= 8, "integer parameters are at most 64 bits");
+
+  static bool is_null(T) { return false; }
+  static size_t size(T) { return sizeof(T); }
+  static unsigned char *pack(unsigned char *ptr, T value)
+  {
+    return store<sizeof(T)>(ptr, (uint64_t)(typename std::make_unsigned<T>::type)value);
+  }
+};
+
+template <>
+struct param<bool>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_TINY | 0x8000;
+
+  static bool is_null(bool) { return false; }
+  static size_t size(bool) { return 1; }
+  static unsigned char *pack(unsigned char *ptr, bool value)
+  {
+    *ptr= value ? 1 : 0;
+    return ptr + 1;
+  }
+};
+
+/* Floating point values are sent in host order, as the C interface does */
+template <>
+struct param<float>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_FLOAT;
+
+  static bool is_null(float) { return false; }
+  static size_t size(float) { return 4; }
+  static unsigned char *pack(unsigned char *ptr, float value)
+  {
+    memcpy(ptr, &value, 4);
+    return ptr + 4;
+  }
+};
+
+template <>
+struct param<double>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_DOUBLE;
+
+  static bool is_null(double) { return false; }
+  static size_t size(double) { return 8; }
+  static unsigned char *pack(unsigned char *ptr, double value)
+  {
+    memcpy(ptr, &value, 8);
+    return ptr + 8;
+  }
+};
+
+template <>
+struct param<std::nullptr_t>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_NULL;
+
+  static bool is_null(std::nullptr_t) { return true; }
+  static size_t size(std::nullptr_t) { return 0; }
+  static unsigned char *pack(unsigned char *ptr, std::nullptr_t) { return ptr; }
+};
+
+template <>
+struct param<const char *>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_STRING;
+
+  static bool is_null(const char *value) { return value == NULL; }
+  static size_t size(const char *value)
+  {
+    size_t length= strlen(value);
+    return length_size(length) + length;
+  }
+  static unsigned char *pack(unsigned char *ptr, const char *value)
+  {
+    return store_binary(ptr, value, strlen(value));
+  }
+};
+
+template <>
+struct param<char *> : param<const char *> { };
+
+/* String literals */
+template <size_t N>
+struct param<char[N]> : param<const char *> { };
+
+template <>
+struct param<std::string>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_STRING;
+
+  static bool is_null(const std::string &) { return false; }
+  static size_t size(const std::string &value)
+  {
+    return length_size(value.size()) + value.size();
+  }
+  static unsigned char *pack(unsigned char *ptr, const std::string &value)
+  {
+    return store_binary(ptr, value.data(), value.size());
+  }
+};
+
+template <>
+struct param<blob>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_BLOB;
+
+  static bool is_null(const blob &value) { return value.data == NULL; }
+  static size_t size(const blob &value)
+  {
+    return length_size(value.size) + value.size;
+  }
+  static unsigned char *pack(unsigned char *ptr, const blob &value)
+  {
+    return store_binary(ptr, value.data, value.size);
+  }
+};
+
+/* Trailing zero parts are left out, as the server does */
+template <>
+struct param<drizzle_datetime_st>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_TIMESTAMP;
+
+  static bool is_null(const drizzle_datetime_st &) { return false; }
+  static size_t size(const drizzle_datetime_st &) { return 12; }
+  static unsigned char *pack(unsigned char *ptr, const drizzle_datetime_st &value)
+  {
+    uint8_t length= 0;
+
+    if (value.microsecond)
+    {
+      store<4>(ptr + 8, value.microsecond);
+      length= 11;
+    }
+    if (length || value.hour || value.minute || value.second)
+    {
+      ptr[5]= (unsigned char)value.hour;
+      ptr[6]= value.minute;
+      ptr[7]= value.second;
+      if (!length)
+      {
+        length= 7;
+      }
+    }
+    if (length || value.year || value.month || value.day)
+    {
+      store<2>(ptr + 1, value.year);
+      ptr[3]= value.month;
+      ptr[4]= (unsigned char)value.day;
+      if (!length)
+      {
+        length= 4;
+      }
+    }
+
+    ptr[0]= length;
+    return ptr + 1 + length;
+  }
+};
+
+template <>
+struct param<time_value>
+{
+  static const uint16_t type= DRIZZLE_COLUMN_TYPE_TIME;
+
+  static bool is_null(const time_value &) { return false; }
+  static size_t size(const time_value &) { return 13; }
+  static unsigned char *pack(unsigned char *ptr, const time_value &interval)
+  {
+    const drizzle_datetime_st &value= interval.value;
+    uint8_t length= 0;
+
+    if (value.microsecond)
+    {
+      store<4>(ptr + 9, value.microsecond);
+      length= 12;
+    }
+    if (length || value.day || value.hour || value.minute || value.second)
+    {
+      ptr[1]= value.negative ? 1 : 0;
+      store<4>(ptr + 2, value.day);
+      ptr[6]= (unsigned char)value.hour;
+      ptr[7]= value.minute;
+      ptr[8]= value.second;
+      if (!length)
+      {
+        length= 8;
+      }
+    }
+
+    ptr[0]= length;
+    return ptr + 1 + length;
+  }
+};
+
+inline size_t values_size()
+{
+  return 0;
+}
+
+template <typename T, typename... Rest>
+inline size_t values_size(const T &value, const Rest &... rest)
+{
+  return (param<T>::is_null(value) ? 0 : param<T>::size(value))
+         + values_size(rest...);
+}
+
+inline unsigned char *pack(unsigned char *, unsigned char *,
+                           unsigned char *data, uint16_t)
+{
+  return data;
+}
+
+template <typename T, typename... Rest>
+inline unsigned char *pack(unsigned char *null_bitmap, unsigned char *types,
+                           unsigned char *data, uint16_t number,
+                           const T &value, const Rest &... rest)
+{
+  store<2>(types, param<T>::type);
+  if (param<T>::is_null(value))
+  {
+    null_bitmap[number / 8]|= (unsigned char)(1 << (number % 8));
+  }
+  else
+  {
+    data= param<T>::pack(data, value);
+  }
+
+  return pack(null_bitmap, types + 2, data, (uint16_t)(number + 1), rest...);
+}
+
+} /* namespace detail */
+
+/**
+ * A prepared statement executed with typed parameters. The statement is
+ * not owned, close it with drizzle_stmt_close() as usual; the results are
+ * read with the drizzle_stmt_* functions on get().
+ */
+class statement
+{
+public:
+  explicit statement(drizzle_stmt_st *handle) :
+    stmt(handle)
+  { }
+
+  drizzle_stmt_st *get() const
+  {
+    return stmt;
+  }
+
+  /**
+   * Executes the statement with the given parameters. Their number must
+   * be the parameter count of the statement. On IO_WAIT call again with
+   * the same parameters.
+   *
+   * @return A return status code, DRIZZLE_RETURN_OK upon success
+   */
+  template <typename... Args>
+  drizzle_return_t execute(const Args &... args)
+  {
+    static_assert(sizeof...(Args) <= 65535,
+                  "a statement has at most 65535 parameters");
+    const size_t null_bitmap_length= (sizeof...(Args) + 7) / 8;
+    const size_t header= null_bitmap_length + 1 + 2 * sizeof...(Args);
+
+    /* The buffer grows to the largest execution and is reused */
+    buffer.resize(header + detail::values_size(args...));
+    unsigned char *start= buffer.data();
+    memset(start, 0, null_bitmap_length);
+    start[null_bitmap_length]= 1;
+
+    unsigned char *end= detail::pack(start, start + null_bitmap_length + 1,
+                                     start + header, 0, args...);
+
+    return drizzle_stmt_execute_packed(stmt, (uint16_t)sizeof...(Args),
+                                       start, (size_t)(end - start));
+  }
+
+private:
+  drizzle_stmt_st *stmt;
+  std::vector<unsigned char> buffer;
+};
+
+} /* namespace drizzle */
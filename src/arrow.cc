@@ -0,0 +1,792 @@
+/* vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ * Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @file
+ * @brief Arrow C Data Interface export of result sets
+ */
+
+#include "config.h"
+#include "src/common.h"
+
+#include <errno.h>
+
+/* Arrow type a column is exported as */
+enum arrow_kind_t
+{
+  ARROW_KIND_INT64,
+  ARROW_KIND_UINT64,
+  ARROW_KIND_DOUBLE,
+  ARROW_KIND_DATE32,
+  ARROW_KIND_TIMESTAMP,
+  ARROW_KIND_DURATION,
+  ARROW_KIND_UTF8,
+  ARROW_KIND_BINARY
+};
+
+/* Arrow format strings, indexed by arrow_kind_t */
+static const char *_arrow_formats[]=
+{
+  "l", "L", "g", "tdD", "tsu:", "tDu", "U", "Z"
+};
+
+/* Values of one column of a record batch, owned by its child ArrowArray
+ * once exported. Temporal values are decoded here, the others the same way
+ * as drizzle_result_buffer_columnar() does. */
+struct arrow_column_st
+{
+  const void *buffers[3];
+  drizzle_result_vector_st vector;
+};
+
+/* Storage of the children of an exported record batch */
+struct arrow_batch_st
+{
+  const void *buffers[1];
+  struct ArrowArray **children;
+  struct ArrowArray *arrays;
+};
+
+/* Storage of the children of an exported schema */
+struct arrow_schema_st
+{
+  struct ArrowSchema **children;
+  struct ArrowSchema *schemas;
+};
+
+struct arrow_stream_st
+{
+  drizzle_result_st *result;
+  int64_t batch_rows;
+  arrow_kind_t *kinds;
+  arrow_column_st **columns; /* batch being read, NULL between batches */
+  int64_t length;            /* rows of the batch being read */
+  int64_t allocation;        /* rows the columns have room for */
+  bool done;
+  const char *error;
+};
+
+static arrow_kind_t _arrow_kind(const drizzle_column_st *column)
+{
+  switch ((int)column->type)
+  {
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+      return ARROW_KIND_DATE32;
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+      return ARROW_KIND_TIMESTAMP;
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+      return ARROW_KIND_DURATION;
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+      return ARROW_KIND_BINARY;
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+      if (column->charset == DRIZZLE_CHARSET_BINARY)
+      {
+        return ARROW_KIND_BINARY;
+      }
+      return ARROW_KIND_UTF8;
+    default:
+      break;
+  }
+
+  switch ((int)drizzle_column_vector_type(column))
+  {
+    case DRIZZLE_VECTOR_INT64:
+      return ARROW_KIND_INT64;
+    case DRIZZLE_VECTOR_UINT64:
+      return ARROW_KIND_UINT64;
+    case DRIZZLE_VECTOR_DOUBLE:
+      return ARROW_KIND_DOUBLE;
+    default:
+      return ARROW_KIND_UTF8;
+  }
+}
+
+/* The vector type of a column, DRIZZLE_VECTOR_NONE for the temporal kinds
+ * which are decoded by _arrow_temporal() */
+static drizzle_vector_type_t _arrow_vector_type(arrow_kind_t kind)
+{
+  switch (kind)
+  {
+    case ARROW_KIND_INT64:
+      return DRIZZLE_VECTOR_INT64;
+    case ARROW_KIND_UINT64:
+      return DRIZZLE_VECTOR_UINT64;
+    case ARROW_KIND_DOUBLE:
+      return DRIZZLE_VECTOR_DOUBLE;
+    case ARROW_KIND_UTF8:
+    case ARROW_KIND_BINARY:
+      return DRIZZLE_VECTOR_STRING;
+    case ARROW_KIND_DATE32:
+    case ARROW_KIND_TIMESTAMP:
+    case ARROW_KIND_DURATION:
+    default:
+      return DRIZZLE_VECTOR_NONE;
+  }
+}
+
+/*
+ * Text value parsing
+ */
+
+/* Read the decimal digits at *ptr, false if there are none */
+static bool _arrow_digits(const char **ptr, const char *end, int64_t *value)
+{
+  const char *start= *ptr;
+
+  *value= 0;
+  while (*ptr < end && **ptr >= '0' && **ptr <= '9' && *value < INT64_MAX / 10 - 9)
+  {
+    *value= *value * 10 + (**ptr - '0');
+    (*ptr)++;
+  }
+
+  return *ptr != start;
+}
+
+static bool _arrow_separator(const char **ptr, const char *end, char separator)
+{
+  if (*ptr == end || **ptr != separator)
+  {
+    return false;
+  }
+  (*ptr)++;
+
+  return true;
+}
+
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+static int64_t _arrow_days(int64_t year, int64_t month, int64_t day)
+{
+  int64_t era;
+  int64_t year_of_era;
+  int64_t day_of_year;
+
+  year-= month <= 2;
+  era= (year >= 0 ? year : year - 399) / 400;
+  year_of_era= year - era * 400;
+  day_of_year= (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+
+  return era * 146097 + year_of_era * 365 + year_of_era / 4 -
+         year_of_era / 100 + day_of_year - 719468;
+}
+
+/* Parse YYYY-MM-DD into days since the epoch, false for zero dates */
+static bool _arrow_date(const char **ptr, const char *end, int64_t *days)
+{
+  int64_t year, month, day;
+
+  if (!_arrow_digits(ptr, end, &year) || !_arrow_separator(ptr, end, '-') ||
+      !_arrow_digits(ptr, end, &month) || !_arrow_separator(ptr, end, '-') ||
+      !_arrow_digits(ptr, end, &day))
+  {
+    return false;
+  }
+
+  if (month < 1 || month > 12 || day < 1 || day > 31)
+  {
+    return false;
+  }
+  *days= _arrow_days(year, month, day);
+
+  return true;
+}
+
+/* Parse H+:MM:SS[.ffffff] into microseconds */
+static bool _arrow_time(const char **ptr, const char *end, int64_t *micros)
+{
+  int64_t hours, minutes, seconds;
+  int64_t fraction= 0;
+
+  if (!_arrow_digits(ptr, end, &hours) || !_arrow_separator(ptr, end, ':') ||
+      !_arrow_digits(ptr, end, &minutes) || !_arrow_separator(ptr, end, ':') ||
+      !_arrow_digits(ptr, end, &seconds))
+  {
+    return false;
+  }
+
+  if (_arrow_separator(ptr, end, '.'))
+  {
+    int digits= 0;
+
+    while (*ptr < end && **ptr >= '0' && **ptr <= '9')
+    {
+      if (digits < 6)
+      {
+        fraction= fraction * 10 + (**ptr - '0');
+        digits++;
+      }
+      (*ptr)++;
+    }
+    for (; digits < 6; digits++)
+    {
+      fraction*= 10;
+    }
+  }
+  *micros= ((hours * 60 + minutes) * 60 + seconds) * 1000000 + fraction;
+
+  return true;
+}
+
+/* Decode a text field of a temporal column, false if it is NULL or a zero
+ * date */
+static bool _arrow_temporal(arrow_kind_t kind, const char *field, size_t size,
+                            void *values, int64_t row)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+  int64_t days= 0;
+  int64_t micros= 0;
+  bool negative;
+
+  switch ((int)kind)
+  {
+    case ARROW_KIND_DATE32:
+      if (field == NULL || !_arrow_date(&ptr, end, &days))
+      {
+        days= 0;
+        field= NULL;
+      }
+      ((int32_t *)values)[row]= (int32_t)days;
+      return field != NULL;
+    case ARROW_KIND_TIMESTAMP:
+      if (field == NULL || !_arrow_date(&ptr, end, &days))
+      {
+        field= NULL;
+      }
+      else if ((_arrow_separator(&ptr, end, ' ') || _arrow_separator(&ptr, end, 'T')) &&
+               !_arrow_time(&ptr, end, &micros))
+      {
+        field= NULL;
+      }
+      ((int64_t *)values)[row]= field == NULL ? 0 : days * 86400 * 1000000 + micros;
+      return field != NULL;
+    case ARROW_KIND_DURATION:
+      negative= _arrow_separator(&ptr, end, '-');
+      if (field == NULL || !_arrow_time(&ptr, end, &micros))
+      {
+        field= NULL;
+      }
+      ((int64_t *)values)[row]= field == NULL ? 0 : (negative ? -micros : micros);
+      return field != NULL;
+    default:
+      return field != NULL;
+  }
+}
+
+/*
+ * Record batches
+ */
+
+static void _arrow_column_free(arrow_column_st *column)
+{
+  if (column == NULL)
+  {
+    return;
+  }
+
+  drizzle_vector_free(&column->vector);
+  delete column;
+}
+
+static void _arrow_batch_free(arrow_stream_st *stream)
+{
+  if (stream->columns == NULL)
+  {
+    return;
+  }
+
+  for (uint16_t x= 0; x < stream->result->column_count; x++)
+  {
+    _arrow_column_free(stream->columns[x]);
+  }
+  delete[] stream->columns;
+  stream->columns= NULL;
+  stream->length= 0;
+  stream->allocation= 0;
+}
+
+/* Make room for rows rows in every column of the batch, doubling the
+ * allocations up to the batch size */
+static bool _arrow_reserve(arrow_stream_st *stream, int64_t rows)
+{
+  int64_t allocation;
+
+  if (rows <= stream->allocation)
+  {
+    return true;
+  }
+
+  allocation= (int64_t)drizzle_vector_allocation((uint64_t)stream->allocation,
+                                                 (uint64_t)rows);
+  if (allocation > stream->batch_rows)
+  {
+    allocation= stream->batch_rows;
+  }
+
+  for (uint16_t x= 0; x < stream->result->column_count; x++)
+  {
+    size_t width= stream->kinds[x] == ARROW_KIND_DATE32 ? sizeof(int32_t) : sizeof(int64_t);
+
+    if (!drizzle_vector_reserve(&stream->columns[x]->vector,
+                                (uint64_t)stream->allocation,
+                                (uint64_t)allocation, width))
+    {
+      return false;
+    }
+  }
+  stream->allocation= allocation;
+
+  return true;
+}
+
+static bool _arrow_batch_begin(arrow_stream_st *stream)
+{
+  uint16_t column_count= stream->result->column_count;
+
+  stream->columns= new (std::nothrow) arrow_column_st*[column_count]();
+  if (stream->columns == NULL)
+  {
+    return false;
+  }
+
+  for (uint16_t x= 0; x < column_count; x++)
+  {
+    drizzle_result_vector_st *vector;
+
+    stream->columns[x]= new (std::nothrow) arrow_column_st();
+    if (stream->columns[x] == NULL)
+    {
+      return false;
+    }
+    vector= &stream->columns[x]->vector;
+    vector->type= _arrow_vector_type(stream->kinds[x]);
+
+    /* Consumers get a data buffer even when every string is empty */
+    if (vector->type == DRIZZLE_VECTOR_STRING)
+    {
+      vector->data= (char *)malloc(DRIZZLE_ROW_GROW_SIZE);
+      if (vector->data == NULL)
+      {
+        return false;
+      }
+      vector->data_allocation= DRIZZLE_ROW_GROW_SIZE;
+    }
+  }
+
+  return _arrow_reserve(stream, 1);
+}
+
+static bool _arrow_append_row(arrow_stream_st *stream, drizzle_row_t row)
+{
+  drizzle_result_st *result= stream->result;
+  int64_t row_number= stream->length;
+
+  if (!_arrow_reserve(stream, row_number + 1))
+  {
+    return false;
+  }
+
+  for (uint16_t x= 0; x < result->column_count; x++)
+  {
+    drizzle_result_vector_st *vector= &stream->columns[x]->vector;
+
+    if (vector->type == DRIZZLE_VECTOR_NONE)
+    {
+      drizzle_vector_set_valid(vector, (uint64_t)row_number,
+                               _arrow_temporal(stream->kinds[x], row[x],
+                                               result->field_sizes[x],
+                                               vector->values, row_number));
+    }
+    else if (!drizzle_vector_set(vector, (uint64_t)row_number, row[x],
+                                 result->field_sizes[x]))
+    {
+      return false;
+    }
+  }
+  stream->length++;
+
+  return true;
+}
+
+static void _arrow_column_release(struct ArrowArray *array)
+{
+  _arrow_column_free((arrow_column_st *)array->private_data);
+  array->release= NULL;
+}
+
+static void _arrow_batch_release(struct ArrowArray *array)
+{
+  arrow_batch_st *batch= (arrow_batch_st *)array->private_data;
+
+  for (int64_t x= 0; x < array->n_children; x++)
+  {
+    if (array->children[x]->release != NULL)
+    {
+      array->children[x]->release(array->children[x]);
+    }
+  }
+  delete[] batch->children;
+  delete[] batch->arrays;
+  delete batch;
+  array->release= NULL;
+}
+
+/* Hand the columns of the batch over to out, which then owns them */
+static bool _arrow_batch_export(arrow_stream_st *stream, struct ArrowArray *out)
+{
+  uint16_t column_count= stream->result->column_count;
+  arrow_batch_st *batch;
+
+  batch= new (std::nothrow) arrow_batch_st();
+  if (batch == NULL)
+  {
+    return false;
+  }
+  batch->children= new (std::nothrow) struct ArrowArray*[column_count];
+  batch->arrays= new (std::nothrow) struct ArrowArray[column_count]();
+  if (batch->children == NULL || batch->arrays == NULL)
+  {
+    delete[] batch->children;
+    delete[] batch->arrays;
+    delete batch;
+    return false;
+  }
+
+  for (uint16_t x= 0; x < column_count; x++)
+  {
+    arrow_column_st *column= stream->columns[x];
+    struct ArrowArray *child= &batch->arrays[x];
+
+    column->buffers[0]= column->vector.null_count > 0 ? column->vector.validity : NULL;
+    if (column->vector.type == DRIZZLE_VECTOR_STRING)
+    {
+      column->buffers[1]= column->vector.offsets;
+      column->buffers[2]= column->vector.data;
+      child->n_buffers= 3;
+    }
+    else
+    {
+      column->buffers[1]= column->vector.values;
+      child->n_buffers= 2;
+    }
+    child->length= stream->length;
+    child->null_count= (int64_t)column->vector.null_count;
+    child->buffers= column->buffers;
+    child->release= _arrow_column_release;
+    child->private_data= column;
+    batch->children[x]= child;
+    stream->columns[x]= NULL;
+  }
+
+  out->length= stream->length;
+  out->null_count= 0;
+  out->offset= 0;
+  out->n_buffers= 1;
+  out->n_children= column_count;
+  out->buffers= batch->buffers;
+  out->children= batch->children;
+  out->dictionary= NULL;
+  out->release= _arrow_batch_release;
+  out->private_data= batch;
+
+  _arrow_batch_free(stream);
+
+  return true;
+}
+
+/*
+ * Stream callbacks
+ */
+
+static void _arrow_schema_child_release(struct ArrowSchema *schema)
+{
+  delete[] (char *)schema->private_data;
+  schema->release= NULL;
+}
+
+static void _arrow_schema_release(struct ArrowSchema *schema)
+{
+  arrow_schema_st *storage= (arrow_schema_st *)schema->private_data;
+
+  for (int64_t x= 0; x < schema->n_children; x++)
+  {
+    if (schema->children[x]->release != NULL)
+    {
+      schema->children[x]->release(schema->children[x]);
+    }
+  }
+  delete[] storage->children;
+  delete[] storage->schemas;
+  delete storage;
+  schema->release= NULL;
+}
+
+static int _arrow_get_schema(struct ArrowArrayStream *stream,
+                             struct ArrowSchema *out)
+{
+  arrow_stream_st *state= (arrow_stream_st *)stream->private_data;
+  drizzle_result_st *result= state->result;
+  arrow_schema_st *storage;
+  uint16_t x;
+
+  storage= new (std::nothrow) arrow_schema_st();
+  if (storage == NULL)
+  {
+    state->error= "Failed to allocate.";
+    return ENOMEM;
+  }
+  storage->children= new (std::nothrow) struct ArrowSchema*[result->column_count];
+  storage->schemas= new (std::nothrow) struct ArrowSchema[result->column_count]();
+
+  out->format= "+s";
+  out->name= "";
+  out->metadata= NULL;
+  out->flags= 0;
+  out->n_children= 0;
+  out->children= storage->children;
+  out->dictionary= NULL;
+  out->release= _arrow_schema_release;
+  out->private_data= storage;
+
+  if (storage->children == NULL || storage->schemas == NULL)
+  {
+    _arrow_schema_release(out);
+    state->error= "Failed to allocate.";
+    return ENOMEM;
+  }
+
+  for (x= 0; x < result->column_count; x++)
+  {
+    drizzle_column_st *column= &result->column_buffer[x];
+    struct ArrowSchema *child= &storage->schemas[x];
+    size_t name_size= strlen(drizzle_column_name(column)) + 1;
+    char *name= new (std::nothrow) char[name_size];
+
+    if (name == NULL)
+    {
+      _arrow_schema_release(out);
+      state->error= "Failed to allocate.";
+      return ENOMEM;
+    }
+    memcpy(name, drizzle_column_name(column), name_size);
+
+    child->format= _arrow_formats[state->kinds[x]];
+    child->name= name;
+    /* Zero dates and other temporal values without an Arrow value are
+     * exported as NULL, even from NOT NULL columns */
+    if (!(column->flags & DRIZZLE_COLUMN_FLAGS_NOT_NULL) ||
+        state->kinds[x] == ARROW_KIND_DATE32 ||
+        state->kinds[x] == ARROW_KIND_TIMESTAMP ||
+        state->kinds[x] == ARROW_KIND_DURATION)
+    {
+      child->flags= ARROW_FLAG_NULLABLE;
+    }
+    else
+    {
+      child->flags= 0;
+    }
+    child->release= _arrow_schema_child_release;
+    child->private_data= name;
+    storage->children[x]= child;
+    out->n_children++;
+  }
+
+  return 0;
+}
+
+static int _arrow_get_next(struct ArrowArrayStream *stream,
+                           struct ArrowArray *out)
+{
+  arrow_stream_st *state= (arrow_stream_st *)stream->private_data;
+  drizzle_result_st *result= state->result;
+  drizzle_return_t ret;
+  drizzle_row_t row;
+
+  if (state->columns == NULL)
+  {
+    if (state->done)
+    {
+      out->release= NULL;
+      return 0;
+    }
+
+    if (!_arrow_batch_begin(state))
+    {
+      _arrow_batch_free(state);
+      state->error= "Failed to allocate.";
+      return ENOMEM;
+    }
+  }
+
+  /* A batch interrupted by DRIZZLE_RETURN_IO_WAIT continues here */
+  while (state->length < state->batch_rows)
+  {
+    row= drizzle_row_buffer(result, &ret);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      if (ret == DRIZZLE_RETURN_IO_WAIT)
+      {
+        state->error= "Waiting for the server.";
+        return EAGAIN;
+      }
+      _arrow_batch_free(state);
+      state->error= drizzle_error(result->con);
+      return ret == DRIZZLE_RETURN_MEMORY ? ENOMEM : EIO;
+    }
+
+    if (row == NULL)
+    {
+      state->done= true;
+      break;
+    }
+
+    if (!_arrow_append_row(state, row))
+    {
+      _arrow_batch_free(state);
+      state->error= "Failed to allocate.";
+      return ENOMEM;
+    }
+  }
+
+  if (state->length == 0)
+  {
+    _arrow_batch_free(state);
+    out->release= NULL;
+    return 0;
+  }
+
+  if (!_arrow_batch_export(state, out))
+  {
+    _arrow_batch_free(state);
+    state->error= "Failed to allocate.";
+    return ENOMEM;
+  }
+
+  return 0;
+}
+
+static const char *_arrow_get_last_error(struct ArrowArrayStream *stream)
+{
+  return ((arrow_stream_st *)stream->private_data)->error;
+}
+
+static void _arrow_stream_release(struct ArrowArrayStream *stream)
+{
+  arrow_stream_st *state= (arrow_stream_st *)stream->private_data;
+
+  _arrow_batch_free(state);
+  delete[] state->kinds;
+  delete state;
+  stream->release= NULL;
+}
+
+/*
+ * Client definitions
+ */
+
+drizzle_return_t drizzle_result_arrow_stream(drizzle_result_st *result,
+                                             uint64_t batch_rows,
+                                             struct ArrowArrayStream *stream)
+{
+  arrow_stream_st *state;
+  drizzle_return_t ret;
+
+  if (result == NULL || stream == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (!(result->options & DRIZZLE_RESULT_BUFFER_COLUMN))
+  {
+    ret= drizzle_column_buffer(result);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+  }
+
+  if (batch_rows == 0 || result->binary_rows ||
+      (result->options & (DRIZZLE_RESULT_BUFFER_ROW | DRIZZLE_RESULT_BUFFER_COLUMNAR)))
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "Arrow export needs unread text rows and a batch size");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  state= new (std::nothrow) arrow_stream_st();
+  if (state == NULL)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    return DRIZZLE_RETURN_MEMORY;
+  }
+  state->kinds= new (std::nothrow) arrow_kind_t[result->column_count];
+  if (state->kinds == NULL)
+  {
+    delete state;
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    return DRIZZLE_RETURN_MEMORY;
+  }
+
+  for (uint16_t x= 0; x < result->column_count; x++)
+  {
+    state->kinds[x]= _arrow_kind(&result->column_buffer[x]);
+  }
+  state->result= result;
+  state->batch_rows= batch_rows > INT64_MAX ? INT64_MAX : (int64_t)batch_rows;
+  state->done= result->column_count == 0;
+  state->error= "";
+
+  stream->get_schema= _arrow_get_schema;
+  stream->get_next= _arrow_get_next;
+  stream->get_last_error= _arrow_get_last_error;
+  stream->release= _arrow_stream_release;
+  stream->private_data= state;
+
+  return DRIZZLE_RETURN_OK;
+}
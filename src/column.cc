@@ -94,6 +94,68 @@ void drizzle_column_free(drizzle_column_st *column)
   delete column;
 }
 
+/* Grow the packet copy of a column, keeping its contents */
+static bool _column_reserve(drizzle_column_st *column, size_t size)
+{
+  if (column->packet_allocation < size)
+  {
+    unsigned char *packet= (unsigned char *)realloc(column->packet, size);
+    if (packet == NULL)
+    {
+      return false;
+    }
+    column->packet= packet;
+    column->packet_allocation= size;
+  }
+
+  return true;
+}
+
+/* The strings of a column that was never read are empty */
+static const char *_column_string(const drizzle_column_st *column,
+                                  uint32_t offset)
+{
+  if (column->packet == NULL)
+  {
+    return "";
+  }
+
+  return (const char *)column->packet + offset;
+}
+
+drizzle_return_t drizzle_column_copy(drizzle_column_st *column,
+                                     const drizzle_column_st *from)
+{
+  if (from->packet != NULL)
+  {
+    if (!_column_reserve(column, from->packet_size + 1))
+    {
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    memcpy(column->packet, from->packet, from->packet_size + 1);
+  }
+  column->packet_size= from->packet_size;
+
+  column->result= from->result;
+  column->options= from->options;
+  column->catalog= from->catalog;
+  column->db= from->db;
+  column->table= from->table;
+  column->orig_table= from->orig_table;
+  column->name= from->name;
+  column->orig_name= from->orig_name;
+  column->charset= from->charset;
+  column->size= from->size;
+  column->max_size= from->max_size;
+  column->type= from->type;
+  column->flags= from->flags;
+  column->decimals= from->decimals;
+  column->default_value= from->default_value;
+  column->default_value_size= from->default_value_size;
+
+  return DRIZZLE_RETURN_OK;
+}
+
 drizzle_result_st *drizzle_column_drizzle_result(drizzle_column_st *column)
 {
   if (column == NULL)
@@ -111,7 +173,7 @@ const char *drizzle_column_catalog(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->catalog;
+  return _column_string(column, column->catalog);
 }
 
 const char *drizzle_column_db(drizzle_column_st *column)
@@ -121,7 +183,7 @@ const char *drizzle_column_db(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->db;
+  return _column_string(column, column->db);
 }
 
 const char *drizzle_column_table(drizzle_column_st *column)
@@ -131,7 +193,7 @@ const char *drizzle_column_table(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->table;
+  return _column_string(column, column->table);
 }
 
 const char *drizzle_column_orig_table(drizzle_column_st *column)
@@ -141,7 +203,7 @@ const char *drizzle_column_orig_table(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->orig_table;
+  return _column_string(column, column->orig_table);
 }
 
 const char *drizzle_column_name(drizzle_column_st *column)
@@ -151,7 +213,7 @@ const char *drizzle_column_name(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->name;
+  return _column_string(column, column->name);
 }
 
 const char *drizzle_column_orig_name(drizzle_column_st *column)
@@ -161,7 +223,7 @@ const char *drizzle_column_orig_name(drizzle_column_st *column)
     return NULL;
   }
 
-  return column->orig_name;
+  return _column_string(column, column->orig_name);
 }
 
 drizzle_charset_t drizzle_column_charset(drizzle_column_st *column)
@@ -303,7 +365,12 @@ const unsigned char *drizzle_column_default_value(drizzle_column_st *column,
   }
 
   *size= column->default_value_size;
-  return column->default_value;
+  if (column->packet == NULL)
+  {
+    return (const unsigned char *)"";
+  }
+
+  return column->packet + column->default_value;
 }
 
 /*
@@ -317,11 +384,17 @@ drizzle_return_t drizzle_column_skip(drizzle_result_st *result)
     return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
 
+  /* The server did not send the column definitions */
+  if (result->metadata_skipped)
+  {
+    return DRIZZLE_RETURN_OK;
+  }
+
   drizzle_return_t ret;
+  /* Set again when continuing after DRIZZLE_RETURN_IO_WAIT */
+  result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_SKIP_COLUMN);
   if (result->has_state())
   {
-    result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_SKIP_COLUMN);
-
     result->push_state(drizzle_state_column_read);
     result->push_state(drizzle_state_packet_read);
   }
@@ -365,6 +438,13 @@ drizzle_column_st *drizzle_column_read(drizzle_result_st *result,
     return NULL;
   }
 
+  if (result->metadata_skipped)
+  {
+    *ret_ptr= DRIZZLE_RETURN_OK;
+    result->column= NULL;
+    return NULL;
+  }
+
   if (result->has_state())
   {
     result->push_state(drizzle_state_column_read);
@@ -412,6 +492,8 @@ drizzle_return_t drizzle_column_buffer(drizzle_result_st *result)
   if (ret == DRIZZLE_RETURN_OK)
   {
     result->column_current= 0;
+    /* Definitions read into a reused buffer may carry new names */
+    result->column_index_columns= NULL;
     result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_BUFFER_COLUMN);
   }
 
@@ -489,39 +571,247 @@ uint16_t drizzle_column_current(drizzle_result_st *result)
   return result->column_current;
 }
 
-/*
- * Server definitions
- */
+/* FNV-1a over a column name, bounded like the stored names are */
+static uint32_t _column_name_hash(const char *name)
+{
+  uint32_t hash= 2166136261U;
+
+  for (size_t x= 0; x < DRIZZLE_MAX_COLUMN_NAME_SIZE && name[x] != '\0'; x++)
+  {
+    hash^= (uint8_t)name[x];
+    hash*= 16777619U;
+  }
 
-void drizzle_column_set_default_value(drizzle_column_st *column,
-                                      const unsigned char *default_value,
-                                      size_t size)
+  return hash;
+}
+
+/* Build the open addressing index of the buffered column names. Slots hold
+ * the column number plus one so zero marks an empty slot. Duplicate names
+ * keep their first column, as a scan from the left would. */
+static drizzle_return_t _column_index_build(drizzle_result_st *result)
 {
-  if (column == NULL)
+  uint32_t size= 4;
+
+  while (size < (uint32_t)result->column_count * 2)
   {
-    return;
+    size<<= 1;
   }
 
-  if (default_value == NULL)
+  if (size > result->column_index_size)
   {
-    column->default_value[0]= 0;
+    uint16_t *index= new (std::nothrow) uint16_t[size];
+    if (index == NULL)
+    {
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    delete[] result->column_index;
+    result->column_index= index;
+    result->column_index_size= size;
   }
   else
   {
-    if (size < DRIZZLE_MAX_DEFAULT_VALUE_SIZE)
+    size= result->column_index_size;
+  }
+  memset(result->column_index, 0, size * sizeof(uint16_t));
+
+  for (uint16_t column= 0; column < result->column_count; column++)
+  {
+    const char *name= drizzle_column_name(&result->column_buffer[column]);
+    uint32_t slot= _column_name_hash(name) & (size - 1);
+
+    while (result->column_index[slot] != 0)
     {
-      memcpy(column->default_value, default_value, size);
-      column->default_value[size]= 0;
-      column->default_value_size= size;
+      if (strncmp(name, drizzle_column_name(&result->column_buffer[result->column_index[slot] - 1]),
+                  DRIZZLE_MAX_COLUMN_NAME_SIZE) == 0)
+      {
+        break;
+      }
+      slot= (slot + 1) & (size - 1);
     }
-    else
+
+    if (result->column_index[slot] == 0)
+    {
+      result->column_index[slot]= (uint16_t)(column + 1);
+    }
+  }
+
+  result->column_index_columns= result->column_buffer;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+uint16_t drizzle_column_lookup(drizzle_result_st *result,
+                               const char *column_name,
+                               drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (result == NULL || column_name == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return 0;
+  }
+
+  if (result->column_count == 0)
+  {
+    *ret_ptr= DRIZZLE_RETURN_NOT_FOUND;
+    return 0;
+  }
+
+  if (result->column_buffer == NULL)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "column definitions are not buffered");
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return 0;
+  }
+
+  /* The definitions can move between result sets of a statement, so the
+   * index belongs to the buffer it was built from */
+  if (result->column_index_columns != result->column_buffer)
+  {
+    *ret_ptr= _column_index_build(result);
+    if (*ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      return 0;
+    }
+  }
+
+  uint32_t mask= result->column_index_size - 1;
+  uint32_t slot= _column_name_hash(column_name) & mask;
+
+  while (result->column_index[slot] != 0)
+  {
+    uint16_t column= (uint16_t)(result->column_index[slot] - 1);
+    if (strncmp(column_name, drizzle_column_name(&result->column_buffer[column]),
+                DRIZZLE_MAX_COLUMN_NAME_SIZE) == 0)
+    {
+      *ret_ptr= DRIZZLE_RETURN_OK;
+      return column;
+    }
+    slot= (slot + 1) & mask;
+  }
+
+  *ret_ptr= DRIZZLE_RETURN_NOT_FOUND;
+  return 0;
+}
+
+/*
+ * Copy a column definition packet and find its strings. Only the offsets are
+ * kept, each string is terminated in place over the length of the next one.
+ */
+static drizzle_return_t _column_unpack(drizzle_column_st *column,
+                                       const unsigned char *data, size_t size)
+{
+  uint32_t *strings[]= { &column->catalog, &column->db, &column->table,
+                         &column->orig_table, &column->name,
+                         &column->orig_name };
+  size_t lengths[6];
+  size_t offset= 0;
+  unsigned char *ptr;
+
+  if (!_column_reserve(column, size + 1))
+  {
+    return DRIZZLE_RETURN_MEMORY;
+  }
+  memcpy(column->packet, data, size);
+  column->packet[size]= 0;
+  column->packet_size= size;
+
+  for (uint8_t x= 0; x < 6; x++)
+  {
+    size_t header;
+
+    if (offset == size)
+    {
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+
+    ptr= column->packet + offset;
+    switch (ptr[0])
     {
-      memcpy(column->default_value, default_value,
-             DRIZZLE_MAX_DEFAULT_VALUE_SIZE - 1);
-      column->default_value[DRIZZLE_MAX_DEFAULT_VALUE_SIZE - 1]= 0;
-      column->default_value_size= DRIZZLE_MAX_DEFAULT_VALUE_SIZE;
+    case 251:
+      header= 1;
+      lengths[x]= 0;
+      break;
+
+    case 252:
+      header= 3;
+      break;
+
+    case 253:
+      header= 4;
+      break;
+
+    default:
+      if (ptr[0] > 253)
+      {
+        return DRIZZLE_RETURN_UNEXPECTED_DATA;
+      }
+      header= 1;
+      lengths[x]= ptr[0];
+      break;
     }
+
+    if (size - offset < header)
+    {
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+    if (ptr[0] == 252)
+    {
+      lengths[x]= drizzle_get_byte2(ptr + 1);
+    }
+    else if (ptr[0] == 253)
+    {
+      lengths[x]= drizzle_get_byte3(ptr + 1);
+    }
+    offset+= header;
+
+    if (lengths[x] > size - offset)
+    {
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+    *strings[x]= (uint32_t)offset;
+    offset+= lengths[x];
+  }
+
+  if (size - offset < 13)
+  {
+    return DRIZZLE_RETURN_UNEXPECTED_DATA;
+  }
+
+  /* Skip one filler byte. */
+  ptr= column->packet + offset;
+  column->charset= (drizzle_charset_t)drizzle_get_byte2(ptr + 1);
+  column->max_size= drizzle_get_byte4(ptr + 3);
+
+  column->type= drizzle_column_type_t(ptr[7]);
+
+  column->flags= drizzle_get_byte2(ptr + 8);
+  if (column->type <= DRIZZLE_COLUMN_TYPE_INT24 &&
+      column->type != DRIZZLE_COLUMN_TYPE_TIMESTAMP)
+  {
+    column->flags|= DRIZZLE_COLUMN_FLAGS_NUM;
   }
+
+  column->decimals= ptr[10];
+  /* Skip two reserved bytes. */
+
+  /* Everything is decoded, the lengths and the filler can be overwritten */
+  for (uint8_t x= 0; x < 6; x++)
+  {
+    column->packet[*strings[x] + lengths[x]]= 0;
+  }
+
+  column->default_value= (uint32_t)(offset + 13);
+  column->default_value_size= size - offset - 13;
+
+  return DRIZZLE_RETURN_OK;
 }
 
 /*
@@ -582,48 +872,23 @@ drizzle_return_t drizzle_state_column_read(drizzle_st *con)
     }
 
     column->result= con->result;
-    /* These functions can only fail if they need to read data, but we know we
-       buffered the entire packet, so ignore returns. */
-    (void)drizzle_unpack_string(con, column->catalog, DRIZZLE_MAX_CATALOG_SIZE);
-    (void)drizzle_unpack_string(con, column->db, DRIZZLE_MAX_DB_SIZE);
-    (void)drizzle_unpack_string(con, column->table, DRIZZLE_MAX_TABLE_SIZE);
-    (void)drizzle_unpack_string(con, column->orig_table,
-                                DRIZZLE_MAX_TABLE_SIZE);
-    (void)drizzle_unpack_string(con, column->name,
-                                DRIZZLE_MAX_COLUMN_NAME_SIZE);
-    (void)drizzle_unpack_string(con, column->orig_name,
-                                DRIZZLE_MAX_COLUMN_NAME_SIZE);
-
-    /* Skip one filler byte. */
-    column->charset= (drizzle_charset_t)drizzle_get_byte2(con->buffer_ptr + 1);
-    column->max_size= drizzle_get_byte4(con->buffer_ptr + 3);
-
-    column->type= drizzle_column_type_t(con->buffer_ptr[7]);
-
-    column->flags= drizzle_get_byte2(con->buffer_ptr + 8);
-    if (column->type <= DRIZZLE_COLUMN_TYPE_INT24 &&
-        column->type != DRIZZLE_COLUMN_TYPE_TIMESTAMP)
+    /* The entire packet is buffered, so it is kept as it is */
+    drizzle_return_t ret= _column_unpack(column, con->buffer_ptr,
+                                         con->packet_size);
+    con->buffer_ptr+= con->packet_size;
+    con->buffer_size-= con->packet_size;
+    con->packet_size= 0;
+
+    if (ret == DRIZZLE_RETURN_MEMORY)
     {
-      column->flags|= DRIZZLE_COLUMN_FLAGS_NUM;
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      return ret;
     }
-
-    column->decimals= con->buffer_ptr[10];
-    /* Skip two reserved bytes. */
-
-    con->buffer_ptr+= 13;
-    con->buffer_size-= 13;
-    con->packet_size-= 13;
-
-    if (con->packet_size > 0)
+    else if (ret != DRIZZLE_RETURN_OK)
     {
-      drizzle_column_set_default_value(column, con->buffer_ptr,
-                                       con->packet_size);
-
-      con->buffer_ptr+= con->packet_size;
-      con->buffer_size-= con->packet_size;
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "malformed column definition");
+      return ret;
     }
-    else
-      column->default_value[0]= 0;
 
     con->result->column_current++;
 
@@ -42,6 +42,8 @@
  */
 drizzle_column_st *drizzle_column_create(drizzle_result_st *result);
 
-void drizzle_column_set_default_value(drizzle_column_st *column,
-                                      const unsigned char *default_value,
-                                      size_t size);
+/**
+ * Copy a column definition, including its packet.
+ */
+drizzle_return_t drizzle_column_copy(drizzle_column_st *column,
+                                     const drizzle_column_st *from);
@@ -92,14 +92,27 @@ drizzle_return_t drizzle_state_command_write(drizzle_st *con)
                     + DRIZZLE_MAX_SCRAMBLE_SIZE
                     + strlen(con->db) + 1);
 
-    /* Flush buffer if there is not enough room. */
+    /* Flush buffer if there is not enough room. An empty buffer is never
+       flushed, closes which do not fit into it wait for a later command. */
     free_size= con->buffer_allocation - (size_t)(start - con->buffer);
-    if (free_size < con->packet_size)
+    if (free_size < con->packet_size + DRIZZLE_STMT_CLOSE_PACKET_SIZE * con->stmt_close_count &&
+        con->buffer_size > 0)
     {
       con->push_state(drizzle_state_write);
       return DRIZZLE_RETURN_OK;
     }
 
+    /* Statements evicted from the statement cache are closed in front of
+       the next command, saving a round trip each. */
+    if (con->stmt_close_count > 0 && !con->state.raw_packet &&
+        free_size > con->packet_size)
+    {
+      ptr= drizzle_stmt_close_pending(con, start, free_size - con->packet_size);
+      con->buffer_size+= (size_t)(ptr - start);
+      free_size-= (size_t)(ptr - start);
+      start= ptr;
+    }
+
     /* Store packet size at the end since it may change. */
     con->packet_number= 1;
     ptr= start;
@@ -74,6 +74,24 @@ static drizzle_return_t _setsockopt(drizzle_st *con);
 static void connect_failed_try_next(drizzle_st *con, const char *file, uint line,
   const char *function, const char *msg);
 
+/**
+ * Advance the write buffer and the caller's iovecs past sent data.
+ *
+ * @param[in] con Connection structure
+ * @param[in] size Number of bytes written
+ */
+static void _write_consume(drizzle_st *con, size_t size);
+
+#if !defined(_WIN32) && !defined(__MINGW32__)
+/**
+ * Send the write buffer followed by the caller's iovecs with one call.
+ *
+ * @param[in] con Connection structure
+ * @return Number of bytes written, or -1 on error
+ */
+static ssize_t _send_iov(drizzle_st *con);
+#endif
+
 static void __closesocket(socket_t& fd)
 {
   if (fd != INVALID_SOCKET)
@@ -130,9 +148,15 @@ void drizzle_close(drizzle_st *con)
   con->packet_number= 0;
   con->buffer_ptr= con->buffer;
   con->buffer_size= 0;
+  con->write_iov_count= 0;
   con->events= 0;
   con->revents= 0;
 
+  /* Cached statements do not survive the connection */
+  con->stmt_close_count= 0;
+  drizzle_stmt_queue_clear(con);
+  con->generation++;
+
   con->clear_state();
 }
 
@@ -396,6 +420,60 @@ bool drizzle_options_get_multi_statements(drizzle_options_st *options)
   return options->multi_statements;
 }
 
+void drizzle_options_set_local_infile(drizzle_options_st *options, bool state)
+{
+  if (options == NULL)
+  {
+    return;
+  }
+  options->local_infile= state;
+}
+
+bool drizzle_options_get_local_infile(drizzle_options_st *options)
+{
+  if (options == NULL)
+  {
+    return false;
+  }
+  return options->local_infile;
+}
+
+void drizzle_options_set_cache_metadata(drizzle_options_st *options, bool state)
+{
+  if (options == NULL)
+  {
+    return;
+  }
+  options->cache_metadata= state;
+}
+
+bool drizzle_options_get_cache_metadata(drizzle_options_st *options)
+{
+  if (options == NULL)
+  {
+    return false;
+  }
+  return options->cache_metadata;
+}
+
+void drizzle_options_set_bulk_operations(drizzle_options_st *options, bool state)
+{
+  if (options == NULL)
+  {
+    return;
+  }
+  options->bulk_operations= state;
+}
+
+bool drizzle_options_get_bulk_operations(drizzle_options_st *options)
+{
+  if (options == NULL)
+  {
+    return false;
+  }
+  return options->bulk_operations;
+}
+
 void drizzle_options_set_auth_plugin(drizzle_options_st *options, bool state)
 {
   if (options == NULL)
@@ -1532,13 +1610,23 @@ drizzle_return_t drizzle_state_write(drizzle_st *con)
 
   __LOG_LOCATION__
 
-  while (con->buffer_size != 0)
+  while (con->buffer_size != 0 || con->write_iov_count != 0)
   {
+    /* Data passed by the caller is written after the buffer without
+       copying it, see drizzle_state_stmt_long_data_write() */
+    unsigned char *write_ptr= con->buffer_ptr;
+    size_t write_length= con->buffer_size;
+    if (write_length == 0)
+    {
+      write_ptr= (unsigned char *)con->write_iov[0].iov_base;
+      write_length= con->write_iov[0].iov_len;
+    }
+
 #ifdef USE_OPENSSL
     if (con->ssl_state == DRIZZLE_SSL_STATE_HANDSHAKE_COMPLETE)
     {
       ERR_clear_error();
-      write_size= SSL_write(con->ssl, con->buffer_ptr, (con->buffer_size % INT_MAX));
+      write_size= SSL_write(con->ssl, write_ptr, (write_length % INT_MAX));
       if (write_size <= 0) {
               int rc = SSL_get_error(con->ssl, write_size);
               drizzle_return_t rsev;
@@ -1577,9 +1665,16 @@ drizzle_return_t drizzle_state_write(drizzle_st *con)
       }
     }
     else
+#endif
+#if !defined(_WIN32) && !defined(__MINGW32__)
+    if (con->write_iov_count != 0)
+    {
+      write_size= _send_iov(con);
+    }
+    else
 #endif
     {
-      write_size= send(con->fd,(char *) con->buffer_ptr, con->buffer_size, MSG_NOSIGNAL);
+      write_size= send(con->fd,(char *) write_ptr, write_length, MSG_NOSIGNAL);
     }
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -1640,13 +1735,11 @@ drizzle_return_t drizzle_state_write(drizzle_st *con)
       return DRIZZLE_RETURN_ERRNO;
     }
 
-    con->buffer_ptr+= write_size;
-    con->buffer_size-= (size_t)write_size;
-    if (con->buffer_size == 0)
-      break;
+    _write_consume(con, (size_t)write_size);
   }
 
   con->buffer_ptr= con->buffer;
+  con->write_iov= NULL;
 
   con->pop_state();
 
@@ -1886,3 +1979,54 @@ static void connect_failed_try_next(drizzle_st *con, const char *file, uint line
 
   con->push_state(drizzle_state_connect);
 }
+
+static void _write_consume(drizzle_st *con, size_t size)
+{
+  size_t part= size < con->buffer_size ? size : con->buffer_size;
+
+  con->buffer_ptr+= part;
+  con->buffer_size-= part;
+  size-= part;
+
+  while (con->write_iov_count != 0 && (size > 0 || con->write_iov[0].iov_len == 0))
+  {
+    if (size < con->write_iov[0].iov_len)
+    {
+      con->write_iov[0].iov_base= (unsigned char *)con->write_iov[0].iov_base + size;
+      con->write_iov[0].iov_len-= size;
+      break;
+    }
+
+    size-= con->write_iov[0].iov_len;
+    con->write_iov++;
+    con->write_iov_count--;
+  }
+}
+
+#if !defined(_WIN32) && !defined(__MINGW32__)
+static ssize_t _send_iov(drizzle_st *con)
+{
+  struct iovec iov[DRIZZLE_STMT_LONG_DATA_IOV_MAX + 1];
+  struct msghdr msg;
+  int count= 0;
+
+  if (con->buffer_size != 0)
+  {
+    iov[count].iov_base= con->buffer_ptr;
+    iov[count].iov_len= con->buffer_size;
+    count++;
+  }
+
+  for (int x= 0; x < con->write_iov_count && count < DRIZZLE_STMT_LONG_DATA_IOV_MAX + 1; x++)
+  {
+    iov[count]= con->write_iov[x];
+    count++;
+  }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov= iov;
+  msg.msg_iovlen= count;
+
+  return sendmsg(con->fd, &msg, MSG_NOSIGNAL);
+}
+#endif
@@ -198,6 +198,29 @@ void drizzle_set_event_watch_fn(drizzle_st *drizzle,
   drizzle->event_watch_context= context;
 }
 
+void drizzle_set_local_infile_fn(drizzle_st *con,
+                                 drizzle_local_infile_fn *function,
+                                 void *context)
+{
+  if (con == NULL)
+  {
+    return;
+  }
+
+  con->local_infile_fn= function;
+  con->local_infile_context= context;
+}
+
+void drizzle_set_local_infile_fd(drizzle_st *con, int fd)
+{
+  if (con == NULL)
+  {
+    return;
+  }
+
+  con->local_infile_fd= fd;
+}
+
 drizzle_st *drizzle_clone(drizzle_st *drizzle, const drizzle_st *from)
 {
   drizzle= new (std::nothrow) drizzle_st;
@@ -243,6 +266,7 @@ void drizzle_free(drizzle_st *con)
     con->context_free_fn(con, con->context);
   }
 
+  drizzle_stmt_cache_free(con);
   drizzle_result_free_all(con);
 
   if (con->fd != INVALID_SOCKET)
@@ -265,6 +289,9 @@ void drizzle_free(drizzle_st *con)
     drizzle_binlog_free(con->binlog);
   }
 
+  free(con->stmt_close_ids);
+  free(con->stmt_queue_buffer);
+  delete[] con->stmt_queue;
   free(con->buffer);
   delete con;
 }
@@ -102,6 +102,14 @@ bool drizzle_library_init(drizzle_st*);
  */
 drizzle_result_st *drizzle_result_create(drizzle_st *con);
 
+/**
+ * Free the columns and rows of a result struct and return it to the state
+ * of a newly created one, so it can be reused without an allocation.
+ *
+ * @param[in,out] result the result object to reset
+ */
+void drizzle_result_reset(drizzle_result_st *result);
+
 /*
  * Convert a char array to hex
  *
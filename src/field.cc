@@ -66,16 +66,6 @@ drizzle_field_t drizzle_field_read(drizzle_result_st *result, uint64_t *offset,
     return 0;
   }
 
-  if (result->binary_rows && (result->field_current == 0))
-  {
-    result->push_state(drizzle_state_binary_null_read);
-    *ret_ptr= drizzle_state_loop(result->con);
-    if (*ret_ptr != DRIZZLE_RETURN_OK)
-    {
-      return 0;
-    }
-  }
-
   if (result->has_state())
   {
     if (result->field_current == (result->column_count - result->null_bitcount))
@@ -378,8 +368,21 @@ drizzle_return_t drizzle_state_field_read(drizzle_st *con)
 drizzle_return_t drizzle_state_binary_null_read(drizzle_st *con)
 {
   uint16_t bit_count= 0;
+
+  /* The fields of binary rows are decoded in place, so the whole row has to
+   * be in the buffer */
+  if (con->buffer_size < con->packet_size)
+  {
+    con->push_state(drizzle_state_read);
+    return DRIZZLE_RETURN_OK;
+  }
+
   con->result->null_bitmap_length= (con->result->column_count+7+2)/8;
-  con->result->null_bitmap= new uint8_t[con->result->null_bitmap_length];
+  /* The bitmap of the previous row is reused unless it was freed */
+  if (con->result->null_bitmap == NULL)
+  {
+    con->result->null_bitmap= new uint8_t[con->result->null_bitmap_length];
+  }
   con->buffer_ptr++;
 
   memcpy(con->result->null_bitmap, con->buffer_ptr, con->result->null_bitmap_length);
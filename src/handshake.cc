@@ -182,6 +182,18 @@ drizzle_return_t drizzle_state_handshake_server_read(drizzle_st *con)
   con->buffer_ptr+= 1;
 
   con->status= (drizzle_status_t)drizzle_get_byte2(con->buffer_ptr);
+
+  /* MariaDB servers clear the LONG_PASSWORD ("CLIENT_MYSQL") capability and
+     send their extended capabilities in the last 4 filler bytes. */
+  if (con->capabilities & DRIZZLE_CAPABILITIES_LONG_PASSWORD)
+  {
+    con->extended_capabilities= 0;
+  }
+  else
+  {
+    con->extended_capabilities= (uint32_t)drizzle_get_byte4(con->buffer_ptr + 11);
+  }
+
   /* Skip status and filler. */
   con->buffer_ptr+= 15;
 
@@ -510,6 +522,11 @@ int drizzle_compile_capabilities(drizzle_st *con)
   {
     capabilities|= DRIZZLE_CAPABILITIES_PLUGIN_AUTH;
   }
+
+  if (con->options.local_infile)
+  {
+    capabilities|= DRIZZLE_CAPABILITIES_LOCAL_FILES;
+  }
 #ifdef USE_OPENSSL
   if (con->ssl)
   {
@@ -523,6 +540,29 @@ int drizzle_compile_capabilities(drizzle_st *con)
   return capabilities;
 }
 
+uint32_t drizzle_compile_extended_capabilities(drizzle_st *con)
+{
+  uint32_t capabilities= 0;
+
+  con->state.cache_metadata= false;
+  if (con->options.cache_metadata &&
+      (con->extended_capabilities & DRIZZLE_EXTENDED_CAPABILITIES_CACHE_METADATA))
+  {
+    capabilities|= DRIZZLE_EXTENDED_CAPABILITIES_CACHE_METADATA;
+    con->state.cache_metadata= true;
+  }
+
+  con->state.bulk_operations= false;
+  if (con->options.bulk_operations &&
+      (con->extended_capabilities & DRIZZLE_EXTENDED_CAPABILITIES_STMT_BULK_OPERATIONS))
+  {
+    capabilities|= DRIZZLE_EXTENDED_CAPABILITIES_STMT_BULK_OPERATIONS;
+    con->state.bulk_operations= true;
+  }
+
+  return capabilities;
+}
+
 drizzle_return_t drizzle_state_handshake_client_write(drizzle_st *con)
 {
   unsigned char *ptr;
@@ -623,6 +663,8 @@ drizzle_return_t drizzle_state_handshake_client_write(drizzle_st *con)
   ptr++;
 
   memset(ptr, 0, 23);
+  capabilities= (int)drizzle_compile_extended_capabilities(con);
+  drizzle_set_byte4(ptr + 19, capabilities);
   ptr+= 23;
 
   ptr= drizzle_pack_auth(con, ptr, &ret);
@@ -678,6 +720,8 @@ drizzle_return_t drizzle_state_handshake_ssl_client_write(drizzle_st *con)
   ptr++;
 
   memset(ptr, 0, 23);
+  capabilities= (int)drizzle_compile_extended_capabilities(con);
+  drizzle_set_byte4(ptr + 19, capabilities);
 
   con->pop_state();
   return DRIZZLE_RETURN_OK;
@@ -85,6 +85,13 @@ drizzle_return_t drizzle_handshake_ssl_client_write(drizzle_st *con);
 
 int drizzle_compile_capabilities(drizzle_st *con);
 
+/* MariaDB capabilities sent in the last 4 filler bytes of the client
+ * handshake, see drizzle_compile_extended_capabilities() */
+#define DRIZZLE_EXTENDED_CAPABILITIES_STMT_BULK_OPERATIONS (1 << 2)
+#define DRIZZLE_EXTENDED_CAPABILITIES_CACHE_METADATA (1 << 4)
+
+uint32_t drizzle_compile_extended_capabilities(drizzle_st *con);
+
 /** @} */
 
 #ifdef __cplusplus
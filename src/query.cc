@@ -45,6 +45,10 @@
 
 #include "src/common.h"
 
+#include <ctype.h>
+#include <inttypes.h>
+#include <math.h>
+
 drizzle_result_st *drizzle_query(drizzle_st *con,
                                  const char *query, size_t size,
                                  drizzle_return_t *ret_ptr)
@@ -57,31 +61,20 @@ drizzle_result_st *drizzle_query(drizzle_st *con,
                                    (unsigned char *)query, size, size, ret_ptr);
 }
 
-ssize_t drizzle_escape_str(drizzle_st *con, char **destination, const char *from, const size_t from_size, bool is_pattern)
+/**
+ * Escape from_size bytes of from into to, which must have room for at least
+ * from_size * 2 bytes. No terminating NUL is written.
+ *
+ * @return the number of bytes written to to
+ */
+static size_t _escape_buffer(char *to, const char *from, size_t from_size,
+                             bool is_pattern)
 {
-  (void)con;
   const char *end;
-
-  if (from == NULL || from_size == 0)
-  {
-    return -1;
-  }
-
-  size_t max_to_size= from_size * 2;
-  *destination= (char*) malloc(max_to_size);
-
-  if (destination == NULL)
-  {
-    return -1;
-  }
-
-  char *to= *destination;
-
-
-  ssize_t to_size= 0;
+  char *start= to;
   char newchar;
 
-  for (end= from +from_size; from < end; from++)
+  for (end= from + from_size; from < end; from++)
   {
     newchar= 0;
     /* All multi-byte UTF8 characters have the high bit set for all bytes. */
@@ -130,34 +123,157 @@ ssize_t drizzle_escape_str(drizzle_st *con, char **destination, const char *from
     }
     if (newchar != '\0')
     {
-      if ((size_t)to_size + 2 > max_to_size)
-      {
-        free(to);
-        *destination= NULL;
-        return -1;
-      }
-
       *to++= '\\';
       *to++= newchar;
-      to_size++;
     }
     else
     {
-      if ((size_t)to_size + 1 > max_to_size)
+      *to++= *from;
+    }
+  }
+
+  return (size_t)(to - start);
+}
+
+/* Size of the multi-byte character at from in the charsets whose trailing
+ * bytes can look like a quote or a backslash, 1 for anything else */
+static size_t _mb_char_size(drizzle_charset_t charset, const char *from,
+                            const char *end)
+{
+  unsigned char lead;
+  unsigned char trail;
+
+  if (end - from < 2)
+  {
+    return 1;
+  }
+  lead= (unsigned char)from[0];
+  trail= (unsigned char)from[1];
+
+  switch ((int)charset)
+  {
+  case DRIZZLE_CHARSET_BIG5_CHINESE_CI:
+  case DRIZZLE_CHARSET_BIG5_BIN:
+    if (lead >= 0xA1 && lead <= 0xF9 &&
+        ((trail >= 0x40 && trail <= 0x7E) || (trail >= 0xA1 && trail <= 0xFE)))
+    {
+      return 2;
+    }
+    break;
+  case DRIZZLE_CHARSET_SJIS_JAPANESE_CI:
+  case DRIZZLE_CHARSET_SJIS_BIN:
+  case DRIZZLE_CHARSET_CP932_JAPANESE_CI:
+  case DRIZZLE_CHARSET_CP932_BIN:
+    if (((lead >= 0x81 && lead <= 0x9F) || (lead >= 0xE0 && lead <= 0xFC)) &&
+        ((trail >= 0x40 && trail <= 0x7E) || (trail >= 0x80 && trail <= 0xFC)))
+    {
+      return 2;
+    }
+    break;
+  case DRIZZLE_CHARSET_GBK_CHINESE_CI:
+  case DRIZZLE_CHARSET_GBK_BIN:
+    if (lead >= 0x81 && lead <= 0xFE && trail >= 0x40 && trail <= 0xFE &&
+        trail != 0x7F)
+    {
+      return 2;
+    }
+    break;
+  default:
+    break;
+  }
+
+  return 1;
+}
+
+static bool _charset_is_unsafe(drizzle_charset_t charset)
+{
+  switch ((int)charset)
+  {
+  case DRIZZLE_CHARSET_BIG5_CHINESE_CI:
+  case DRIZZLE_CHARSET_BIG5_BIN:
+  case DRIZZLE_CHARSET_SJIS_JAPANESE_CI:
+  case DRIZZLE_CHARSET_SJIS_BIN:
+  case DRIZZLE_CHARSET_CP932_JAPANESE_CI:
+  case DRIZZLE_CHARSET_CP932_BIN:
+  case DRIZZLE_CHARSET_GBK_CHINESE_CI:
+  case DRIZZLE_CHARSET_GBK_BIN:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* Quote and escape a string literal for the connection charset and SQL mode
+ * into to, which must have room for size * 2 + 2 bytes. Multi-byte
+ * characters are copied whole so their trailing bytes are never escaped.
+ * The charset is the one agreed on in the handshake, a later SET NAMES is
+ * not seen by the client. */
+static size_t _quote_string(drizzle_st *con, char *to, const char *from,
+                            size_t size)
+{
+  const char *end= from + size;
+  char *start= to;
+  drizzle_charset_t charset= con->charset;
+  bool no_backslash_escapes= con->status & DRIZZLE_CON_STATUS_NO_BACKSLASH_ESCAPES;
+
+  *to++= '\'';
+  if (!no_backslash_escapes && !_charset_is_unsafe(charset))
+  {
+    to+= _escape_buffer(to, from, size, false);
+  }
+  else
+  {
+    while (from < end)
+    {
+      size_t char_size= _mb_char_size(charset, from, end);
+      if (char_size > 1)
       {
-        free(to);
-        *destination= NULL;
-        return -1;
+        memcpy(to, from, char_size);
+        to+= char_size;
       }
-
-      *to++= *from;
+      else if (no_backslash_escapes)
+      {
+        /* Backslashes are ordinary characters, quotes are doubled */
+        if (*from == '\'')
+        {
+          *to++= '\'';
+        }
+        *to++= *from;
+      }
+      else
+      {
+        to+= _escape_buffer(to, from, 1, false);
+      }
+      from+= char_size;
     }
-    to_size++;
   }
+  *to++= '\'';
 
-  *to= 0;
+  return (size_t)(to - start);
+}
+
+ssize_t drizzle_escape_str(drizzle_st *con, char **destination, const char *from, const size_t from_size, bool is_pattern)
+{
+  (void)con;
+  size_t to_size;
+
+  if (destination == NULL || from == NULL || from_size == 0)
+  {
+    return -1;
+  }
+
+  /* Every byte may need escaping, plus the terminating NUL. */
+  *destination= (char*) malloc(from_size * 2 + 1);
 
-  return to_size;
+  if (*destination == NULL)
+  {
+    return -1;
+  }
+
+  to_size= _escape_buffer(*destination, from, from_size, is_pattern);
+  (*destination)[to_size]= 0;
+
+  return (ssize_t)to_size;
 }
 
 ssize_t drizzle_escape_string(drizzle_st *con, char **destination, const char *from, const size_t from_size)
@@ -207,3 +323,1103 @@ bool drizzle_mysql_password_hash(char *to, const char *from, const size_t from_s
 
   return drizzle_hex_string(to, hash_tmp2, SHA1_DIGEST_LENGTH);
 }
+
+/*
+ * Query batch functions
+ */
+
+/* Check that size more bytes keep the row being built within a query of
+ * its own, so it can always be moved to the front of the buffer when the
+ * rows before it are sent. A row that cannot fit is dropped. */
+static drizzle_return_t _batch_check(drizzle_query_batch_st *batch,
+                                     size_t size)
+{
+  size_t row_size= 0;
+
+  if (batch->in_row)
+  {
+    row_size= batch->buffer_size - batch->row_start;
+    if (batch->row_count > 0)
+    {
+      row_size--;
+    }
+  }
+
+  if (batch->prefix_size + row_size + size > batch->max_size)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__,
+                      "row does not fit into the maximum query size of %zu",
+                      batch->max_size);
+    if (batch->in_row)
+    {
+      batch->buffer_size= batch->row_start;
+      batch->in_row= false;
+    }
+    return DRIZZLE_RETURN_TRUNCATED;
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Make room for size more bytes behind the buffered text */
+static drizzle_return_t _batch_grow(drizzle_query_batch_st *batch,
+                                    size_t size)
+{
+  size_t new_allocation;
+  char *new_buffer;
+
+  if (batch->buffer_size + size <= batch->buffer_allocation)
+  {
+    return DRIZZLE_RETURN_OK;
+  }
+
+  new_allocation= batch->buffer_allocation * 2;
+  if (new_allocation < batch->buffer_size + size)
+  {
+    new_allocation= batch->buffer_size + size;
+  }
+
+  new_buffer= (char *)realloc(batch->buffer, new_allocation);
+  if (new_buffer == NULL)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    return DRIZZLE_RETURN_MEMORY;
+  }
+
+  batch->buffer= new_buffer;
+  batch->buffer_allocation= new_allocation;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+static drizzle_return_t _batch_reserve(drizzle_query_batch_st *batch,
+                                       size_t size)
+{
+  drizzle_return_t ret;
+
+  ret= _batch_check(batch, size);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  return _batch_grow(batch, size);
+}
+
+static drizzle_return_t _batch_send(drizzle_query_batch_st *batch,
+                                    size_t size)
+{
+  drizzle_st *con= batch->con;
+  drizzle_result_st *result;
+  drizzle_return_t ret;
+
+  result= drizzle_query(con, batch->buffer, size, &ret);
+
+  /* The batch API is synchronous, finish the query on non-blocking
+   * connections before handing control back. */
+  while (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    ret= drizzle_wait(con);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      break;
+    }
+    ret= drizzle_state_loop(con);
+  }
+
+  if (ret == DRIZZLE_RETURN_OK)
+  {
+    batch->affected_rows+= drizzle_result_affected_rows(result);
+  }
+
+  drizzle_result_free(result);
+
+  return ret;
+}
+
+static drizzle_return_t _batch_value_begin(drizzle_query_batch_st *batch,
+                                           size_t size)
+{
+  drizzle_return_t ret;
+
+  if (batch == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (!batch->in_row)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__,
+                      "value added outside of a row");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  /* Room for the separator as well as the value itself. */
+  ret= _batch_reserve(batch, size + 1);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  if (batch->first_value)
+  {
+    batch->first_value= false;
+  }
+  else
+  {
+    batch->buffer[batch->buffer_size++]= ',';
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_query_batch_st *drizzle_query_batch_create(drizzle_st *con,
+                                                   const char *prefix,
+                                                   size_t prefix_size,
+                                                   drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_query_batch_st *batch;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (con == NULL || prefix == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (prefix_size == 0)
+  {
+    prefix_size= strlen(prefix);
+  }
+
+  batch= new (std::nothrow) drizzle_query_batch_st;
+  if (batch == NULL)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    return NULL;
+  }
+
+  batch->con= con;
+  batch->prefix_size= prefix_size;
+  batch->buffer_size= prefix_size;
+  batch->row_start= prefix_size;
+
+  /* A query is sent as a single packet, including the command byte. */
+  batch->max_size= drizzle_max_packet_size(con);
+  if (batch->max_size > DRIZZLE_MAX_PAYLOAD_SIZE)
+  {
+    batch->max_size= DRIZZLE_MAX_PAYLOAD_SIZE;
+  }
+  batch->max_size--;
+
+  if (prefix_size >= batch->max_size)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__,
+                      "prefix does not fit into the maximum query size");
+    delete batch;
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  batch->buffer_allocation= prefix_size + DRIZZLE_QUERY_BATCH_BUFFER_SIZE;
+  batch->buffer= (char *)malloc(batch->buffer_allocation);
+  if (batch->buffer == NULL)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    delete batch;
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    return NULL;
+  }
+
+  memcpy(batch->buffer, prefix, prefix_size);
+
+  *ret_ptr= DRIZZLE_RETURN_OK;
+  return batch;
+}
+
+drizzle_return_t drizzle_query_batch_set_max_packet_size(drizzle_query_batch_st *batch,
+                                                         uint32_t size)
+{
+  if (batch == NULL || size == 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (size > drizzle_max_packet_size(batch->con))
+  {
+    size= drizzle_max_packet_size(batch->con);
+  }
+  if (size > DRIZZLE_MAX_PAYLOAD_SIZE)
+  {
+    size= DRIZZLE_MAX_PAYLOAD_SIZE;
+  }
+
+  /* The pending rows must still fit, they are not split up. */
+  if ((size_t)size - 1 <= batch->prefix_size ||
+      (size_t)size - 1 < batch->buffer_size)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  batch->max_size= (size_t)size - 1;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_batch_row_begin(drizzle_query_batch_st *batch)
+{
+  drizzle_return_t ret;
+
+  if (batch == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (batch->in_row)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__,
+                      "previous row was not ended");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  ret= _batch_reserve(batch, 2);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  batch->row_start= batch->buffer_size;
+  batch->in_row= true;
+  batch->first_value= true;
+
+  if (batch->row_count > 0)
+  {
+    batch->buffer[batch->buffer_size++]= ',';
+  }
+  batch->buffer[batch->buffer_size++]= '(';
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_batch_add_string(drizzle_query_batch_st *batch,
+                                                const char *value,
+                                                size_t size)
+{
+  drizzle_return_t ret;
+  size_t quoted_size;
+  char *to;
+
+  if (value == NULL)
+  {
+    return drizzle_query_batch_add_null(batch);
+  }
+
+  if (batch == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  /* Quote into the free space behind the separator first, so the escaped
+   * size counts against the query size and not the worst case of every
+   * byte escaped, plus the quotes. */
+  ret= _batch_grow(batch, size * 2 + 3);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  to= batch->buffer + batch->buffer_size + (batch->first_value ? 0 : 1);
+  quoted_size= _quote_string(batch->con, to, value, size);
+
+  ret= _batch_value_begin(batch, quoted_size);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+  batch->buffer_size+= quoted_size;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_batch_add_literal(drizzle_query_batch_st *batch,
+                                                 const char *value,
+                                                 size_t size)
+{
+  drizzle_return_t ret;
+
+  if (value == NULL || size == 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  ret= _batch_value_begin(batch, size);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  memcpy(batch->buffer + batch->buffer_size, value, size);
+  batch->buffer_size+= size;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_batch_add_null(drizzle_query_batch_st *batch)
+{
+  return drizzle_query_batch_add_literal(batch, "NULL", 4);
+}
+
+drizzle_return_t drizzle_query_batch_add_int64(drizzle_query_batch_st *batch,
+                                               int64_t value)
+{
+  char buffer[21];
+  size_t size= integer_format(buffer, (uint64_t)value, false);
+
+  return drizzle_query_batch_add_literal(batch, buffer, size);
+}
+
+drizzle_return_t drizzle_query_batch_add_uint64(drizzle_query_batch_st *batch,
+                                                uint64_t value)
+{
+  char buffer[21];
+  size_t size= integer_format(buffer, value, true);
+
+  return drizzle_query_batch_add_literal(batch, buffer, size);
+}
+
+drizzle_return_t drizzle_query_batch_row_end(drizzle_query_batch_st *batch)
+{
+  drizzle_return_t ret;
+  size_t row_size;
+
+  if (batch == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (!batch->in_row)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__, "no row was begun");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  ret= _batch_reserve(batch, 1);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  batch->buffer[batch->buffer_size++]= ')';
+  batch->in_row= false;
+
+  if (batch->buffer_size <= batch->max_size)
+  {
+    batch->row_count++;
+    return DRIZZLE_RETURN_OK;
+  }
+
+  /* The new row pushed the query over the limit: send the rows before it
+   * and keep the new row as the first one of the next query. */
+  ret= _batch_send(batch, batch->row_start);
+
+  row_size= batch->buffer_size - batch->row_start - 1;
+  memmove(batch->buffer + batch->prefix_size,
+          batch->buffer + batch->row_start + 1, row_size);
+  batch->buffer_size= batch->prefix_size + row_size;
+  batch->row_start= batch->prefix_size;
+  batch->row_count= 1;
+
+  return ret;
+}
+
+drizzle_return_t drizzle_query_batch_flush(drizzle_query_batch_st *batch)
+{
+  drizzle_return_t ret;
+
+  if (batch == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (batch->in_row)
+  {
+    drizzle_set_error(batch->con, __FILE_LINE_FUNC__,
+                      "cannot flush while a row is being built");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (batch->row_count == 0)
+  {
+    return DRIZZLE_RETURN_OK;
+  }
+
+  ret= _batch_send(batch, batch->buffer_size);
+
+  batch->buffer_size= batch->prefix_size;
+  batch->row_start= batch->prefix_size;
+  batch->row_count= 0;
+
+  return ret;
+}
+
+uint32_t drizzle_query_batch_row_count(const drizzle_query_batch_st *batch)
+{
+  if (batch == NULL)
+  {
+    return 0;
+  }
+
+  return batch->row_count;
+}
+
+uint64_t drizzle_query_batch_affected_rows(const drizzle_query_batch_st *batch)
+{
+  if (batch == NULL)
+  {
+    return 0;
+  }
+
+  return batch->affected_rows;
+}
+
+void drizzle_query_batch_free(drizzle_query_batch_st *batch)
+{
+  if (batch == NULL)
+  {
+    return;
+  }
+
+  free(batch->buffer);
+  delete batch;
+}
+
+/*
+ * Query template functions
+ */
+
+/* Find the ? placeholders outside of quotes, identifiers and comments.
+ * Stores their offsets if offsets is not NULL and returns their number. */
+static size_t _template_scan(const char *text, size_t size, size_t *offsets)
+{
+  size_t count= 0;
+  size_t x= 0;
+
+  while (x < size)
+  {
+    char c= text[x];
+
+    if (c == '\'' || c == '"' || c == '`')
+    {
+      /* A doubled quote closes and reopens the literal */
+      for (x++; x < size && text[x] != c; x++)
+      {
+        if (text[x] == '\\' && c != '`')
+        {
+          x++;
+        }
+      }
+    }
+    else if (c == '#' ||
+             (c == '-' && x + 1 < size && text[x + 1] == '-' &&
+              (x + 2 == size || isspace((unsigned char)text[x + 2]))))
+    {
+      while (x < size && text[x] != '\n')
+      {
+        x++;
+      }
+    }
+    else if (c == '/' && x + 1 < size && text[x + 1] == '*')
+    {
+      for (x+= 2; x + 1 < size && !(text[x] == '*' && text[x + 1] == '/'); x++)
+      { }
+      x++;
+    }
+    else if (c == '?')
+    {
+      if (offsets != NULL)
+      {
+        offsets[count]= x;
+      }
+      count++;
+    }
+    x++;
+  }
+
+  return count;
+}
+
+/* Make room for size more bytes of parameter values. When the buffer is
+ * full the values still set are copied to a new one, dropping the values
+ * which have been replaced since. */
+static drizzle_return_t _template_reserve(drizzle_query_template_st *query_template,
+                                          size_t size)
+{
+  size_t live_size= 0;
+  size_t allocation;
+  char *values;
+
+  if (query_template->values_size + size <= query_template->values_allocation)
+  {
+    return DRIZZLE_RETURN_OK;
+  }
+
+  for (uint16_t x= 0; x < query_template->param_count; x++)
+  {
+    if (query_template->value_sizes[x] != SIZE_MAX)
+    {
+      live_size+= query_template->value_sizes[x];
+    }
+  }
+
+  /* Only grow if the values still set leave no room */
+  allocation= query_template->values_allocation;
+  while (allocation < live_size + size)
+  {
+    allocation*= 2;
+  }
+
+  values= (char *)malloc(allocation);
+  if (values == NULL)
+  {
+    drizzle_set_error(query_template->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    return DRIZZLE_RETURN_MEMORY;
+  }
+
+  query_template->values_size= 0;
+  for (uint16_t x= 0; x < query_template->param_count; x++)
+  {
+    if (query_template->value_sizes[x] != SIZE_MAX)
+    {
+      memcpy(values + query_template->values_size,
+             query_template->values + query_template->value_offsets[x],
+             query_template->value_sizes[x]);
+      query_template->value_offsets[x]= query_template->values_size;
+      query_template->values_size+= query_template->value_sizes[x];
+    }
+  }
+
+  free(query_template->values);
+  query_template->values= values;
+  query_template->values_allocation= allocation;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Reserve room for a value of at most size bytes and return where to write
+ * it, or NULL on error. _template_value_end() records it. */
+static char *_template_value_begin(drizzle_query_template_st *query_template,
+                                   uint16_t param, size_t size,
+                                   drizzle_return_t *ret_ptr)
+{
+  if (query_template == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (param >= query_template->param_count)
+  {
+    drizzle_set_error(query_template->con, __FILE_LINE_FUNC__,
+                      "parameter %" PRIu16 " does not exist", param);
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  /* Not set while it is being written, so growing skips it */
+  query_template->value_sizes[param]= SIZE_MAX;
+  *ret_ptr= _template_reserve(query_template, size);
+  if (*ret_ptr != DRIZZLE_RETURN_OK)
+  {
+    return NULL;
+  }
+
+  return query_template->values + query_template->values_size;
+}
+
+static void _template_value_end(drizzle_query_template_st *query_template,
+                                uint16_t param, size_t size)
+{
+  query_template->value_offsets[param]= query_template->values_size;
+  query_template->value_sizes[param]= size;
+  query_template->values_size+= size;
+}
+
+drizzle_query_template_st *drizzle_query_template_create(drizzle_st *con,
+                                                         const char *query,
+                                                         size_t size,
+                                                         drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_query_template_st *query_template;
+  size_t param_count;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (con == NULL || query == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (size == 0)
+  {
+    size= strlen(query);
+    if (size == 0)
+    {
+      *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+      return NULL;
+    }
+  }
+
+  param_count= _template_scan(query, size, NULL);
+  if (param_count > UINT16_MAX)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "too many parameters");
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  query_template= new (std::nothrow) drizzle_query_template_st;
+  if (query_template == NULL)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    return NULL;
+  }
+
+  query_template->con= con;
+  query_template->param_count= (uint16_t)param_count;
+  query_template->text_size= size;
+  query_template->text= (char *)malloc(size);
+  query_template->param_offsets= new (std::nothrow) size_t[param_count + 1];
+  query_template->value_offsets= new (std::nothrow) size_t[param_count + 1];
+  query_template->value_sizes= new (std::nothrow) size_t[param_count + 1];
+  query_template->values_allocation= DRIZZLE_QUERY_TEMPLATE_VALUES_SIZE;
+  query_template->values= (char *)malloc(query_template->values_allocation);
+  if (query_template->text == NULL || query_template->param_offsets == NULL ||
+      query_template->value_offsets == NULL ||
+      query_template->value_sizes == NULL || query_template->values == NULL)
+  {
+    drizzle_query_template_free(query_template);
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    return NULL;
+  }
+
+  memcpy(query_template->text, query, size);
+  _template_scan(query, size, query_template->param_offsets);
+  for (uint16_t x= 0; x < query_template->param_count; x++)
+  {
+    query_template->value_sizes[x]= SIZE_MAX;
+  }
+
+  *ret_ptr= DRIZZLE_RETURN_OK;
+  return query_template;
+}
+
+uint16_t drizzle_query_template_param_count(const drizzle_query_template_st *query_template)
+{
+  if (query_template == NULL)
+  {
+    return 0;
+  }
+
+  return query_template->param_count;
+}
+
+drizzle_return_t drizzle_query_template_set_string(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   const char *value,
+                                                   size_t size)
+{
+  drizzle_return_t ret;
+  char *to;
+
+  if (value == NULL)
+  {
+    return drizzle_query_template_set_null(query_template, param);
+  }
+
+  /* Worst case every byte is escaped, plus the quotes. */
+  to= _template_value_begin(query_template, param, size * 2 + 2, &ret);
+  if (to == NULL)
+  {
+    return ret;
+  }
+
+  _template_value_end(query_template, param,
+                      _quote_string(query_template->con, to, value, size));
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_template_set_binary(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   const unsigned char *value,
+                                                   size_t size)
+{
+  drizzle_return_t ret;
+  char *to;
+
+  if (value == NULL)
+  {
+    return drizzle_query_template_set_null(query_template, param);
+  }
+
+  /* X'' plus two digits per byte and the NUL drizzle_hex_string() adds */
+  to= _template_value_begin(query_template, param, size * 2 + 4, &ret);
+  if (to == NULL)
+  {
+    return ret;
+  }
+
+  to[0]= 'X';
+  to[1]= '\'';
+  if (size > 0)
+  {
+    drizzle_hex_string(to + 2, value, size);
+  }
+  to[size * 2 + 2]= '\'';
+  _template_value_end(query_template, param, size * 2 + 3);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_template_set_literal(drizzle_query_template_st *query_template,
+                                                    uint16_t param,
+                                                    const char *value,
+                                                    size_t size)
+{
+  drizzle_return_t ret;
+  char *to;
+
+  if (value == NULL || size == 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  to= _template_value_begin(query_template, param, size, &ret);
+  if (to == NULL)
+  {
+    return ret;
+  }
+
+  memcpy(to, value, size);
+  _template_value_end(query_template, param, size);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_query_template_set_null(drizzle_query_template_st *query_template,
+                                                 uint16_t param)
+{
+  return drizzle_query_template_set_literal(query_template, param, "NULL", 4);
+}
+
+drizzle_return_t drizzle_query_template_set_int64(drizzle_query_template_st *query_template,
+                                                  uint16_t param,
+                                                  int64_t value)
+{
+  char buffer[21];
+  size_t size= integer_format(buffer, (uint64_t)value, false);
+
+  return drizzle_query_template_set_literal(query_template, param, buffer, size);
+}
+
+drizzle_return_t drizzle_query_template_set_uint64(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   uint64_t value)
+{
+  char buffer[21];
+  size_t size= integer_format(buffer, value, true);
+
+  return drizzle_query_template_set_literal(query_template, param, buffer, size);
+}
+
+drizzle_return_t drizzle_query_template_set_double(drizzle_query_template_st *query_template,
+                                                   uint16_t param,
+                                                   double value)
+{
+  char buffer[32];
+  size_t size;
+
+  /* SQL has no literals for these */
+  if (!isfinite(value))
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  size= double_format(buffer, value, false);
+
+  return drizzle_query_template_set_literal(query_template, param, buffer, size);
+}
+
+/* Get the size of the query with every placeholder replaced by its value,
+ * or SIZE_MAX if a parameter has not been set */
+static size_t _template_query_size(drizzle_query_template_st *query_template)
+{
+  size_t query_size= query_template->text_size - query_template->param_count;
+
+  for (uint16_t x= 0; x < query_template->param_count; x++)
+  {
+    if (query_template->value_sizes[x] == SIZE_MAX)
+    {
+      drizzle_set_error(query_template->con, __FILE_LINE_FUNC__,
+                        "parameter %" PRIu16 " has not been set", x);
+      return SIZE_MAX;
+    }
+    query_size+= query_template->value_sizes[x];
+  }
+
+  return query_size;
+}
+
+/* Copy the text of the query with the values of its parameters to to, which
+ * must have room for _template_query_size() bytes */
+static void _template_pack(const drizzle_query_template_st *query_template,
+                           char *to)
+{
+  size_t text_offset= 0;
+
+  for (uint16_t x= 0; x < query_template->param_count; x++)
+  {
+    size_t segment= query_template->param_offsets[x] - text_offset;
+    memcpy(to, query_template->text + text_offset, segment);
+    to+= segment;
+    memcpy(to, query_template->values + query_template->value_offsets[x],
+           query_template->value_sizes[x]);
+    to+= query_template->value_sizes[x];
+    text_offset= query_template->param_offsets[x] + 1;
+  }
+  memcpy(to, query_template->text + text_offset,
+         query_template->text_size - text_offset);
+}
+
+const char *drizzle_query_template_build(drizzle_query_template_st *query_template,
+                                         size_t *size,
+                                         drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  size_t query_size;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (query_template == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (query_template->pending)
+  {
+    drizzle_set_error(query_template->con, __FILE_LINE_FUNC__,
+                      "the query is still being sent");
+    *ret_ptr= DRIZZLE_RETURN_NOT_READY;
+    return NULL;
+  }
+
+  query_size= _template_query_size(query_template);
+  if (query_size == SIZE_MAX)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (query_size + 1 > query_template->buffer_allocation)
+  {
+    char *buffer= (char *)realloc(query_template->buffer, query_size + 1);
+    if (buffer == NULL)
+    {
+      drizzle_set_error(query_template->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      *ret_ptr= DRIZZLE_RETURN_MEMORY;
+      return NULL;
+    }
+    query_template->buffer= buffer;
+    query_template->buffer_allocation= query_size + 1;
+  }
+
+  _template_pack(query_template, query_template->buffer);
+  query_template->buffer[query_size]= '\0';
+  query_template->buffer_size= query_size;
+
+  if (size != NULL)
+  {
+    *size= query_size;
+  }
+  *ret_ptr= DRIZZLE_RETURN_OK;
+  return query_template->buffer;
+}
+
+/* Send the query packed straight into the connection buffer by
+ * drizzle_state_query_template_write(), otherwise the same as
+ * drizzle_query() */
+static drizzle_result_st *_template_send(drizzle_query_template_st *query_template,
+                                         drizzle_return_t *ret_ptr)
+{
+  drizzle_st *con= query_template->con;
+
+  if (!query_template->pending)
+  {
+    con->result= drizzle_result_create(con);
+    if (con->result == NULL)
+    {
+      *ret_ptr= DRIZZLE_RETURN_MEMORY;
+      return NULL;
+    }
+
+    con->query_template= query_template;
+    con->command= DRIZZLE_COMMAND_QUERY;
+    con->push_state(drizzle_state_result_read);
+    con->push_state(drizzle_state_packet_read);
+    con->push_state(drizzle_state_query_template_write);
+  }
+
+  *ret_ptr= drizzle_state_loop(con);
+  if (*ret_ptr != DRIZZLE_RETURN_OK &&
+      *ret_ptr != DRIZZLE_RETURN_IO_WAIT &&
+      *ret_ptr != DRIZZLE_RETURN_ERROR_CODE)
+  {
+    drizzle_result_free(con->result);
+    con->result= NULL;
+  }
+
+  return con->result;
+}
+
+drizzle_result_st *drizzle_query_template_execute(drizzle_query_template_st *query_template,
+                                                  drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_result_st *result;
+  drizzle_st *con;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (query_template == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  /* Continuing after IO_WAIT sends the query started before. A query which
+   * fits into the connection buffer is packed into it directly, others are
+   * built first and sent like drizzle_query() does. */
+  con= query_template->con;
+  if (!query_template->pending)
+  {
+    query_template->query_size= _template_query_size(query_template);
+    if (query_template->query_size == SIZE_MAX)
+    {
+      *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+      return NULL;
+    }
+
+    query_template->packed= con->state.ready && con->has_state() &&
+                            !con->state.raw_packet &&
+                            5 + query_template->query_size <= con->buffer_allocation &&
+                            1 + query_template->query_size <= DRIZZLE_MAX_PAYLOAD_SIZE;
+    if (!query_template->packed &&
+        drizzle_query_template_build(query_template, NULL, ret_ptr) == NULL)
+    {
+      return NULL;
+    }
+  }
+
+  if (query_template->packed)
+  {
+    result= _template_send(query_template, ret_ptr);
+  }
+  else
+  {
+    result= drizzle_query(con, query_template->buffer,
+                          query_template->buffer_size, ret_ptr);
+  }
+  query_template->pending= (*ret_ptr == DRIZZLE_RETURN_IO_WAIT);
+
+  return result;
+}
+
+drizzle_return_t drizzle_state_query_template_write(drizzle_st *con)
+{
+  drizzle_query_template_st *query_template;
+  unsigned char *start;
+  unsigned char *end;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  __LOG_LOCATION__
+
+  query_template= con->query_template;
+
+  if (con->buffer_size == 0)
+  {
+    con->buffer_ptr= con->buffer;
+  }
+
+  if (con->stmt_close_count > 0)
+  {
+    start= con->buffer_ptr + con->buffer_size;
+    if ((size_t)(start - con->buffer) + DRIZZLE_STMT_CLOSE_PACKET_SIZE * con->stmt_close_count <= con->buffer_allocation)
+    {
+      end= drizzle_stmt_close_pending(con, start,
+                                      con->buffer_allocation - (size_t)(start - con->buffer));
+      con->buffer_size+= (size_t)(end - start);
+    }
+  }
+
+  /* The query always fits into an empty buffer, try again once the closes
+   * in front of it are written */
+  start= con->buffer_ptr + con->buffer_size;
+  if ((size_t)(start - con->buffer) + 5 + query_template->query_size > con->buffer_allocation)
+  {
+    con->push_state(drizzle_state_write);
+    return DRIZZLE_RETURN_OK;
+  }
+
+  drizzle_set_byte3(start, 1 + query_template->query_size);
+  start[3]= 0;
+  start[4]= (unsigned char)DRIZZLE_COMMAND_QUERY;
+  _template_pack(query_template, (char *)start + 5);
+  con->buffer_size+= 5 + query_template->query_size;
+  con->packet_number= 1;
+  con->query_template= NULL;
+
+  con->pop_state();
+  con->push_state(drizzle_state_write);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+void drizzle_query_template_free(drizzle_query_template_st *query_template)
+{
+  if (query_template == NULL)
+  {
+    return;
+  }
+
+  free(query_template->text);
+  free(query_template->values);
+  free(query_template->buffer);
+  delete[] query_template->param_offsets;
+  delete[] query_template->value_offsets;
+  delete[] query_template->value_sizes;
+  delete query_template;
+}
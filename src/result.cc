@@ -44,6 +44,13 @@
 #include "config.h"
 #include "src/common.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
+#if !defined(_WIN32) && !defined(__MINGW32__)
+# include <sys/mman.h>
+#endif
+
 /*
  * Common definitions
  */
@@ -75,46 +82,54 @@ drizzle_result_st *drizzle_result_create(drizzle_st *con)
   return result;
 }
 
-void drizzle_result_free(drizzle_result_st *result)
+/* Free the columns and rows of a result */
+static void _result_free_data(drizzle_result_st *result)
 {
   drizzle_column_st* column;
   int64_t y;
 
-  if (result == NULL)
-  {
-    return;
-  }
-
   for (column= result->column_list; column != NULL; column= result->column_list)
   {
     drizzle_column_free(column);
   }
 
   delete[] result->column_buffer;
+  delete[] result->column_index;
 
-  if (result->options & DRIZZLE_RESULT_BUFFER_ROW)
+  while (result->row_chunks != NULL)
   {
-    uint64_t x;
+    drizzle_result_chunk_st *chunk= result->row_chunks;
+    result->row_chunks= chunk->next;
+    delete[] (char *)chunk;
+  }
+#if !defined(_WIN32) && !defined(__MINGW32__)
+  if (result->spill_map != NULL)
+  {
+    munmap(result->spill_map, (size_t)result->spill_map_size);
+  }
+  if (result->spill_fd != -1)
+  {
+    close(result->spill_fd);
+  }
+#endif
+  free(result->spill_index);
+  delete[] (char *)result->spill_record;
+  free(result->row_list);
 
-    for (x= 0; x < result->row_count; x++)
-    {
-      for (y= 0; y < (result->column_count - result->null_bitcount); y++)
-      {
-        delete[] result->row_list[x][y];
-      }
-      delete[] result->row_list[x];
-      if (result->null_bitmap_list != NULL)
-      {
-        delete[] result->null_bitmap_list[x];
-      }
-      delete[] result->field_sizes_list[x];
-    }
-    if (result->null_bitmap_list != NULL)
+  if (result->vectors != NULL)
+  {
+    for (y= 0; y < result->column_count; y++)
     {
-      free(result->null_bitmap_list);
+      drizzle_vector_free(&result->vectors[y]);
     }
-    free(result->row_list);
-    free(result->field_sizes_list);
+    delete[] result->vectors;
+  }
+
+  /* Until the rows are buffered these belong to the current row */
+  if (!(result->options & DRIZZLE_RESULT_BUFFER_ROW))
+  {
+    delete[] result->field_sizes;
+    delete[] result->null_bitmap;
   }
 
   if (result->field_buffer)
@@ -127,6 +142,32 @@ void drizzle_result_free(drizzle_result_st *result)
     delete[] result->field_buffer_sizes;
   }
   delete[] result->row;
+  delete[] result->field_views;
+  delete[] result->batch_views;
+}
+
+void drizzle_result_reset(drizzle_result_st *result)
+{
+  drizzle_st *con= result->con;
+  drizzle_result_st *next= result->next;
+  drizzle_result_st *prev= result->prev;
+
+  _result_free_data(result);
+
+  *result= drizzle_result_st();
+  result->con= con;
+  result->next= next;
+  result->prev= prev;
+}
+
+void drizzle_result_free(drizzle_result_st *result)
+{
+  if (result == NULL)
+  {
+    return;
+  }
+
+  _result_free_data(result);
 
   if (result->con)
   {
@@ -296,6 +337,375 @@ drizzle_result_st *drizzle_result_read(drizzle_st *con,
   return con->result;
 }
 
+#if !defined(_WIN32) && !defined(__MINGW32__)
+/* Allocate the blocks of length bytes of fd from offset on, returning 0 or
+ * an errno value as posix_fallocate() does. Without it, as on macOS, the
+ * blocks are reserved with F_PREALLOCATE or else written with zeros. */
+static int _result_file_reserve(int fd, off_t offset, off_t length)
+{
+#ifdef HAVE_POSIX_FALLOCATE
+  return posix_fallocate(fd, offset, length);
+#elif defined(F_PREALLOCATE)
+  fstore_t store;
+
+  memset(&store, 0, sizeof(store));
+  store.fst_flags= F_ALLOCATECONTIG;
+  store.fst_posmode= F_PEOFPOSMODE;
+  store.fst_length= length;
+  if (fcntl(fd, F_PREALLOCATE, &store) == -1)
+  {
+    store.fst_flags= F_ALLOCATEALL;
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1)
+    {
+      return errno;
+    }
+  }
+
+  if (ftruncate(fd, offset + length) == -1)
+  {
+    return errno;
+  }
+
+  return 0;
+#else
+  static const char zeros[4096]= { 0 };
+
+  while (length > 0)
+  {
+    size_t size= length < (off_t)sizeof(zeros) ? (size_t)length : sizeof(zeros);
+    ssize_t written= pwrite(fd, zeros, size, offset);
+    if (written == -1)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      return errno;
+    }
+    offset+= written;
+    length-= written;
+  }
+
+  return 0;
+#endif
+}
+
+/* Grow the spill file to at least size bytes and map all of it, creating
+ * the file first. The file grows by a quarter at a time and stays one
+ * mapping, which moves with mremap() where there is one, so records are
+ * found by their offset in the file. Its blocks are allocated up front, so
+ * that a full disk is an error here and not a SIGBUS when rows are
+ * written. */
+static drizzle_return_t _result_spill_grow(drizzle_result_st *result,
+                                           uint64_t size)
+{
+  uint64_t page_size= (uint64_t)sysconf(_SC_PAGESIZE);
+  uint64_t map_size;
+  void *map;
+  int error;
+
+  if (result->spill_fd == -1)
+  {
+    const char *dir= getenv("TMPDIR");
+    char path[PATH_MAX];
+
+    if (dir == NULL || dir[0] == 0)
+    {
+      dir= "/tmp";
+    }
+    snprintf(path, sizeof(path), "%s/libdrizzle-XXXXXX", dir);
+
+#ifdef HAVE_MKOSTEMP
+    result->spill_fd= mkostemp(path, O_CLOEXEC);
+#else
+    result->spill_fd= mkstemp(path);
+    if (result->spill_fd != -1)
+    {
+      fcntl(result->spill_fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+    if (result->spill_fd == -1)
+    {
+      error= errno;
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                        "mkostemp:%s", strerror(error));
+      result->con->last_errno= error;
+      return DRIZZLE_RETURN_ERRNO;
+    }
+    unlink(path);
+  }
+
+  map_size= result->spill_map_size + result->spill_map_size / 4;
+  if (map_size < result->spill_map_size + DRIZZLE_RESULT_CHUNK_SIZE)
+  {
+    map_size= result->spill_map_size + DRIZZLE_RESULT_CHUNK_SIZE;
+  }
+  if (map_size < size)
+  {
+    map_size= size;
+  }
+  map_size= (map_size + page_size - 1) & ~(page_size - 1);
+  if (map_size > SIZE_MAX)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "mmap:%s", strerror(ENOMEM));
+    result->con->last_errno= ENOMEM;
+    return DRIZZLE_RETURN_ERRNO;
+  }
+
+  error= _result_file_reserve(result->spill_fd, (off_t)result->spill_map_size,
+                              (off_t)(map_size - result->spill_map_size));
+  if (error != 0)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "fallocate:%s", strerror(error));
+    result->con->last_errno= error;
+    return DRIZZLE_RETURN_ERRNO;
+  }
+
+#ifdef HAVE_MREMAP
+  if (result->spill_map != NULL)
+  {
+    map= mremap(result->spill_map, (size_t)result->spill_map_size,
+                (size_t)map_size, MREMAP_MAYMOVE);
+  }
+  else
+#endif
+  {
+    map= mmap(NULL, (size_t)map_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+              result->spill_fd, 0);
+  }
+  if (map == MAP_FAILED)
+  {
+    error= errno;
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "mmap:%s", strerror(error));
+    result->con->last_errno= error;
+    return DRIZZLE_RETURN_ERRNO;
+  }
+#ifndef HAVE_MREMAP
+  if (result->spill_map != NULL)
+  {
+    munmap(result->spill_map, (size_t)result->spill_map_size);
+  }
+#endif
+  result->spill_map= (char *)map;
+  result->spill_map_size= map_size;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Reserve size bytes at the end of the spill file, aligned for its 64 bit
+ * field sizes and offsets */
+static drizzle_return_t _result_spill_alloc(drizzle_result_st *result,
+                                            uint64_t size,
+                                            uint64_t *offset_ptr)
+{
+  uint64_t offset= (result->spill_size + sizeof(uint64_t) - 1) &
+                   ~(uint64_t)(sizeof(uint64_t) - 1);
+  drizzle_return_t ret;
+
+  if (offset + size > result->spill_map_size)
+  {
+    ret= _result_spill_grow(result, offset + size);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+  }
+
+  result->spill_size= offset + size;
+  *offset_ptr= offset;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Append the current row to the spill file. A file record holds the 64 bit
+ * field sizes, the NULL bitmap of binary rows and then the terminated field
+ * values. The file offsets of the records are kept in index blocks of
+ * DRIZZLE_ROW_GROW_SIZE rows in the file as well, only the offsets of the
+ * blocks are on the heap. */
+static drizzle_return_t _result_spill_row(drizzle_result_st *result,
+                                          drizzle_row_t row,
+                                          size_t bitmap_size,
+                                          size_t data_size)
+{
+  uint64_t entry= result->row_current - 1 - result->spill_row;
+  size_t block= (size_t)(entry / DRIZZLE_ROW_GROW_SIZE);
+  uint64_t offset;
+  uint64_t *sizes;
+  char *data;
+  uint16_t x;
+  drizzle_return_t ret;
+
+  if (entry % DRIZZLE_ROW_GROW_SIZE == 0)
+  {
+    if (block == result->spill_index_size)
+    {
+      size_t new_index_size= result->spill_index_size > 0 ? result->spill_index_size * 2 : 16;
+      uint64_t *spill_index= (uint64_t *)realloc(result->spill_index, sizeof(uint64_t) * new_index_size);
+      if (spill_index == NULL)
+      {
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to realloc spill_index.");
+        return DRIZZLE_RETURN_MEMORY;
+      }
+      result->spill_index= spill_index;
+      result->spill_index_size= new_index_size;
+    }
+
+    ret= _result_spill_alloc(result, sizeof(uint64_t) * DRIZZLE_ROW_GROW_SIZE,
+                             &result->spill_index[block]);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+  }
+
+  ret= _result_spill_alloc(result, sizeof(uint64_t) * result->column_count +
+                                   bitmap_size + data_size, &offset);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+  ((uint64_t *)(result->spill_map + result->spill_index[block]))[entry % DRIZZLE_ROW_GROW_SIZE]= offset;
+
+  sizes= (uint64_t *)(result->spill_map + offset);
+  data= (char *)(sizes + result->column_count);
+  if (bitmap_size > 0)
+  {
+    memcpy(data, result->null_bitmap, bitmap_size);
+    data+= bitmap_size;
+  }
+
+  for (x= 0; x < result->column_count; x++)
+  {
+    sizes[x]= result->field_sizes[x];
+    if (sizes[x] > 0)
+    {
+      memcpy(data, row[x], sizes[x]);
+      data[sizes[x]]= 0;
+      data+= sizes[x] + 1;
+    }
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+#endif
+
+/* Whether a record of size bytes fits in the chunk being filled, or in a
+ * new chunk within the spill limit of the result */
+static bool _result_chunk_fits(drizzle_result_st *result, size_t size)
+{
+  drizzle_result_chunk_st *chunk= result->row_chunks;
+  size_t chunk_size= DRIZZLE_RESULT_CHUNK_SIZE;
+
+  if (chunk != NULL)
+  {
+    size_t offset= (chunk->used + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    if (offset <= chunk->size && size <= chunk->size - offset)
+    {
+      return true;
+    }
+  }
+
+  if (size > chunk_size)
+  {
+    chunk_size= size;
+  }
+
+  return sizeof(drizzle_result_chunk_st) + chunk_size <=
+         result->spill_limit - result->chunk_memory;
+}
+
+/* Reserve size bytes of row storage aligned for field pointers. Rows are
+ * packed into DRIZZLE_RESULT_CHUNK_SIZE chunks, larger rows get their own
+ * chunk behind the one being filled. */
+static char *_result_chunk_alloc(drizzle_result_st *result, size_t size,
+                                 drizzle_return_t *ret_ptr)
+{
+  drizzle_result_chunk_st *chunk= result->row_chunks;
+  size_t chunk_size= DRIZZLE_RESULT_CHUNK_SIZE;
+
+  if (chunk != NULL)
+  {
+    size_t offset= (chunk->used + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1);
+    if (offset <= chunk->size && size <= chunk->size - offset)
+    {
+      chunk->used= offset + size;
+      return (char *)(chunk + 1) + offset;
+    }
+  }
+
+  if (size > chunk_size)
+  {
+    chunk_size= size;
+  }
+
+  chunk= (drizzle_result_chunk_st *)new (std::nothrow) char[sizeof(drizzle_result_chunk_st) + chunk_size];
+  if (chunk == NULL)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    return NULL;
+  }
+  result->chunk_memory+= sizeof(drizzle_result_chunk_st) + chunk_size;
+  chunk->size= chunk_size;
+  chunk->used= size;
+
+  if (chunk_size > DRIZZLE_RESULT_CHUNK_SIZE && result->row_chunks != NULL)
+  {
+    chunk->next= result->row_chunks->next;
+    result->row_chunks->next= chunk;
+  }
+  else
+  {
+    chunk->next= result->row_chunks;
+    result->row_chunks= chunk;
+  }
+
+  return (char *)(chunk + 1);
+}
+
+drizzle_row_t drizzle_result_row(drizzle_result_st *result, uint64_t row_number)
+{
+#if !defined(_WIN32) && !defined(__MINGW32__)
+  if (row_number >= result->spill_row)
+  {
+    uint64_t entry= row_number - result->spill_row;
+    const uint64_t *block= (const uint64_t *)(result->spill_map + result->spill_index[entry / DRIZZLE_ROW_GROW_SIZE]);
+    const uint64_t *sizes= (const uint64_t *)(result->spill_map + block[entry % DRIZZLE_ROW_GROW_SIZE]);
+    char *data= (char *)(sizes + result->column_count);
+    size_t *field_sizes= result->row_field_sizes(result->spill_record);
+    uint16_t x;
+
+    if (result->binary_rows)
+    {
+      memcpy(result->row_null_bitmap(result->spill_record), data,
+             result->null_bitmap_length);
+      data+= result->null_bitmap_length;
+    }
+
+    for (x= 0; x < result->column_count; x++)
+    {
+      field_sizes[x]= (size_t)sizes[x];
+      if (sizes[x] > 0)
+      {
+        result->spill_record[x]= data;
+        data+= sizes[x] + 1;
+      }
+      else
+      {
+        result->spill_record[x]= NULL;
+      }
+    }
+
+    return result->spill_record;
+  }
+#endif
+
+  return result->row_list[row_number];
+}
+
 drizzle_return_t drizzle_result_buffer(drizzle_result_st *result)
 {
   if (result == NULL)
@@ -306,7 +716,6 @@ drizzle_return_t drizzle_result_buffer(drizzle_result_st *result)
   drizzle_return_t ret;
   drizzle_row_t row;
   drizzle_row_t *row_list;
-  size_t **field_sizes_list;
 
   if (!(result->options & DRIZZLE_RESULT_BUFFER_COLUMN))
   {
@@ -324,6 +733,14 @@ drizzle_return_t drizzle_result_buffer(drizzle_result_st *result)
   while (1)
   {
     uint16_t x;
+    size_t bitmap_size;
+    size_t data_size;
+    size_t record_size;
+    char *record;
+    drizzle_field_t *fields;
+    size_t *sizes;
+    char *data;
+
     row= drizzle_row_buffer(result, &ret);
     if (ret != DRIZZLE_RETURN_OK)
       return ret;
@@ -331,94 +748,579 @@ drizzle_return_t drizzle_result_buffer(drizzle_result_st *result)
     if (row == NULL)
       break;
 
-    if (result->row_list_size < result->row_count)
+    /* A heap record holds the field pointers, the field sizes, the NULL
+     * bitmap of binary rows and then the terminated field values */
+    bitmap_size= result->binary_rows ? result->null_bitmap_length : 0;
+    data_size= 0;
+    for (x= 0; x < result->column_count; x++)
     {
-      size_t new_row_list_size = result->row_list_size + DRIZZLE_ROW_GROW_SIZE;
+      if (result->field_sizes[x] > 0)
+      {
+        data_size+= result->field_sizes[x] + 1;
+      }
+    }
+    record_size= (sizeof(drizzle_field_t) + sizeof(size_t)) * result->column_count +
+                 bitmap_size + data_size;
 
-      row_list= (drizzle_row_t *)realloc(result->row_list, sizeof(drizzle_row_t) * new_row_list_size);
-      if (row_list == NULL)
+#if !defined(_WIN32) && !defined(__MINGW32__)
+    /* Once a row is beyond the spill limit, it and every later row go to
+     * the file */
+    if (result->spill_record == NULL && !_result_chunk_fits(result, record_size))
+    {
+      result->spill_record= (drizzle_row_t)new (std::nothrow) char[record_size - data_size];
+      if (result->spill_record == NULL)
       {
         drizzle_row_free(result, row);
-        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to realloc row_list.");
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
         return DRIZZLE_RETURN_MEMORY;
       }
-      result->row_list= row_list;
+      result->spill_row= result->row_current - 1;
+    }
+
+    if (result->spill_record != NULL)
+    {
+      ret= _result_spill_row(result, row, bitmap_size, data_size);
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        drizzle_row_free(result, row);
+        return ret;
+      }
+      continue;
+    }
+#endif
 
-      if (result->binary_rows)
+    if (result->row_list_size < result->row_count)
+    {
+      size_t new_row_list_size= result->row_list_size * 2;
+      if (new_row_list_size == 0)
       {
-        uint8_t **null_bitmap_list= (uint8_t **)realloc(result->null_bitmap_list, sizeof(uint8_t *) * new_row_list_size);
-        if (null_bitmap_list == NULL)
-        {
-          drizzle_row_free(result, row);
-          drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to realloc null_bitmap_list.");
-          return DRIZZLE_RETURN_MEMORY;
-        }
-        result->null_bitmap_list= null_bitmap_list;
+        new_row_list_size= DRIZZLE_ROW_GROW_SIZE;
       }
 
-      field_sizes_list= (size_t **)realloc(result->field_sizes_list, sizeof(size_t *) * new_row_list_size);
-      if (field_sizes_list == NULL)
+      row_list= (drizzle_row_t *)realloc(result->row_list, sizeof(drizzle_row_t) * new_row_list_size);
+      if (row_list == NULL)
       {
         drizzle_row_free(result, row);
-        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to realloc field list.");
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to realloc row_list.");
         return DRIZZLE_RETURN_MEMORY;
       }
-      result->field_sizes_list= field_sizes_list;
-
+      result->row_list= row_list;
       result->row_list_size= new_row_list_size;
     }
 
-    if (result->binary_rows)
+    record= _result_chunk_alloc(result, record_size, &ret);
+    if (record == NULL)
+    {
+      drizzle_row_free(result, row);
+      return ret;
+    }
+
+    fields= (drizzle_field_t *)record;
+    sizes= (size_t *)(fields + result->column_count);
+    data= (char *)(sizes + result->column_count);
+    memcpy(sizes, result->field_sizes, sizeof(size_t) * result->column_count);
+    if (bitmap_size > 0)
     {
-      result->null_bitmap_list[result->row_current - 1]= result->null_bitmap;
+      memcpy(data, result->null_bitmap, bitmap_size);
+      data+= bitmap_size;
     }
 
-    result->row_list[result->row_current - 1]= new drizzle_field_t[result->column_count]();
     for (x= 0; x < result->column_count; x++)
     {
-      if (result->field_sizes[x] > 0)
+      if (sizes[x] > 0)
+      {
+        fields[x]= data;
+        memcpy(data, row[x], sizes[x]);
+        data[sizes[x]]= 0;
+        data+= sizes[x] + 1;
+      }
+      else
       {
-        result->row_list[result->row_current - 1][x]= new char[result->field_sizes[x]+1]();
-        memcpy(result->row_list[result->row_current - 1][x], row[x], result->field_sizes[x]);
+        fields[x]= NULL;
       }
     }
-    result->field_sizes_list[result->row_current - 1]= result->field_sizes;
+    result->row_list[result->row_current - 1]= fields;
+  }
+
+  /* The arrays drizzle_row_buffer() reused for every row are not needed any
+   * more, the buffered rows have their own copies */
+  delete[] result->row;
+  delete[] result->field_sizes;
+  delete[] result->null_bitmap;
+  result->row= NULL;
+  result->field_sizes= NULL;
+  result->null_bitmap= NULL;
+  if (result->row_count > 0)
+  {
+    row= drizzle_result_row(result, result->row_count - 1);
+    result->field_sizes= result->row_field_sizes(row);
+    if (result->binary_rows)
+    {
+      result->null_bitmap= result->row_null_bitmap(row);
+    }
   }
 
   result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_BUFFER_ROW);
   return DRIZZLE_RETURN_OK;
 }
 
-size_t drizzle_result_row_size(drizzle_result_st *result)
+drizzle_return_t drizzle_result_buffer_spill(drizzle_result_st *result,
+                                             size_t memory_limit)
 {
   if (result == NULL)
   {
-    return 0;
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
 
-  return result->con->packet_size;
-}
+  result->spill_limit= memory_limit;
 
-/*
- * Internal state functions.
- */
+  return drizzle_result_buffer(result);
+}
 
-drizzle_return_t drizzle_state_result_read(drizzle_st *con)
+uint64_t drizzle_result_spill_size(drizzle_result_st *result)
 {
-  drizzle_return_t ret;
-
-  if (con == NULL)
+  if (result == NULL)
   {
-    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return 0;
   }
 
-  __LOG_LOCATION__
+  return result->spill_size;
+}
 
-  /* Assume the entire result packet will fit in the buffer. */
-  if (con->buffer_size < con->packet_size)
+drizzle_return_t drizzle_result_visit(drizzle_result_st *result,
+                                      drizzle_row_visit_fn *visit_fn,
+                                      void *context)
+{
+  if (result == NULL || visit_fn == NULL)
   {
-    con->push_state(drizzle_state_read);
-    return DRIZZLE_RETURN_OK;
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  drizzle_return_t ret;
+  const drizzle_field_view_st *fields;
+
+  if (!(result->options & DRIZZLE_RESULT_BUFFER_COLUMN))
+  {
+    ret= drizzle_column_buffer(result);
+    if (ret != DRIZZLE_RETURN_OK)
+      return ret;
+  }
+
+  if (result->options & (DRIZZLE_RESULT_BUFFER_ROW | DRIZZLE_RESULT_BUFFER_COLUMNAR))
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "visiting rows needs unread rows");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (result->column_count == 0)
+  {
+    return DRIZZLE_RETURN_OK;
+  }
+
+  while (1)
+  {
+    fields= drizzle_row_view(result, &ret);
+    if (ret != DRIZZLE_RETURN_OK)
+      return ret;
+
+    if (fields == NULL)
+      break;
+
+    ret= visit_fn(result, fields, context);
+    if (ret != DRIZZLE_RETURN_OK)
+      return ret;
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_vector_type_t drizzle_column_vector_type(const drizzle_column_st *column)
+{
+  switch ((int)column->type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+      return DRIZZLE_VECTOR_INT64;
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+      if (column->flags & DRIZZLE_COLUMN_FLAGS_UNSIGNED)
+      {
+        return DRIZZLE_VECTOR_UINT64;
+      }
+      return DRIZZLE_VECTOR_INT64;
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      return DRIZZLE_VECTOR_DOUBLE;
+    default:
+      return DRIZZLE_VECTOR_STRING;
+  }
+}
+
+uint64_t drizzle_vector_allocation(uint64_t allocation, uint64_t rows)
+{
+  if (allocation == 0)
+  {
+    allocation= DRIZZLE_ROW_GROW_SIZE;
+  }
+  while (allocation < rows)
+  {
+    allocation*= 2;
+  }
+
+  return allocation;
+}
+
+bool drizzle_vector_reserve(drizzle_result_vector_st *vector,
+                            uint64_t old_allocation, uint64_t allocation,
+                            size_t width)
+{
+  size_t bitmap_size= (size_t)((allocation + 7) / 8);
+  size_t old_bitmap_size= (size_t)((old_allocation + 7) / 8);
+  uint8_t *validity;
+
+  validity= (uint8_t *)realloc(vector->validity, bitmap_size);
+  if (validity == NULL)
+  {
+    return false;
+  }
+  memset(validity + old_bitmap_size, 0, bitmap_size - old_bitmap_size);
+  vector->validity= validity;
+
+  if (vector->type == DRIZZLE_VECTOR_STRING)
+  {
+    int64_t *offsets= (int64_t *)realloc(vector->offsets, (size_t)(allocation + 1) * sizeof(int64_t));
+    if (offsets == NULL)
+    {
+      return false;
+    }
+    if (vector->offsets == NULL)
+    {
+      offsets[0]= 0;
+    }
+    vector->offsets= offsets;
+  }
+  else
+  {
+    void *values= realloc(vector->values, (size_t)allocation * width);
+    if (values == NULL)
+    {
+      return false;
+    }
+    vector->values= values;
+  }
+
+  return true;
+}
+
+bool drizzle_vector_append(drizzle_result_vector_st *vector, const char *data,
+                           size_t size)
+{
+  if (vector->data_allocation - vector->data_size < size)
+  {
+    size_t allocation= vector->data_allocation > 0 ? vector->data_allocation : DRIZZLE_ROW_GROW_SIZE;
+    char *buffer;
+
+    while (allocation - vector->data_size < size)
+    {
+      allocation*= 2;
+    }
+    buffer= (char *)realloc(vector->data, allocation);
+    if (buffer == NULL)
+    {
+      return false;
+    }
+    vector->data= buffer;
+    vector->data_allocation= allocation;
+  }
+
+  memcpy(vector->data + vector->data_size, data, size);
+  vector->data_size+= size;
+
+  return true;
+}
+
+void drizzle_vector_set_valid(drizzle_result_vector_st *vector, uint64_t row,
+                              bool valid)
+{
+  if (valid)
+  {
+    vector->validity[row / 8]|= (uint8_t)(1 << (row % 8));
+  }
+  else
+  {
+    vector->null_count++;
+  }
+}
+
+bool drizzle_vector_set(drizzle_result_vector_st *vector, uint64_t row,
+                        drizzle_field_t field, size_t size)
+{
+  drizzle_vector_set_valid(vector, row, field != NULL);
+
+  switch ((int)vector->type)
+  {
+    case DRIZZLE_VECTOR_INT64:
+      ((int64_t *)vector->values)[row]= field == NULL ? 0 : (int64_t)strtoll(field, NULL, 10);
+      break;
+    case DRIZZLE_VECTOR_UINT64:
+      ((uint64_t *)vector->values)[row]= field == NULL ? 0 : (uint64_t)strtoull(field, NULL, 10);
+      break;
+    case DRIZZLE_VECTOR_DOUBLE:
+      ((double *)vector->values)[row]= field == NULL ? 0 : strtod(field, NULL);
+      break;
+    default:
+      if (field != NULL && !drizzle_vector_append(vector, field, size))
+      {
+        return false;
+      }
+      vector->offsets[row + 1]= (int64_t)vector->data_size;
+      break;
+  }
+
+  return true;
+}
+
+void drizzle_vector_free(drizzle_result_vector_st *vector)
+{
+  free(vector->values);
+  free(vector->offsets);
+  free(vector->data);
+  free(vector->validity);
+}
+
+/* Make room for the values of rows rows in every vector, doubling the
+ * allocations */
+static bool _vector_reserve(drizzle_result_st *result, uint64_t rows)
+{
+  uint64_t allocation;
+
+  if (rows <= result->vectors_allocation)
+  {
+    return true;
+  }
+
+  allocation= drizzle_vector_allocation(result->vectors_allocation, rows);
+  for (uint16_t x= 0; x < result->column_count; x++)
+  {
+    if (!drizzle_vector_reserve(&result->vectors[x], result->vectors_allocation,
+                                allocation, sizeof(int64_t)))
+    {
+      return false;
+    }
+  }
+  result->vectors_allocation= allocation;
+
+  return true;
+}
+
+drizzle_return_t drizzle_result_buffer_columnar(drizzle_result_st *result)
+{
+  if (result == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  drizzle_return_t ret;
+  drizzle_row_t row;
+
+  if (!(result->options & DRIZZLE_RESULT_BUFFER_COLUMN))
+  {
+    ret= drizzle_column_buffer(result);
+    if (ret != DRIZZLE_RETURN_OK)
+      return ret;
+  }
+
+  if (result->binary_rows || (result->options & DRIZZLE_RESULT_BUFFER_ROW))
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "columnar buffering needs unread text rows");
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (result->column_count == 0)
+  {
+    result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_BUFFER_COLUMNAR);
+    return DRIZZLE_RETURN_OK;
+  }
+
+  /* Strings always have their first offset, even without rows */
+  if (result->vectors == NULL)
+  {
+    result->vectors= new (std::nothrow) drizzle_result_vector_st[result->column_count]();
+    if (result->vectors == NULL)
+    {
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    for (uint16_t x= 0; x < result->column_count; x++)
+    {
+      result->vectors[x].type= drizzle_column_vector_type(&result->column_buffer[x]);
+    }
+    if (!_vector_reserve(result, 1))
+    {
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+  }
+
+  while (1)
+  {
+    uint64_t row_number;
+
+    row= drizzle_row_buffer(result, &ret);
+    if (ret != DRIZZLE_RETURN_OK)
+      return ret;
+
+    if (row == NULL)
+      break;
+
+    row_number= result->row_current - 1;
+    if (!_vector_reserve(result, row_number + 1))
+    {
+      drizzle_row_free(result, row);
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+
+    for (uint16_t x= 0; x < result->column_count; x++)
+    {
+      if (!drizzle_vector_set(&result->vectors[x], row_number, row[x],
+                              result->field_sizes[x]))
+      {
+        drizzle_row_free(result, row);
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+        return DRIZZLE_RETURN_MEMORY;
+      }
+    }
+  }
+
+  /* The rows are only in the vectors */
+  delete[] result->row;
+  delete[] result->field_sizes;
+  result->row= NULL;
+  result->field_sizes= NULL;
+
+  result->options = (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_BUFFER_COLUMNAR);
+  return DRIZZLE_RETURN_OK;
+}
+
+/* The vector of a column of a columnar result, NULL if there is none */
+static drizzle_result_vector_st *_result_vector(drizzle_result_st *result,
+                                                uint16_t column,
+                                                drizzle_vector_type_t type)
+{
+  if (result == NULL ||
+      !(result->options & DRIZZLE_RESULT_BUFFER_COLUMNAR) ||
+      column >= result->column_count)
+  {
+    return NULL;
+  }
+
+  if (type != DRIZZLE_VECTOR_NONE && result->vectors[column].type != type)
+  {
+    return NULL;
+  }
+
+  return &result->vectors[column];
+}
+
+drizzle_vector_type_t drizzle_result_vector_type(drizzle_result_st *result,
+                                                 uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_NONE);
+
+  return vector == NULL ? DRIZZLE_VECTOR_NONE : vector->type;
+}
+
+const int64_t *drizzle_result_vector_int64(drizzle_result_st *result,
+                                           uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_INT64);
+
+  return vector == NULL ? NULL : (const int64_t *)vector->values;
+}
+
+const uint64_t *drizzle_result_vector_uint64(drizzle_result_st *result,
+                                             uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_UINT64);
+
+  return vector == NULL ? NULL : (const uint64_t *)vector->values;
+}
+
+const double *drizzle_result_vector_double(drizzle_result_st *result,
+                                           uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_DOUBLE);
+
+  return vector == NULL ? NULL : (const double *)vector->values;
+}
+
+const int64_t *drizzle_result_vector_offsets(drizzle_result_st *result,
+                                             uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_STRING);
+
+  return vector == NULL ? NULL : vector->offsets;
+}
+
+const char *drizzle_result_vector_data(drizzle_result_st *result,
+                                       uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_STRING);
+
+  return vector == NULL ? NULL : vector->data;
+}
+
+const uint8_t *drizzle_result_vector_validity(drizzle_result_st *result,
+                                              uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_NONE);
+
+  return vector == NULL ? NULL : vector->validity;
+}
+
+uint64_t drizzle_result_vector_null_count(drizzle_result_st *result,
+                                          uint16_t column)
+{
+  drizzle_result_vector_st *vector= _result_vector(result, column, DRIZZLE_VECTOR_NONE);
+
+  return vector == NULL ? 0 : vector->null_count;
+}
+
+size_t drizzle_result_row_size(drizzle_result_st *result)
+{
+  if (result == NULL)
+  {
+    return 0;
+  }
+
+  return result->con->packet_size;
+}
+
+/*
+ * Internal state functions.
+ */
+
+drizzle_return_t drizzle_state_result_read(drizzle_st *con)
+{
+  drizzle_return_t ret;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  __LOG_LOCATION__
+
+  /* Assume the entire result packet will fit in the buffer. */
+  if (con->buffer_size < con->packet_size)
+  {
+    con->push_state(drizzle_state_read);
+    return DRIZZLE_RETURN_OK;
   }
 
   if (con->buffer_ptr[0] == 0)
@@ -454,6 +1356,23 @@ drizzle_return_t drizzle_state_result_read(drizzle_st *con)
     }
     ret= DRIZZLE_RETURN_OK;
   }
+  else if (con->buffer_ptr[0] == 251 && con->command == DRIZZLE_COMMAND_QUERY)
+  {
+    /* LOAD DATA LOCAL INFILE request, the rest of the packet is the file
+     * name. Stream the file and then read the real result. */
+    snprintf(con->result->info, DRIZZLE_MAX_INFO_SIZE, "%.*s",
+             (int)(con->packet_size - 1), con->buffer_ptr + 1);
+    con->buffer_ptr+= con->packet_size;
+    con->buffer_size-= con->packet_size;
+    con->packet_size= 0;
+    con->local_infile_ret= DRIZZLE_RETURN_OK;
+
+    con->pop_state();
+    con->push_state(drizzle_state_result_read);
+    con->push_state(drizzle_state_packet_read);
+    con->push_state(drizzle_state_local_infile_write);
+    return DRIZZLE_RETURN_OK;
+  }
   else if (con->buffer_ptr[0] == 254)
   {
     con->result->options= DRIZZLE_RESULT_EOF_PACKET;
@@ -477,6 +1396,16 @@ drizzle_return_t drizzle_state_result_read(drizzle_st *con)
     /* We can ignore the return since we've buffered the entire packet. */
     con->result->column_count= (uint16_t)drizzle_unpack_length(con, &ret);
     ret= DRIZZLE_RETURN_OK;
+
+    /* With metadata caching the server tells whether the column definitions
+       follow or are the same as the ones it sent last for the statement. */
+    if (con->state.cache_metadata && con->packet_size > 0)
+    {
+      con->result->metadata_skipped= (con->buffer_ptr[0] == 0);
+      con->buffer_ptr++;
+      con->buffer_size--;
+      con->packet_size--;
+    }
   }
 
   if (con->packet_size > 0)
@@ -492,6 +1421,127 @@ drizzle_return_t drizzle_state_result_read(drizzle_st *con)
     con->packet_size= 0;
   }
 
+  /* The file was cut short, the statement fails even if the server took
+   * what it got */
+  if (con->local_infile_ret != DRIZZLE_RETURN_OK)
+  {
+    if (con->local_infile_ret == DRIZZLE_RETURN_ERRNO && con->last_errno != 0)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "failed to read local infile: %s",
+                        strerror(con->last_errno));
+    }
+    else if (con->local_infile_ret == DRIZZLE_RETURN_ERRNO)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "failed to read local infile");
+    }
+    else
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "no local infile source set");
+    }
+    con->local_infile_ret= DRIZZLE_RETURN_OK;
+    ret= DRIZZLE_RETURN_ERROR_CODE;
+  }
+
   con->pop_state();
   return ret;
 }
+
+drizzle_return_t drizzle_state_local_infile_write(drizzle_st *con)
+{
+  unsigned char *start;
+  size_t max_size;
+  size_t size= 0;
+  ssize_t read_size;
+  bool eof= false;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  __LOG_LOCATION__
+
+  /* Errors end the file with the empty packet, the server still replies
+   * and the connection stays usable. drizzle_state_result_read() reports
+   * them. */
+  if (con->local_infile_fn == NULL && con->local_infile_fd == -1)
+  {
+    con->local_infile_ret= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    eof= true;
+  }
+
+  /* Leave room for the terminating empty packet. A payload of exactly
+   * 0xFFFFFF would make the server treat the next packet as a continuation,
+   * so stay below that. */
+  max_size= con->buffer_allocation - 8;
+  if (max_size > 0xFFFFFE)
+  {
+    max_size= 0xFFFFFE;
+  }
+
+  con->buffer_ptr= con->buffer;
+  con->buffer_size= 0;
+  start= con->buffer + 4;
+
+  /* Fill as much of the buffer as we can before sending so short reads do
+   * not turn into a stream of tiny packets. */
+  while (!eof && size < max_size)
+  {
+    if (con->local_infile_fn != NULL)
+    {
+      errno= 0;
+      read_size= con->local_infile_fn(con, con->result->info, start + size,
+                                      max_size - size,
+                                      con->local_infile_context);
+    }
+    else
+    {
+      read_size= read(con->local_infile_fd, start + size, max_size - size);
+      if (read_size == -1 && errno == EINTR)
+      {
+        continue;
+      }
+    }
+
+    if (read_size < 0)
+    {
+      /* Drop the partial chunk, the server keeps what was sent before */
+      con->last_errno= errno;
+      con->local_infile_ret= DRIZZLE_RETURN_ERRNO;
+      size= 0;
+      eof= true;
+      break;
+    }
+
+    if (read_size == 0)
+    {
+      eof= true;
+      break;
+    }
+
+    size+= (size_t)read_size;
+  }
+
+  if (size > 0)
+  {
+    drizzle_set_byte3(con->buffer, size);
+    con->buffer[3]= con->packet_number++;
+    con->buffer_size= 4 + size;
+  }
+
+  if (eof)
+  {
+    unsigned char *end= con->buffer + con->buffer_size;
+    drizzle_set_byte3(end, 0);
+    end[3]= con->packet_number++;
+    con->buffer_size+= 4;
+    con->pop_state();
+  }
+
+  con->push_state(drizzle_state_write);
+
+  return DRIZZLE_RETURN_OK;
+}
@@ -38,6 +38,29 @@
 
 #pragma once
 
+/* Block of buffered rows, allocated by drizzle_result_buffer() and followed
+ * by size bytes of row records */
+struct drizzle_result_chunk_st
+{
+  drizzle_result_chunk_st *next;
+  size_t size;
+  size_t used;
+};
+
+/* Values of one column of a result buffered by
+ * drizzle_result_buffer_columnar() */
+struct drizzle_result_vector_st
+{
+  drizzle_vector_type_t type;
+  void *values;       /* int64_t, uint64_t or double for every row */
+  int64_t *offsets;   /* strings: start of every row in data, then the end */
+  char *data;
+  size_t data_size;
+  size_t data_allocation;
+  uint8_t *validity;  /* bit set for every row which is not NULL */
+  uint64_t null_count;
+};
+
 /**
  * @ingroup drizzle_result
  */
@@ -60,6 +83,9 @@ struct drizzle_result_st
   drizzle_column_st *column_list;
   drizzle_column_st *column;
   drizzle_column_st *column_buffer;
+  uint16_t *column_index;         /* name hash slots of column number + 1 */
+  uint32_t column_index_size;
+  drizzle_column_st *column_index_columns; /* column_buffer the index is for */
 
   uint64_t row_count;
   uint64_t row_current;
@@ -75,16 +101,35 @@ struct drizzle_result_st
 
   size_t row_list_size;
   drizzle_row_t row;
-  drizzle_row_t *row_list;
+  drizzle_row_t *row_list;        /* heap rows, each followed by its sizes and NULL bitmap */
+  drizzle_result_chunk_st *row_chunks; /* storage of the heap rows, newest first */
+  size_t chunk_memory;            /* heap bytes of the row chunks */
+  size_t spill_limit;             /* heap bytes before rows go to the spill file */
+  int spill_fd;                   /* unlinked file of the rows beyond the limit, or -1 */
+  uint64_t spill_size;            /* bytes of records and index blocks in the file */
+  char *spill_map;                /* one mapping of the whole file */
+  uint64_t spill_map_size;        /* bytes reserved in the file and mapped */
+  uint64_t spill_row;             /* first row in the file */
+  uint64_t *spill_index;          /* file offsets of the row index blocks */
+  size_t spill_index_size;
+  drizzle_row_t spill_record;     /* last file row looked up, laid out as a heap row */
+  drizzle_result_vector_st *vectors; /* column_count vectors of a columnar result */
+  uint64_t vectors_allocation;    /* rows the vectors have room for */
   size_t *field_sizes;
-  size_t **field_sizes_list;
+  bool row_pending;               /* drizzle_row_buffer() has read the row header */
+  drizzle_field_view_st *field_views; /* row of drizzle_row_view() */
+  bool view_pending;              /* drizzle_row_view() has read the row header */
+  bool view_copy;                 /* the row spans packets, its fields are copied */
+  drizzle_field_view_st *batch_views; /* rows of drizzle_row_read_batch() */
+  size_t batch_views_rows;
   drizzle_binlog_st *binlog_event;
   bool binlog_checksums;
-  uint8_t **null_bitmap_list;
   uint8_t *null_bitmap;
   uint16_t null_bitmap_length;
   uint16_t null_bitcount;
   bool binary_rows;
+  bool metadata_skipped;
+  bool rows_read; /* the EOF packet after the rows has been read */
 
   drizzle_result_st() :
     con(NULL),
@@ -100,6 +145,9 @@ struct drizzle_result_st
     column_list(NULL),
     column(NULL),
     column_buffer(NULL),
+    column_index(NULL),
+    column_index_size(0),
+    column_index_columns(NULL),
     row_count(0),
     row_current(0),
     field_current(0),
@@ -112,15 +160,34 @@ struct drizzle_result_st
     row_list_size(0),
     row(NULL),
     row_list(NULL),
+    row_chunks(NULL),
+    chunk_memory(0),
+    spill_limit(SIZE_MAX),
+    spill_fd(-1),
+    spill_size(0),
+    spill_map(NULL),
+    spill_map_size(0),
+    spill_row(UINT64_MAX),
+    spill_index(NULL),
+    spill_index_size(0),
+    spill_record(NULL),
+    vectors(NULL),
+    vectors_allocation(0),
     field_sizes(NULL),
-    field_sizes_list(NULL),
+    row_pending(false),
+    field_views(NULL),
+    view_pending(false),
+    view_copy(false),
+    batch_views(NULL),
+    batch_views_rows(0),
     binlog_event(NULL),
     binlog_checksums(false),
-    null_bitmap_list(NULL),
     null_bitmap(NULL),
     null_bitmap_length(0),
     null_bitcount(0),
-    binary_rows(false)
+    binary_rows(false),
+    metadata_skipped(false),
+    rows_read(false)
   {
     info[0]= '\0';
     sqlstate[0]= '\0';
@@ -136,6 +203,25 @@ struct drizzle_result_st
     return false;
   }
 
+  /* Field sizes of a buffered row, stored after its field pointers */
+  size_t *row_field_sizes(drizzle_row_t buffered_row) const
+  {
+    return (size_t *)(buffered_row + column_count);
+  }
+
+  /* Buffered row whose field sizes these are, the inverse of
+   * row_field_sizes() */
+  drizzle_row_t sizes_row(size_t *field_sizes_ptr) const
+  {
+    return (drizzle_row_t)field_sizes_ptr - column_count;
+  }
+
+  /* NULL bitmap of a buffered binary row, stored after its field sizes */
+  uint8_t *row_null_bitmap(drizzle_row_t buffered_row) const
+  {
+    return (uint8_t *)(row_field_sizes(buffered_row) + column_count);
+  }
+
   bool has_state() const
   {
     if (con)
@@ -146,3 +232,52 @@ struct drizzle_result_st
     return false;
   }
 };
+
+/**
+ * A row of a buffered result. Rows in the spill file are copied into one
+ * record of the result, which the next call overwrites.
+ */
+drizzle_row_t drizzle_result_row(drizzle_result_st *result, uint64_t row_number);
+
+/**
+ * The vector type the text values of a column are decoded into.
+ */
+drizzle_vector_type_t drizzle_column_vector_type(const drizzle_column_st *column);
+
+/**
+ * Grow a vector allocation by doubling until it has room for rows rows.
+ */
+uint64_t drizzle_vector_allocation(uint64_t allocation, uint64_t rows);
+
+/**
+ * Make room for allocation rows in a vector which has room for
+ * old_allocation rows. Values are width bytes, string vectors get offsets
+ * instead. New validity bits start cleared.
+ */
+bool drizzle_vector_reserve(drizzle_result_vector_st *vector,
+                            uint64_t old_allocation, uint64_t allocation,
+                            size_t width);
+
+/**
+ * Append size bytes to the string data of a vector.
+ */
+bool drizzle_vector_append(drizzle_result_vector_st *vector, const char *data,
+                           size_t size);
+
+/**
+ * Mark a row of a vector valid, or count it as NULL.
+ */
+void drizzle_vector_set_valid(drizzle_result_vector_st *vector, uint64_t row,
+                              bool valid);
+
+/**
+ * Decode a text field into a row of a vector, NULL for SQL NULL. Returns
+ * false if string data could not be allocated.
+ */
+bool drizzle_vector_set(drizzle_result_vector_st *vector, uint64_t row,
+                        drizzle_field_t field, size_t size);
+
+/**
+ * Free the buffers of a vector.
+ */
+void drizzle_vector_free(drizzle_result_vector_st *vector);
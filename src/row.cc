@@ -100,34 +100,43 @@ drizzle_row_t drizzle_row_buffer(drizzle_result_st *result,
   drizzle_field_t field;
   drizzle_row_t row;
 
-  if (result->row)
+  /* A row whose fields are still being read continues after
+   * DRIZZLE_RETURN_IO_WAIT. The row arrays stay allocated between rows, so
+   * a flag tells. */
+  if (!result->row_pending)
   {
-    delete[] result->row;
-    result->row= NULL;
-  }
+    if (drizzle_row_read(result, ret_ptr) == 0 || *ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      return NULL;
+    }
 
-  if (drizzle_row_read(result, ret_ptr) == 0 || *ret_ptr != DRIZZLE_RETURN_OK)
-  {
-    return NULL;
-  }
+    /* The arrays of the previous row are reused unless they were freed */
+    if (result->row == NULL)
+    {
+      result->row= new (std::nothrow) drizzle_field_t[result->column_count];
+      if (result->row == NULL)
+      {
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+        *ret_ptr= DRIZZLE_RETURN_MEMORY;
+        return NULL;
+      }
+    }
 
-  result->row= new (std::nothrow) drizzle_field_t[result->column_count];
-  if (result->row == NULL)
-  {
-    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
-    *ret_ptr= DRIZZLE_RETURN_MEMORY;
-    return NULL;
-  }
+    if (result->field_sizes == NULL)
+    {
+      result->field_sizes= new (std::nothrow) size_t[result->column_count];
+      if (result->field_sizes == NULL)
+      {
+        drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+        *ret_ptr= DRIZZLE_RETURN_MEMORY;
+        return NULL;
+      }
+    }
 
-  result->field_sizes= new (std::nothrow) size_t[result->column_count];
-  if (result->field_sizes == NULL)
-  {
-    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
-    *ret_ptr= DRIZZLE_RETURN_MEMORY;
-    return NULL;
+    memset(result->field_sizes, 0, sizeof(size_t) * result->column_count);
+    result->row_pending= true;
   }
 
-  memset(result->field_sizes, 0, sizeof(size_t) * result->column_count);
   while (1)
   {
     field= drizzle_field_buffer(result, &total, ret_ptr);
@@ -138,6 +147,7 @@ drizzle_row_t drizzle_row_buffer(drizzle_result_st *result,
     {
       if (*ret_ptr != DRIZZLE_RETURN_IO_WAIT)
       {
+        result->row_pending= false;
         delete[] result->row;
         delete[] result->field_sizes;
         result->row= NULL;
@@ -151,12 +161,340 @@ drizzle_row_t drizzle_row_buffer(drizzle_result_st *result,
     result->field_sizes[result->field_current - 1]= total;
   }
 
+  result->row_pending= false;
   *ret_ptr= DRIZZLE_RETURN_OK;
   row= result->row;
 
   return row;
 }
 
+/*
+ * Find every field of a text row in one pass over its packet, one byte
+ * lengths first as nearly all fields have them. False for packets which do
+ * not hold exactly column_count fields.
+ */
+static bool _row_index(const unsigned char *ptr, const unsigned char *end,
+                       uint16_t column_count, drizzle_field_view_st *views)
+{
+  uint64_t length;
+
+  for (uint16_t x= 0; x < column_count; x++)
+  {
+    if (ptr == end)
+    {
+      return false;
+    }
+
+    if (ptr[0] < 251)
+    {
+      length= ptr[0];
+      ptr++;
+    }
+    else if (ptr[0] == 251)
+    {
+      views[x].data= NULL;
+      views[x].size= 0;
+      ptr++;
+      continue;
+    }
+    else if (ptr[0] == 252 && end - ptr >= 3)
+    {
+      length= drizzle_get_byte2(ptr + 1);
+      ptr+= 3;
+    }
+    else if (ptr[0] == 253 && end - ptr >= 4)
+    {
+      length= drizzle_get_byte3(ptr + 1);
+      ptr+= 4;
+    }
+    else
+    {
+      return false;
+    }
+
+    if (length > (uint64_t)(end - ptr))
+    {
+      return false;
+    }
+
+    views[x].data= (const char *)ptr;
+    views[x].size= (size_t)length;
+    ptr+= length;
+  }
+
+  return ptr == end;
+}
+
+const drizzle_field_view_st *drizzle_row_view(drizzle_result_st *result,
+                                              drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (result == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  drizzle_st *con= result->con;
+  drizzle_field_t field;
+  size_t size;
+  uint16_t column;
+
+  if (!result->view_pending)
+  {
+    if (drizzle_row_read(result, ret_ptr) == 0 || *ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      return NULL;
+    }
+
+    if (result->field_views == NULL)
+    {
+      result->field_views= new (std::nothrow) drizzle_field_view_st[result->column_count];
+      if (result->field_views == NULL)
+      {
+        drizzle_set_error(con, __FILE_LINE_FUNC__, "Failed to allocate.");
+        *ret_ptr= DRIZZLE_RETURN_MEMORY;
+        return NULL;
+      }
+    }
+    memset(result->field_views, 0, sizeof(drizzle_field_view_st) * result->column_count);
+
+    result->view_pending= true;
+    result->view_copy= !result->binary_rows &&
+                       con->packet_size >= DRIZZLE_MAX_PAYLOAD_SIZE;
+  }
+  else if (!result->view_copy && !result->has_state())
+  {
+    /* Continue reading the rest of the packet */
+    *ret_ptr= drizzle_state_loop(con);
+    if (*ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      result->view_pending= *ret_ptr == DRIZZLE_RETURN_IO_WAIT;
+      return NULL;
+    }
+  }
+
+  /* Reading moves the data in the buffer, so the whole packet is read
+   * before the first view into it is taken. Binary rows are read whole
+   * already. */
+  while (!result->view_copy && con->buffer_size < con->packet_size)
+  {
+    con->push_state(drizzle_state_read);
+    *ret_ptr= drizzle_state_loop(con);
+    if (*ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      result->view_pending= *ret_ptr == DRIZZLE_RETURN_IO_WAIT;
+      return NULL;
+    }
+  }
+
+  /* A text row whose fields have not been read yet is indexed in one pass,
+   * the field reads below also report malformed packets */
+  if (!result->binary_rows && !result->view_copy && result->field_current == 0 &&
+      _row_index(con->buffer_ptr, con->buffer_ptr + con->packet_size,
+                 result->column_count, result->field_views))
+  {
+    con->buffer_ptr+= con->packet_size;
+    con->buffer_size-= con->packet_size;
+    con->packet_size= 0;
+    result->field_current= result->column_count;
+    result->view_pending= false;
+    *ret_ptr= DRIZZLE_RETURN_OK;
+
+    return result->field_views;
+  }
+
+  while (1)
+  {
+    if (result->view_copy)
+    {
+      field= drizzle_field_buffer(result, &size, ret_ptr);
+    }
+    else
+    {
+      field= drizzle_field_read(result, NULL, &size, NULL, ret_ptr);
+    }
+
+    if (*ret_ptr == DRIZZLE_RETURN_ROW_END)
+    {
+      break;
+    }
+
+    if (*ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      result->view_pending= *ret_ptr == DRIZZLE_RETURN_IO_WAIT;
+      return NULL;
+    }
+
+    /* NULL fields of binary rows are only in the bitmap */
+    column= result->binary_rows ? result->field_current_read : result->field_current;
+    result->field_views[column - 1].data= field;
+    result->field_views[column - 1].size= size;
+  }
+
+  result->view_pending= false;
+  *ret_ptr= DRIZZLE_RETURN_OK;
+
+  return result->field_views;
+}
+
+/*
+ * Parse the next text row if its whole packet is in the read buffer, without
+ * going through the state machine. Anything else is left to
+ * drizzle_row_view(), which also reports malformed packets.
+ */
+static bool _row_parse_buffered(drizzle_result_st *result,
+                                drizzle_field_view_st *views)
+{
+  drizzle_st *con= result->con;
+  unsigned char *ptr;
+  unsigned char *end;
+  uint32_t size;
+
+  if (result->binary_rows || result->view_pending || !result->has_state() ||
+      (result->row_current != 0 && result->field_current != result->column_count))
+  {
+    return false;
+  }
+
+  if (con->buffer_size < 4)
+  {
+    return false;
+  }
+
+  size= drizzle_get_byte3(con->buffer_ptr);
+  if (size == 0 || size >= DRIZZLE_MAX_PAYLOAD_SIZE ||
+      con->buffer_size < (size_t)size + 4 ||
+      con->buffer_ptr[3] != con->packet_number)
+  {
+    return false;
+  }
+
+  ptr= con->buffer_ptr + 4;
+  end= ptr + size;
+
+  /* EOF and error packets */
+  if (ptr[0] == 254 || ptr[0] == 255)
+  {
+    return false;
+  }
+
+  if (!_row_index(ptr, end, result->column_count, views))
+  {
+    return false;
+  }
+
+  con->packet_number++;
+  con->packet_size= 0;
+  con->buffer_ptr= end;
+  con->buffer_size-= (size_t)size + 4;
+
+  result->row_count++;
+  result->row_current++;
+  result->field_current= result->column_count;
+  result->field_current_read= 0;
+
+  return true;
+}
+
+/* Whether drizzle_row_view() can read the next binary row without a read */
+static bool _row_binary_buffered(drizzle_result_st *result)
+{
+  drizzle_st *con= result->con;
+  uint32_t size;
+
+  if (!result->binary_rows || con->buffer_size < 5)
+  {
+    return false;
+  }
+
+  size= drizzle_get_byte3(con->buffer_ptr);
+
+  return size < DRIZZLE_MAX_PAYLOAD_SIZE &&
+         con->buffer_size >= (size_t)size + 4 && con->buffer_ptr[4] == 0;
+}
+
+size_t drizzle_row_read_batch(drizzle_result_st *result,
+                              const drizzle_field_view_st **rows, size_t max,
+                              drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (result == NULL || rows == NULL || max == 0)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return 0;
+  }
+
+  *ret_ptr= DRIZZLE_RETURN_OK;
+  if (result->rows_read || result->column_count == 0)
+  {
+    return 0;
+  }
+
+  if ((result->column_current != result->column_count) && (!(result->options & DRIZZLE_RESULT_BUFFER_COLUMN)))
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "cannot retrieve rows until all columns are retrieved");
+    *ret_ptr= DRIZZLE_RETURN_NOT_READY;
+    return 0;
+  }
+
+  if (result->batch_views_rows < max)
+  {
+    delete[] result->batch_views;
+    result->batch_views= new (std::nothrow) drizzle_field_view_st[max * result->column_count];
+    if (result->batch_views == NULL)
+    {
+      result->batch_views_rows= 0;
+      drizzle_set_error(result->con, __FILE_LINE_FUNC__, "Failed to allocate.");
+      *ret_ptr= DRIZZLE_RETURN_MEMORY;
+      return 0;
+    }
+    result->batch_views_rows= max;
+  }
+
+  size_t count= 0;
+  const drizzle_field_view_st *fields;
+  drizzle_field_view_st *views;
+
+  while (count < max)
+  {
+    views= result->batch_views + count * result->column_count;
+    if (_row_parse_buffered(result, views))
+    {
+      rows[count++]= views;
+      continue;
+    }
+
+    /* Only the first row may read, later ones would move the buffer */
+    if (count > 0 && !_row_binary_buffered(result))
+    {
+      break;
+    }
+
+    fields= drizzle_row_view(result, ret_ptr);
+    if (fields == NULL)
+    {
+      break;
+    }
+
+    memcpy(views, fields, sizeof(drizzle_field_view_st) * result->column_count);
+    rows[count++]= views;
+  }
+
+  return count;
+}
+
 void drizzle_row_free(drizzle_result_st *result, drizzle_row_t row)
 {
   if (result == NULL)
@@ -188,42 +526,49 @@ size_t *drizzle_row_field_sizes(drizzle_result_st *result)
 
 drizzle_row_t drizzle_row_next(drizzle_result_st *result)
 {
+  drizzle_row_t row;
+
   if (result == NULL)
   {
     return NULL;
   }
 
-  if (result->row_current == result->row_count)
+  if (result->row_current == result->row_count ||
+      !(result->options & DRIZZLE_RESULT_BUFFER_ROW))
   {
     return NULL;
   }
 
-  result->field_sizes= result->field_sizes_list[result->row_current];
+  row= drizzle_result_row(result, result->row_current);
+  result->field_sizes= result->row_field_sizes(row);
   if (result->binary_rows)
   {
-    result->null_bitmap= result->null_bitmap_list[result->row_current];
+    result->null_bitmap= result->row_null_bitmap(row);
   }
   result->row_current++;
-  return result->row_list[result->row_current - 1];
+  return row;
 }
 
 drizzle_row_t drizzle_row_prev(drizzle_result_st *result)
 {
+  drizzle_row_t row;
+
   if (result == NULL)
   {
     return NULL;
   }
 
-  if (result->row_current == 0)
+  if (result->row_current == 0 || !(result->options & DRIZZLE_RESULT_BUFFER_ROW))
     return NULL;
 
   result->row_current--;
-  result->field_sizes= result->field_sizes_list[result->row_current];
+  row= drizzle_result_row(result, result->row_current);
+  result->field_sizes= result->row_field_sizes(row);
   if (result->binary_rows)
   {
-    result->null_bitmap= result->null_bitmap_list[result->row_current];
+    result->null_bitmap= result->row_null_bitmap(row);
   }
-  return result->row_list[result->row_current];
+  return row;
 }
 
 void drizzle_row_seek(drizzle_result_st *result, uint64_t row)
@@ -244,10 +589,10 @@ drizzle_row_t drizzle_row_index(drizzle_result_st *result, uint64_t row)
     return NULL;
   }
 
-  if (row >= result->row_count)
+  if (row >= result->row_count || !(result->options & DRIZZLE_RESULT_BUFFER_ROW))
     return NULL;
 
-  return result->row_list[row];
+  return drizzle_result_row(result, row);
 }
 
 uint64_t drizzle_row_current(drizzle_result_st *result)
@@ -284,6 +629,7 @@ drizzle_return_t drizzle_state_row_read(drizzle_st *con)
   {
     /* Got EOF packet, no more rows. */
     con->result->row_current= 0;
+    con->result->rows_read= true;
     con->result->warning_count= drizzle_get_byte2(con->buffer_ptr + 1);
     con->status= (drizzle_status_t)drizzle_get_byte2(con->buffer_ptr + 3);
     con->buffer_ptr+= 5;
@@ -305,6 +651,14 @@ drizzle_return_t drizzle_state_row_read(drizzle_st *con)
     con->result->row_current++;
     con->result->field_current= 0;
     con->result->field_current_read= 0;
+
+    /* Binary rows start with the NULL bitmap */
+    if (con->result->binary_rows)
+    {
+      con->pop_state();
+      con->push_state(drizzle_state_binary_null_read);
+      return DRIZZLE_RETURN_OK;
+    }
   }
 
   con->pop_state();
@@ -0,0 +1,771 @@
+/* vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ * Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @file
+ * @brief Typed access to the fields of text rows
+ */
+
+#include "config.h"
+#include "src/common.h"
+
+static const uint64_t _row_powers_of_ten[]=
+{
+  UINT64_C(1), UINT64_C(10), UINT64_C(100), UINT64_C(1000), UINT64_C(10000),
+  UINT64_C(100000), UINT64_C(1000000), UINT64_C(10000000),
+  UINT64_C(100000000), UINT64_C(1000000000), UINT64_C(10000000000),
+  UINT64_C(100000000000), UINT64_C(1000000000000),
+  UINT64_C(10000000000000), UINT64_C(100000000000000),
+  UINT64_C(1000000000000000)
+};
+
+/* Mantissas of up to 15 digits and their powers of ten are exact doubles,
+ * so one division rounds correctly */
+#define DRIZZLE_ROW_EXACT_DIGITS 15
+
+/*
+ * Digit parsing, eight digits at a time in a 64 bit word
+ */
+
+/* Eight bytes with the first one in the lowest byte on any platform */
+static uint64_t _row_load8(const char *ptr)
+{
+  const unsigned char *bytes= (const unsigned char *)ptr;
+
+  return (uint64_t)bytes[0] | (uint64_t)bytes[1] << 8 |
+         (uint64_t)bytes[2] << 16 | (uint64_t)bytes[3] << 24 |
+         (uint64_t)bytes[4] << 32 | (uint64_t)bytes[5] << 40 |
+         (uint64_t)bytes[6] << 48 | (uint64_t)bytes[7] << 56;
+}
+
+/* Whether all eight bytes are '0' to '9': the high nibbles must be 3, also
+ * after adding 6, which carries out of the low nibble above '9' */
+static bool _row_is_eight_digits(uint64_t chunk)
+{
+  return ((chunk & UINT64_C(0xF0F0F0F0F0F0F0F0)) |
+          (((chunk + UINT64_C(0x0606060606060606)) & UINT64_C(0xF0F0F0F0F0F0F0F0)) >> 4)) ==
+         UINT64_C(0x3333333333333333);
+}
+
+/* Combine digit pairs, then pairs of pairs, then the two halves */
+static uint32_t _row_eight_digits(uint64_t chunk)
+{
+  chunk= ((chunk & UINT64_C(0x0F0F0F0F0F0F0F0F)) * 2561) >> 8;
+  chunk= ((chunk & UINT64_C(0x00FF00FF00FF00FF)) * 6553601) >> 16;
+
+  return (uint32_t)(((chunk & UINT64_C(0x0000FFFF0000FFFF)) * UINT64_C(42949672960001)) >> 32);
+}
+
+static bool _row_is_digit(char c)
+{
+  return (unsigned char)(c - '0') < 10;
+}
+
+/* Read up to 19 digits, which cannot overflow, returns how many were read */
+static size_t _row_digits(const char **ptr, const char *end, uint64_t *value)
+{
+  const char *start= *ptr;
+  uint64_t result= 0;
+
+  while (end - *ptr >= 8 && (*ptr - start) + 8 <= 19)
+  {
+    uint64_t chunk= _row_load8(*ptr);
+    if (!_row_is_eight_digits(chunk))
+    {
+      break;
+    }
+    result= result * 100000000 + _row_eight_digits(chunk);
+    *ptr+= 8;
+  }
+
+  while (*ptr < end && _row_is_digit(**ptr) && *ptr - start < 19)
+  {
+    result= result * 10 + (uint64_t)(**ptr - '0');
+    (*ptr)++;
+  }
+
+  *value= result;
+
+  return (size_t)(*ptr - start);
+}
+
+/* Read exactly digits digits */
+static bool _row_fixed(const char **ptr, const char *end, size_t digits,
+                       uint32_t *value)
+{
+  uint32_t result= 0;
+
+  if ((size_t)(end - *ptr) < digits)
+  {
+    return false;
+  }
+
+  for (; digits > 0; digits--, (*ptr)++)
+  {
+    if (!_row_is_digit(**ptr))
+    {
+      return false;
+    }
+    result= result * 10 + (uint32_t)(**ptr - '0');
+  }
+
+  *value= result;
+
+  return true;
+}
+
+static bool _row_sign(const char **ptr, const char *end)
+{
+  if (*ptr < end && (**ptr == '-' || **ptr == '+'))
+  {
+    (*ptr)++;
+    return (*ptr)[-1] == '-';
+  }
+
+  return false;
+}
+
+/* Parse [+-]digits, false if malformed or beyond 64 bits */
+static bool _row_integer(const char *field, size_t size, uint64_t *magnitude,
+                         bool *negative)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+
+  *negative= _row_sign(&ptr, end);
+  if (_row_digits(&ptr, end, magnitude) == 0)
+  {
+    return false;
+  }
+
+  /* A twentieth digit may still fit */
+  if (ptr < end && _row_is_digit(*ptr))
+  {
+    uint64_t digit= (uint64_t)(*ptr - '0');
+    if (*magnitude > (UINT64_MAX - digit) / 10)
+    {
+      return false;
+    }
+    *magnitude= *magnitude * 10 + digit;
+    ptr++;
+  }
+
+  return ptr == end;
+}
+
+/* Parse a decimal number, short plain ones without strtod() */
+static bool _row_double(const char *field, size_t size, double *value)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+  uint64_t integer;
+  uint64_t fraction= 0;
+  size_t integer_digits;
+  size_t fraction_digits= 0;
+  bool negative;
+  char *parsed;
+
+  negative= _row_sign(&ptr, end);
+  integer_digits= _row_digits(&ptr, end, &integer);
+  if (ptr < end && *ptr == '.')
+  {
+    ptr++;
+    fraction_digits= _row_digits(&ptr, end, &fraction);
+  }
+
+  if (ptr == end && integer_digits + fraction_digits > 0 &&
+      integer_digits + fraction_digits <= DRIZZLE_ROW_EXACT_DIGITS)
+  {
+    uint64_t mantissa= integer * _row_powers_of_ten[fraction_digits] + fraction;
+    *value= (double)mantissa / (double)_row_powers_of_ten[fraction_digits];
+    if (negative)
+    {
+      *value= -*value;
+    }
+    return true;
+  }
+
+  /* Text fields are NUL terminated */
+  *value= strtod(field, &parsed);
+
+  return parsed == end && size > 0;
+}
+
+/* high:low= high:low * multiplier + add for a multiplier of at most 10^8,
+ * false if the product does not fit into 128 bits */
+static bool _row_multiply128(uint64_t *high, uint64_t *low,
+                             uint64_t multiplier, uint64_t add)
+{
+  uint64_t low_half= (*low & UINT64_C(0xFFFFFFFF)) * multiplier + add;
+  uint64_t high_half= (*low >> 32) * multiplier + (low_half >> 32);
+  uint64_t carry= high_half >> 32;
+
+  if (*high > (UINT64_MAX - carry) / multiplier)
+  {
+    return false;
+  }
+
+  *high= *high * multiplier + carry;
+  *low= (high_half << 32) | (low_half & UINT64_C(0xFFFFFFFF));
+
+  return true;
+}
+
+/* Parse [+-]digits[.digits] into a 128 bit integer scaled by 10^scale,
+ * dropping fraction digits which do not fit */
+static drizzle_return_t _row_decimal128(const char *field, size_t size,
+                                        drizzle_decimal_st *decimal)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+  bool truncated= false;
+
+  decimal->negative= _row_sign(&ptr, end);
+  if (ptr == end || !_row_is_digit(*ptr))
+  {
+    return DRIZZLE_RETURN_INVALID_CONVERSION;
+  }
+
+  while (ptr < end && _row_is_digit(*ptr))
+  {
+    bool fits;
+
+    if (end - ptr >= 8 && _row_is_eight_digits(_row_load8(ptr)))
+    {
+      fits= _row_multiply128(&decimal->high, &decimal->low, 100000000,
+                             _row_eight_digits(_row_load8(ptr)));
+      ptr+= 8;
+    }
+    else
+    {
+      fits= _row_multiply128(&decimal->high, &decimal->low, 10,
+                             (uint64_t)(*ptr - '0'));
+      ptr++;
+    }
+
+    if (!fits)
+    {
+      return DRIZZLE_RETURN_INVALID_CONVERSION;
+    }
+  }
+
+  if (ptr < end && *ptr == '.')
+  {
+    for (ptr++; ptr < end && _row_is_digit(*ptr); ptr++)
+    {
+      uint64_t high= decimal->high;
+      uint64_t low= decimal->low;
+
+      if (truncated || decimal->scale == UINT8_MAX ||
+          !_row_multiply128(&high, &low, 10, (uint64_t)(*ptr - '0')))
+      {
+        truncated|= *ptr != '0';
+        continue;
+      }
+      decimal->high= high;
+      decimal->low= low;
+      decimal->scale++;
+    }
+  }
+
+  if (ptr != end)
+  {
+    return DRIZZLE_RETURN_INVALID_CONVERSION;
+  }
+
+  return truncated ? DRIZZLE_RETURN_TRUNCATED : DRIZZLE_RETURN_OK;
+}
+
+/* [.ffffff] after seconds, as microseconds */
+static bool _row_microseconds(const char **ptr, const char *end,
+                              drizzle_datetime_st *datetime)
+{
+  uint64_t fraction;
+  size_t digits;
+
+  if (*ptr == end || **ptr != '.')
+  {
+    return true;
+  }
+  (*ptr)++;
+
+  digits= _row_digits(ptr, end, &fraction);
+  if (digits == 0 || digits > 6)
+  {
+    return false;
+  }
+  datetime->microsecond= (uint32_t)(fraction * _row_powers_of_ten[6 - digits]);
+  datetime->show_microseconds= true;
+
+  return true;
+}
+
+static bool _row_separator(const char **ptr, const char *end, char separator)
+{
+  if (*ptr == end || **ptr != separator)
+  {
+    return false;
+  }
+  (*ptr)++;
+
+  return true;
+}
+
+/* HH:MM:SS[.ffffff] after the hours */
+static bool _row_clock(const char **ptr, const char *end,
+                       drizzle_datetime_st *datetime)
+{
+  uint32_t minute;
+  uint32_t second;
+
+  if (!_row_separator(ptr, end, ':') || !_row_fixed(ptr, end, 2, &minute) ||
+      !_row_separator(ptr, end, ':') || !_row_fixed(ptr, end, 2, &second))
+  {
+    return false;
+  }
+  datetime->minute= (uint8_t)minute;
+  datetime->second= (uint8_t)second;
+
+  return _row_microseconds(ptr, end, datetime);
+}
+
+/* YYYY-MM-DD[ HH:MM:SS[.ffffff]] */
+static bool _row_timestamp(const char *field, size_t size,
+                           drizzle_datetime_st *datetime)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+  uint32_t year;
+  uint32_t month;
+  uint32_t hour;
+
+  if (!_row_fixed(&ptr, end, 4, &year) || !_row_separator(&ptr, end, '-') ||
+      !_row_fixed(&ptr, end, 2, &month) || !_row_separator(&ptr, end, '-') ||
+      !_row_fixed(&ptr, end, 2, &datetime->day))
+  {
+    return false;
+  }
+  datetime->year= (uint16_t)year;
+  datetime->month= (uint8_t)month;
+
+  if (ptr < end)
+  {
+    if (!_row_separator(&ptr, end, ' ') || !_row_fixed(&ptr, end, 2, &hour) ||
+        !_row_clock(&ptr, end, datetime))
+    {
+      return false;
+    }
+    datetime->hour= (uint16_t)hour;
+  }
+
+  return ptr == end;
+}
+
+/* [-]H+:MM:SS[.ffffff], with whole days apart from the hours as the binary
+ * protocol sends them */
+static bool _row_time(const char *field, size_t size,
+                      drizzle_datetime_st *datetime)
+{
+  const char *ptr= field;
+  const char *end= field + size;
+  uint64_t hours;
+
+  datetime->negative= _row_sign(&ptr, end);
+  if (_row_digits(&ptr, end, &hours) == 0 || hours > UINT32_MAX ||
+      !_row_clock(&ptr, end, datetime))
+  {
+    return false;
+  }
+  datetime->day= (uint32_t)(hours / 24);
+  datetime->hour= (uint16_t)(hours % 24);
+
+  return ptr == end;
+}
+
+/*
+ * The field of the current row
+ */
+
+static const char *_row_get_field(drizzle_result_st *result, uint16_t column,
+                                  size_t *size, drizzle_return_t *ret_ptr)
+{
+  drizzle_row_t row= NULL;
+
+  if (result == NULL || column >= result->column_count)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (result->column_buffer == NULL || result->binary_rows)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__,
+                      "typed fields need buffered columns and text rows");
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  /* The row drizzle_row_field_sizes() belongs to */
+  if (result->options & DRIZZLE_RESULT_BUFFER_ROW)
+  {
+    if (result->field_sizes != NULL)
+    {
+      row= result->sizes_row(result->field_sizes);
+    }
+  }
+  else if (result->row_current != 0 && !result->row_pending)
+  {
+    row= result->row;
+  }
+
+  if (row == NULL)
+  {
+    drizzle_set_error(result->con, __FILE_LINE_FUNC__, "no current row");
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (row[column] == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_NULL_SIZE;
+    return NULL;
+  }
+
+  *size= result->field_sizes[column];
+  *ret_ptr= DRIZZLE_RETURN_OK;
+
+  return row[column];
+}
+
+/* Integer part of a DECIMAL field, whether any fraction digit is not zero */
+static bool _row_decimal_integer(const char *field, size_t size,
+                                 uint64_t *magnitude, bool *negative,
+                                 bool *fraction)
+{
+  const char *dot= (const char *)memchr(field, '.', size);
+  const char *end= field + size;
+
+  *fraction= false;
+  if (dot == NULL)
+  {
+    return _row_integer(field, size, magnitude, negative);
+  }
+
+  for (const char *ptr= dot + 1; ptr < end; ptr++)
+  {
+    if (!_row_is_digit(*ptr))
+    {
+      return false;
+    }
+    *fraction|= *ptr != '0';
+  }
+
+  return _row_integer(field, (size_t)(dot - field), magnitude, negative);
+}
+
+static bool _row_is_integer_type(drizzle_column_type_t type)
+{
+  switch ((int)type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+/* Integer value of an integer, DECIMAL or floating point field, with
+ * TRUNCATED when the fraction is dropped */
+static bool _row_get_integer(drizzle_result_st *result, uint16_t column,
+                             uint64_t *magnitude, bool *negative,
+                             drizzle_return_t *ret_ptr)
+{
+  size_t size;
+  const char *field= _row_get_field(result, column, &size, ret_ptr);
+  drizzle_column_type_t type;
+  bool fraction;
+  double real;
+
+  if (field == NULL)
+  {
+    return false;
+  }
+
+  type= result->column_buffer[column].type;
+  if (_row_is_integer_type(type))
+  {
+    if (_row_integer(field, size, magnitude, negative))
+    {
+      return true;
+    }
+  }
+  else if (type == DRIZZLE_COLUMN_TYPE_DECIMAL ||
+           type == DRIZZLE_COLUMN_TYPE_NEWDECIMAL)
+  {
+    if (_row_decimal_integer(field, size, magnitude, negative, &fraction))
+    {
+      if (fraction)
+      {
+        *ret_ptr= DRIZZLE_RETURN_TRUNCATED;
+      }
+      return true;
+    }
+  }
+  else if (type == DRIZZLE_COLUMN_TYPE_FLOAT ||
+           type == DRIZZLE_COLUMN_TYPE_DOUBLE)
+  {
+    if (_row_double(field, size, &real))
+    {
+      *negative= real < 0;
+      real= *negative ? -real : real;
+      /* 2^64, also false for NaN */
+      if (!(real < 18446744073709551616.0))
+      {
+        *magnitude= UINT64_MAX;
+        *ret_ptr= DRIZZLE_RETURN_TRUNCATED;
+        return true;
+      }
+      *magnitude= (uint64_t)real;
+      if (real > (double)*magnitude)
+      {
+        *ret_ptr= DRIZZLE_RETURN_TRUNCATED;
+      }
+      return true;
+    }
+  }
+
+  *ret_ptr= DRIZZLE_RETURN_INVALID_CONVERSION;
+
+  return false;
+}
+
+/*
+ * Client definitions
+ */
+
+int64_t drizzle_row_get_int64(drizzle_result_st *result, uint16_t column,
+                              drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  uint64_t magnitude;
+  bool negative;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (!_row_get_integer(result, column, &magnitude, &negative, ret_ptr))
+  {
+    return 0;
+  }
+
+  if (magnitude > (uint64_t)INT64_MAX + negative)
+  {
+    *ret_ptr= DRIZZLE_RETURN_TRUNCATED;
+    return negative ? INT64_MIN : INT64_MAX;
+  }
+
+  return negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+}
+
+uint64_t drizzle_row_get_uint64(drizzle_result_st *result, uint16_t column,
+                                drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  uint64_t magnitude;
+  bool negative;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (!_row_get_integer(result, column, &magnitude, &negative, ret_ptr))
+  {
+    return 0;
+  }
+
+  if (negative && magnitude != 0)
+  {
+    *ret_ptr= DRIZZLE_RETURN_TRUNCATED;
+    return 0;
+  }
+
+  return magnitude;
+}
+
+double drizzle_row_get_double(drizzle_result_st *result, uint16_t column,
+                              drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  size_t size;
+  const char *field;
+  double value;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  field= _row_get_field(result, column, &size, ret_ptr);
+  if (field == NULL)
+  {
+    return 0;
+  }
+
+  switch ((int)result->column_buffer[column].type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      if (_row_double(field, size, &value))
+      {
+        return value;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  *ret_ptr= DRIZZLE_RETURN_INVALID_CONVERSION;
+
+  return 0;
+}
+
+drizzle_return_t drizzle_row_get_datetime(drizzle_result_st *result,
+                                          uint16_t column,
+                                          drizzle_datetime_st *datetime)
+{
+  drizzle_return_t ret;
+  size_t size;
+  const char *field;
+  bool parsed;
+
+  if (datetime == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+  memset(datetime, 0, sizeof(*datetime));
+
+  field= _row_get_field(result, column, &size, &ret);
+  if (field == NULL)
+  {
+    return ret;
+  }
+
+  switch ((int)result->column_buffer[column].type)
+  {
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+      parsed= _row_timestamp(field, size, datetime);
+      break;
+
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+      parsed= _row_time(field, size, datetime);
+      break;
+
+    default:
+      parsed= false;
+      break;
+  }
+
+  return parsed ? DRIZZLE_RETURN_OK : DRIZZLE_RETURN_INVALID_CONVERSION;
+}
+
+drizzle_return_t drizzle_row_get_decimal_as_int128(drizzle_result_st *result,
+                                                   uint16_t column,
+                                                   drizzle_decimal_st *decimal)
+{
+  drizzle_return_t ret;
+  size_t size;
+  const char *field;
+
+  if (decimal == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+  memset(decimal, 0, sizeof(*decimal));
+
+  field= _row_get_field(result, column, &size, &ret);
+  if (field == NULL)
+  {
+    return ret;
+  }
+
+  switch ((int)result->column_buffer[column].type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+      ret= _row_decimal128(field, size, decimal);
+      if (ret == DRIZZLE_RETURN_INVALID_CONVERSION)
+      {
+        memset(decimal, 0, sizeof(*decimal));
+      }
+      return ret;
+
+    default:
+      break;
+  }
+
+  return DRIZZLE_RETURN_INVALID_CONVERSION;
+}
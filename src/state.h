@@ -85,8 +85,16 @@ drizzle_return_t drizzle_state_handshake_result_read(drizzle_st *con);
 /* Functions in command.c */
 drizzle_return_t drizzle_state_command_write(drizzle_st *con);
 
+/* Functions in query.c */
+drizzle_return_t drizzle_state_query_template_write(drizzle_st *con);
+
 /* Functions in result.c */
 drizzle_return_t drizzle_state_result_read(drizzle_st *con);
+drizzle_return_t drizzle_state_local_infile_write(drizzle_st *con);
+
+/* Functions in statement.c */
+drizzle_return_t drizzle_state_stmt_execute_write(drizzle_st *con);
+drizzle_return_t drizzle_state_stmt_long_data_write(drizzle_st *con);
 
 /* Functions in column.c */
 drizzle_return_t drizzle_state_column_read(drizzle_st *con);
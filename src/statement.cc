@@ -38,119 +38,155 @@
 #include "config.h"
 #include "src/common.h"
 
-drizzle_stmt_st *drizzle_stmt_prepare(drizzle_st *con, const char *statement, size_t size, drizzle_return_t *ret_ptr)
+#include <inttypes.h>
+
+/*
+ * Private functions
+ */
+
+/* Number of bytes needed for the value of a bound parameter, an upper bound
+ * for the types with variable encoding. NULL and long data take none. */
+static size_t _stmt_param_size(const drizzle_bind_st *param_ptr)
 {
-  drizzle_stmt_st *stmt= new (std::nothrow) drizzle_stmt_st;
-  if (stmt == NULL)
+  if (param_ptr->type == DRIZZLE_COLUMN_TYPE_NULL ||
+      param_ptr->options.is_null || param_ptr->options.is_long_data)
   {
-    *ret_ptr= DRIZZLE_RETURN_MEMORY;
-    drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
-    return NULL;
+    return 0;
   }
-  con->stmt= stmt;
-  stmt->con= con;
 
-  stmt->prepare_result= drizzle_command_write(con, NULL, DRIZZLE_COMMAND_STMT_PREPARE,
-                                      statement, size, size, ret_ptr);
-  if (*ret_ptr != DRIZZLE_RETURN_OK)
+  if (param_ptr->type == DRIZZLE_COLUMN_TYPE_TIME)
   {
-    delete stmt;
-    con->stmt= NULL;
-    return NULL;
+    return 13;
   }
 
-  /* Don't get the unused parameter packets.  Format is the same as column
-   * packets.  Deliberate off-by-one for the EOF packet */
-  if (stmt->param_count)
+  if (param_ptr->type == DRIZZLE_COLUMN_TYPE_DATE ||
+      param_ptr->type == DRIZZLE_COLUMN_TYPE_DATETIME ||
+      param_ptr->type == DRIZZLE_COLUMN_TYPE_TIMESTAMP)
   {
-    uint16_t param_num;
-    for (param_num= 0; param_num <= stmt->param_count; param_num++)
-    {
-      *ret_ptr= drizzle_column_skip(stmt->prepare_result);
-      if ((*ret_ptr != DRIZZLE_RETURN_OK) && (*ret_ptr != DRIZZLE_RETURN_EOF))
-      {
-        delete stmt;
-        return NULL;
-      }
-    }
+    return 12;
   }
 
-  /* Reset column counter which is incremented when skipping parameter packets
-   * and then buffer the columns */
-
-  stmt->prepare_result->column_current= 0;
-  drizzle_column_buffer(stmt->prepare_result);
+  /* parameter length + length encoding header */
+  return param_ptr->length + 9;
+}
 
-  /* Parameter count can then be used to figure out the length of the null
-   * bitmap mask */
+/* Number of bytes needed for the COM_STMT_EXECUTE payload of the currently
+ * bound parameters, an upper bound for the types with variable encoding. */
+static size_t _stmt_execute_size(drizzle_stmt_st *stmt)
+{
+  uint16_t current_param;
+  size_t param_lengths= 0;
 
-  stmt->null_bitmap_length= (stmt->param_count + 7) / 8;
-  stmt->null_bitmap= new (std::nothrow) uint8_t[stmt->null_bitmap_length]();
-  if (stmt->null_bitmap == NULL)
+  if (stmt->packed_params != NULL)
   {
-    delete stmt;
-    *ret_ptr= DRIZZLE_RETURN_MEMORY;
-    drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
-    return NULL;
+    return 9 + stmt->packed_params_size;
   }
 
-  /* Also use the parameter count to allocate the parameters */
-  stmt->query_params= new (std::nothrow) drizzle_bind_st[stmt->param_count];
-  stmt->state= DRIZZLE_STMT_PREPARED;
-  stmt->fields= stmt->prepare_result->column_buffer;
+  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  {
+    param_lengths+= _stmt_param_size(&stmt->query_params[current_param]);
+  }
 
-  return stmt;
+  return 4 /* Statement ID */
+       + 1 /* Flags */
+       + 4 /* Reserved (always set to 1) */
+       + stmt->null_bitmap_length /* Null bitmap length */
+       + 1 /* New parameters bound flag */
+       + (stmt->new_bind ? stmt->param_count * 2 : 0) /* Parameter type data */
+       + param_lengths; /* Parameter data */
 }
 
-drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
+/* Pack the binary protocol value of a parameter which is neither NULL nor
+ * long data at data_pos. Returns the end of the value, or NULL on error. */
+static unsigned char *_stmt_param_pack(drizzle_stmt_st *stmt,
+                                       drizzle_bind_st *param_ptr,
+                                       unsigned char *data_pos)
 {
-  if (stmt == NULL)
+  uint16_t short_value;
+  uint32_t long_value;
+  uint64_t longlong_value;
+
+  switch(param_ptr->type)
   {
-    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+    case DRIZZLE_COLUMN_TYPE_TINY:
+      *data_pos= *(uint8_t*)param_ptr->data;
+      data_pos++;
+      break;
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+      short_value= *(uint16_t*)param_ptr->data;
+      drizzle_set_byte2(data_pos, short_value);
+      data_pos+= 2;
+      break;
+    case DRIZZLE_COLUMN_TYPE_LONG:
+      long_value= *(uint32_t*)param_ptr->data;
+      drizzle_set_byte4(data_pos, long_value);
+      data_pos+= 4;
+      break;
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+      longlong_value= *(uint64_t*)param_ptr->data;
+      drizzle_set_byte8(data_pos, longlong_value);
+      data_pos+= 8;
+      break;
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+      /* Float and double don't need to be packed apparently */
+      memcpy(data_pos, param_ptr->data, 4);
+      data_pos+= 4;
+      break;
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      memcpy(data_pos, param_ptr->data, 8);
+      data_pos+= 8;
+      break;
+    case DRIZZLE_COLUMN_TYPE_TIME:
+      data_pos= drizzle_pack_time((drizzle_datetime_st*)param_ptr->data, data_pos);
+      break;
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+      data_pos= drizzle_pack_datetime((drizzle_datetime_st*)param_ptr->data, data_pos);
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+      data_pos= drizzle_pack_binary((unsigned char*)param_ptr->data, param_ptr->length, data_pos);
+      break;
+    /* These types aren't handled yet, most are for older MySQL versions */
+    case DRIZZLE_COLUMN_TYPE_NULL:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    /* We do not need to support these three: they exist internally to the MySQL server, but do not appear on the wire */
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    default:
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "unknown type when filling buffer");
+      return NULL;
   }
 
+  return data_pos;
+}
+
+/* Pack the COM_STMT_EXECUTE payload for the currently bound parameters into
+ * buffer, which must hold at least _stmt_execute_size() bytes. Returns the
+ * end of the packed data, or NULL on error. */
+static unsigned char *_stmt_execute_pack(drizzle_stmt_st *stmt,
+                                         unsigned char *buffer)
+{
   uint16_t current_param;
-  uint16_t param_count = stmt->param_count;
   drizzle_bind_st *param_ptr;
-  size_t param_lengths= 0;
-  size_t buffer_size= 0;
-  unsigned char *buffer;
   unsigned char *buffer_pos;
   unsigned char *data_pos;
-  drizzle_return_t ret;
-
-  /* Calculate param lengths */
-  for (current_param= 0; current_param < stmt->param_count; current_param++)
-  {
-    if (!stmt->query_params[current_param].is_bound)
-    {
-      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "parameter %d has not been bound", current_param);
-      return DRIZZLE_RETURN_STMT_ERROR;
-    }
-    /* Don't count NULLs */
-    if (stmt->query_params[current_param].type == DRIZZLE_COLUMN_TYPE_NULL)
-    {
-      param_count--;
-      continue;
-    }
-    /* parameter length + 8 byte header */
-    param_lengths+= stmt->query_params[current_param].length + 8;
-  }
 
-  buffer_size= 4 /* Statement ID */
-             + 1 /* Flags */
-             + 4 /* Reserved (always set to 1) */
-             + stmt->null_bitmap_length /* Null bitmap length */
-             + 1 /* New parameters bound flag */
-             + (param_count * 2) /* Parameter type data */
-             + param_lengths; /* Parameter data */
-
-  buffer = new (std::nothrow) unsigned char[buffer_size];
-  if (buffer == NULL)
-  {
-    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
-    return DRIZZLE_RETURN_MEMORY;
-  }
   buffer_pos= buffer;
 
   /* Statement ID */
@@ -160,6 +196,11 @@ drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
   /* Reserved, protocol specifies set to 1 */
   drizzle_set_byte4(&buffer[5], 1);
   buffer_pos+= 9;
+  if (stmt->packed_params != NULL)
+  {
+    memcpy(buffer_pos, stmt->packed_params, stmt->packed_params_size);
+    return buffer_pos + stmt->packed_params_size;
+  }
   /* Null bitmap */
   buffer_pos+= stmt->null_bitmap_length;
   /* New parameters bound flag
@@ -173,7 +214,7 @@ drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
     buffer_pos++;
     /* Each param has a 2 byte data type header so the data pointer should be
      * moved to this */
-    data_pos= buffer_pos + (param_count * 2);
+    data_pos= buffer_pos + (stmt->param_count * 2);
   }
   else
   {
@@ -187,24 +228,19 @@ drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
    * */
   for (current_param= 0; current_param < stmt->param_count; current_param++)
   {
-    uint16_t short_value;
-    uint32_t long_value;
-    uint64_t longlong_value;
     param_ptr= &stmt->query_params[current_param];
 
     if (stmt->new_bind)
     {
+      /* The server expects a type for every parameter, NULL included */
       uint16_t type= (uint16_t)param_ptr->type;
-      if (type != DRIZZLE_COLUMN_TYPE_NULL)
+      if (param_ptr->options.is_unsigned)
       {
-        if (param_ptr->options.is_unsigned)
-        {
-          /* Set the unsigned bit flag on the type data */
-          type |= 0x8000;
-        }
-        drizzle_set_byte2(buffer_pos, type);
-        buffer_pos+= 2;
+        /* Set the unsigned bit flag on the type data */
+        type |= 0x8000;
       }
+      drizzle_set_byte2(buffer_pos, type);
+      buffer_pos+= 2;
     }
 
     if (param_ptr->options.is_long_data)
@@ -213,181 +249,2175 @@ drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
       continue;
     }
 
-    switch(param_ptr->type)
+    /* A NULL entry of a parameter array keeps its declared type */
+    if (param_ptr->options.is_null || param_ptr->type == DRIZZLE_COLUMN_TYPE_NULL)
     {
-      case DRIZZLE_COLUMN_TYPE_NULL:
-        /* Toggle the bit for this column in the bitmap */
-        stmt->null_bitmap[current_param/8] |= (1 << (current_param % 8));
-        break;
-      case DRIZZLE_COLUMN_TYPE_TINY:
-        *data_pos= *(uint8_t*)param_ptr->data;
-        data_pos++;
-        break;
-      case DRIZZLE_COLUMN_TYPE_SHORT:
-        short_value= *(uint16_t*)param_ptr->data;
-        drizzle_set_byte2(data_pos, short_value);
-        data_pos+= 2;
-        break;
-      case DRIZZLE_COLUMN_TYPE_LONG:
-        long_value= *(uint32_t*)param_ptr->data;
-        drizzle_set_byte4(data_pos, long_value);
-        data_pos+= 4;
-        break;
-      case DRIZZLE_COLUMN_TYPE_LONGLONG:
-        longlong_value= *(uint64_t*)param_ptr->data;
-        drizzle_set_byte8(data_pos, longlong_value);
-        data_pos+= 8;
-        break;
-      case DRIZZLE_COLUMN_TYPE_FLOAT:
-        /* Float and double don't need to be packed apparently */
-        memcpy(data_pos, param_ptr->data, 4);
-        data_pos+= 4;
-        break;
-      case DRIZZLE_COLUMN_TYPE_DOUBLE:
-        memcpy(data_pos, param_ptr->data, 8);
-        data_pos+= 8;
-        break;
-      case DRIZZLE_COLUMN_TYPE_TIME:
-        data_pos= drizzle_pack_time((drizzle_datetime_st*)param_ptr->data, data_pos);
-        break;
-      case DRIZZLE_COLUMN_TYPE_DATE:
-      case DRIZZLE_COLUMN_TYPE_DATETIME:
-      case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
-        data_pos= drizzle_pack_datetime((drizzle_datetime_st*)param_ptr->data, data_pos);
-        break;
-      case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
-      case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
-      case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
-      case DRIZZLE_COLUMN_TYPE_BLOB:
-      case DRIZZLE_COLUMN_TYPE_VARCHAR:
-      case DRIZZLE_COLUMN_TYPE_VAR_STRING:
-      case DRIZZLE_COLUMN_TYPE_STRING:
-      case DRIZZLE_COLUMN_TYPE_DECIMAL:
-      case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
-        data_pos= drizzle_pack_binary((unsigned char*)param_ptr->data, param_ptr->length, data_pos);
-        break;
-      /* These types aren't handled yet, most are for older MySQL versions */
-      case DRIZZLE_COLUMN_TYPE_INT24:
-      case DRIZZLE_COLUMN_TYPE_YEAR:
-      case DRIZZLE_COLUMN_TYPE_NEWDATE:
-      case DRIZZLE_COLUMN_TYPE_ENUM:
-      case DRIZZLE_COLUMN_TYPE_SET:
-      case DRIZZLE_COLUMN_TYPE_GEOMETRY:
-      case DRIZZLE_COLUMN_TYPE_BIT:
-      /* We do not need to support these three: they exist internally to the MySQL server, but do not appear on the wire */
-      case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
-      case DRIZZLE_COLUMN_TYPE_DATETIME2:
-      case DRIZZLE_COLUMN_TYPE_TIME2:
-      default:
-        drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "unknown type when filling buffer");
-        delete[] buffer;
-        return DRIZZLE_RETURN_UNEXPECTED_DATA;
-        break;
+      /* Toggle the bit for this column in the bitmap */
+      stmt->null_bitmap[current_param/8] |= (1 << (current_param % 8));
+      continue;
+    }
+
+    data_pos= _stmt_param_pack(stmt, param_ptr, data_pos);
+    if (data_pos == NULL)
+    {
+      return NULL;
     }
   }
   /* Copy NULL bitmap */
   memcpy(&buffer[9], stmt->null_bitmap, stmt->null_bitmap_length);
+
+  return data_pos;
+}
+
+static drizzle_return_t _stmt_check_bound(drizzle_stmt_st *stmt)
+{
+  uint16_t current_param;
+
+  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  {
+    if (!stmt->query_params[current_param].is_bound)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "parameter %d has not been bound", current_param);
+      return DRIZZLE_RETURN_STMT_ERROR;
+    }
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Point the parameters bound to arrays at the entry for the given row */
+static void _stmt_bind_row(drizzle_stmt_st *stmt, uint32_t row)
+{
+  uint16_t current_param;
+  drizzle_bind_st *param_ptr;
+
+  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  {
+    param_ptr= &stmt->query_params[current_param];
+    if (!param_ptr->options.is_array)
+    {
+      continue;
+    }
+
+    drizzle_stmt_bind_array_row(param_ptr, row);
+  }
+}
+
+/* Pack a COM_STMT_BULK_EXECUTE packet into the size bytes at start, with
+ * the types of the parameters and as many rows from stmt->bulk_row on as
+ * fit. Every parameter of a row is an indicator byte, followed by the value
+ * unless it is NULL. Returns the end of the packet, or NULL with *ret_ptr
+ * DRIZZLE_RETURN_OK if not even one row fits. */
+static unsigned char *_stmt_bulk_pack(drizzle_stmt_st *stmt,
+                                      unsigned char *start, size_t size,
+                                      drizzle_return_t *ret_ptr)
+{
+  uint16_t current_param;
+  drizzle_bind_st *param_ptr;
+  unsigned char *ptr;
+  unsigned char *end= start + size;
+  uint32_t first_row= stmt->bulk_row;
+
+  *ret_ptr= DRIZZLE_RETURN_OK;
+
+  if (size < 11 + (size_t)stmt->param_count * 2)
+  {
+    return NULL;
+  }
+
+  ptr= start + 4;
+  *ptr++= DRIZZLE_COMMAND_STMT_BULK_EXECUTE;
+  drizzle_set_byte4(ptr, stmt->id);
+  drizzle_set_byte2(ptr + 4, DRIZZLE_STMT_BULK_SEND_TYPES);
+  ptr+= 6;
+
+  /* The types are the same for every row */
+  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  {
+    param_ptr= &stmt->query_params[current_param];
+    uint16_t type= (uint16_t)param_ptr->type;
+    if (param_ptr->options.is_unsigned)
+    {
+      type |= 0x8000;
+    }
+    drizzle_set_byte2(ptr, type);
+    ptr+= 2;
+  }
+
+  while (stmt->bulk_row < stmt->bulk_row_count)
+  {
+    size_t row_size= stmt->param_count;
+
+    _stmt_bind_row(stmt, stmt->bulk_row);
+    for (current_param= 0; current_param < stmt->param_count; current_param++)
+    {
+      row_size+= _stmt_param_size(&stmt->query_params[current_param]);
+    }
+    if (row_size > (size_t)(end - ptr))
+    {
+      break;
+    }
+
+    for (current_param= 0; current_param < stmt->param_count; current_param++)
+    {
+      param_ptr= &stmt->query_params[current_param];
+      if (param_ptr->options.is_null || param_ptr->type == DRIZZLE_COLUMN_TYPE_NULL)
+      {
+        *ptr++= DRIZZLE_STMT_BULK_INDICATOR_NULL;
+        continue;
+      }
+
+      *ptr++= DRIZZLE_STMT_BULK_INDICATOR_NONE;
+      ptr= _stmt_param_pack(stmt, param_ptr, ptr);
+      if (ptr == NULL)
+      {
+        *ret_ptr= DRIZZLE_RETURN_UNEXPECTED_DATA;
+        return NULL;
+      }
+    }
+    stmt->bulk_row++;
+  }
+
+  if (stmt->bulk_row == first_row)
+  {
+    return NULL;
+  }
+
+  drizzle_set_byte3(start, (size_t)(ptr - start) - 4);
+  start[3]= 0;
+
+  return ptr;
+}
+
+/* Whether an operation of the statement returned DRIZZLE_RETURN_IO_WAIT
+ * and waits to be continued. It is abandoned once the connection has been
+ * closed in the meantime. */
+static bool _stmt_pending(drizzle_stmt_st *stmt)
+{
+  if (stmt->pending == DRIZZLE_STMT_PENDING_NONE)
+  {
+    return false;
+  }
+
+  if (stmt->con->has_state())
+  {
+    stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+    return false;
+  }
+
+  return true;
+}
+
+/* Whether replies to queued executions, or the rows of the last one, have
+ * not been read yet. Other statement commands wait until they are. */
+static bool _stmt_queue_busy(drizzle_st *con)
+{
+  drizzle_stmt_st *current= con->stmt_queue_current;
+
+  if (con->stmt_queue_sent > 0 || con->stmt_queue_writing)
+  {
+    return true;
+  }
+
+  return current != NULL && current->execute_result != NULL &&
+         !current->execute_result->rows_read &&
+         !(current->execute_result->options & DRIZZLE_RESULT_BUFFER_ROW);
+}
+
+/* Whether the reply to an execution of stmt still has to be read */
+static bool _stmt_queued(drizzle_st *con, drizzle_stmt_st *stmt)
+{
+  uint32_t x;
+
+  for (x= 0; x < con->stmt_queue_count; x++)
+  {
+    if (con->stmt_queue[(con->stmt_queue_first + x) % con->stmt_queue_limit] == stmt)
+    {
+      return true;
+    }
+  }
+
+  return stmt == con->stmt_queue_current && _stmt_queue_busy(con);
+}
+
+/* Whether a statement is being prepared on the connection */
+static bool _stmt_preparing(drizzle_st *con)
+{
+  return con->stmt != NULL && con->stmt->state == DRIZZLE_STMT_NONE &&
+         _stmt_pending(con->stmt);
+}
+
+/* Carve slots bindings and their scratch buffers from one allocation: the
+ * bindings first, then DRIZZLE_BIND_BUFFER_SIZE bytes for each. The bound
+ * parameters of a previous arena move over, their values pointing into
+ * their own scratch buffer included. */
+static drizzle_return_t _stmt_bind_arena_alloc(drizzle_stmt_st *stmt,
+                                               uint32_t slots)
+{
+  char *arena= NULL;
+  drizzle_bind_st *binds;
+  char *buffers;
+
+  if (slots > 0)
+  {
+    arena= new (std::nothrow) char[slots * (sizeof(drizzle_bind_st) + DRIZZLE_BIND_BUFFER_SIZE)];
+    if (arena == NULL)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+  }
+
+  binds= (drizzle_bind_st *)arena;
+  buffers= arena + slots * sizeof(drizzle_bind_st);
+  for (uint32_t x= 0; x < slots; x++)
+  {
+    drizzle_bind_st *param= new (&binds[x]) drizzle_bind_st();
+    param->data_buffer= buffers + x * DRIZZLE_BIND_BUFFER_SIZE;
+
+    if (x < stmt->param_count && stmt->query_params != NULL)
+    {
+      drizzle_bind_st *old_param= &stmt->query_params[x];
+      char *data= (char *)old_param->data;
+
+      *param= *old_param;
+      param->data_buffer= buffers + x * DRIZZLE_BIND_BUFFER_SIZE;
+      memcpy(param->data_buffer, old_param->data_buffer, DRIZZLE_BIND_BUFFER_SIZE);
+      if (data >= old_param->data_buffer &&
+          data < old_param->data_buffer + DRIZZLE_BIND_BUFFER_SIZE)
+      {
+        param->data= param->data_buffer + (data - old_param->data_buffer);
+      }
+    }
+  }
+
+  delete[] stmt->bind_arena;
+  stmt->bind_arena= arena;
+  stmt->bind_arena_slots= slots;
+  stmt->query_params= stmt->param_count > 0 ? binds : NULL;
+  stmt->result_params= NULL;
+  stmt->result_params_count= 0;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+static void _stmt_free_result_params(drizzle_stmt_st *stmt)
+{
+  stmt->result_params= NULL;
+  stmt->result_params_count= 0;
+}
+
+/* Hand out the arena slots after the parameters to the result columns,
+ * unless the caller bound the columns. The arena is sized for the columns
+ * of the prepare reply and only grows when an execution returns more. */
+static drizzle_return_t _stmt_alloc_result_params(drizzle_stmt_st *stmt)
+{
+  uint16_t column_count= stmt->execute_result->column_count;
+  drizzle_bind_st *binds;
+
+  if (stmt->result_binds != NULL)
+  {
+    _stmt_free_result_params(stmt);
+    return DRIZZLE_RETURN_OK;
+  }
+
+  if ((uint32_t)stmt->param_count + column_count > stmt->bind_arena_slots)
+  {
+    drizzle_return_t ret;
+
+    ret= _stmt_bind_arena_alloc(stmt, (uint32_t)stmt->param_count + column_count);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+  }
+
+  binds= (drizzle_bind_st *)stmt->bind_arena + stmt->param_count;
+  for (uint16_t x= 0; x < column_count; x++)
+  {
+    char *buffer= binds[x].data_buffer;
+
+    binds[x]= drizzle_bind_st();
+    binds[x].data_buffer= buffer;
+  }
+  stmt->result_params= column_count > 0 ? binds : NULL;
+  stmt->result_params_count= column_count;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Free the local memory of a statement, without contacting the server */
+static void _stmt_free(drizzle_stmt_st *stmt)
+{
+  delete[] stmt->null_bitmap;
+  delete[] stmt->bind_arena;
+  stmt->bind_arena= NULL;
+  stmt->bind_arena_slots= 0;
+  stmt->query_params= NULL;
+  _stmt_free_result_params(stmt);
+  delete[] stmt->result_binds;
   if (stmt->execute_result)
   {
     drizzle_result_free(stmt->execute_result);
-    stmt->execute_result= NULL;
+  }
+  if (stmt->prepare_result)
+  {
+    drizzle_result_free(stmt->prepare_result);
+  }
+  if (stmt->con->stmt == stmt)
+  {
+    stmt->con->stmt= NULL;
+  }
+  if (stmt->con->stmt_queue_current == stmt)
+  {
+    stmt->con->stmt_queue_current= NULL;
+  }
+
+  delete[] stmt->cache_query;
+  delete[] stmt->columns;
+  delete[] stmt->execute_buffer;
+  delete stmt;
+}
+
+/* Keep the column definitions of the previous result set before it is
+ * reset. The server only sends them again when they change if metadata
+ * caching is on, otherwise the allocation is reused. */
+static void _stmt_keep_columns(drizzle_stmt_st *stmt)
+{
+  drizzle_result_st *result= stmt->execute_result;
+
+  if (result->column_buffer == NULL)
+  {
+    return;
+  }
+
+  delete[] stmt->columns;
+  stmt->columns= result->column_buffer;
+  stmt->columns_count= result->column_count;
+  result->column_buffer= NULL;
+}
+
+/* Give the result set the column definitions the server skipped */
+static drizzle_return_t _stmt_reuse_columns(drizzle_stmt_st *stmt)
+{
+  drizzle_result_st *result= stmt->execute_result;
+  drizzle_column_st *columns= stmt->columns;
+
+  if (columns == NULL || stmt->columns_count != result->column_count)
+  {
+    /* Not executed before, the definitions sent with the prepare apply */
+    if (stmt->prepare_result->column_count != result->column_count)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__,
+                        "column definitions skipped but not known");
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+
+    columns= new (std::nothrow) drizzle_column_st[result->column_count];
+    if (columns == NULL)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+
+    for (uint16_t x= 0; x < result->column_count; x++)
+    {
+      if (drizzle_column_copy(&columns[x], &stmt->prepare_result->column_buffer[x]) != DRIZZLE_RETURN_OK)
+      {
+        delete[] columns;
+        drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
+        return DRIZZLE_RETURN_MEMORY;
+      }
+    }
+    delete[] stmt->columns;
+  }
+
+  stmt->columns= NULL;
+  stmt->columns_count= 0;
+
+  for (uint16_t x= 0; x < result->column_count; x++)
+  {
+    columns[x].result= result;
+  }
+  result->column_buffer= columns;
+  result->column_current= 0;
+  result->options= (drizzle_result_options_t)((int)result->options | (int)DRIZZLE_RESULT_BUFFER_COLUMN);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Buffer the column definitions of a new result set */
+static drizzle_return_t _stmt_buffer_columns(drizzle_stmt_st *stmt)
+{
+  drizzle_result_st *result= stmt->execute_result;
+
+  if (result->metadata_skipped)
+  {
+    return _stmt_reuse_columns(stmt);
+  }
+
+  if (stmt->columns != NULL && stmt->columns_count == result->column_count)
+  {
+    result->column_buffer= stmt->columns;
+    stmt->columns= NULL;
+    stmt->columns_count= 0;
+  }
+
+  return drizzle_column_buffer(result);
+}
+
+/* Execute with the parameters packed into the statement's own buffer, for
+ * packets which do not fit into the connection buffer */
+static drizzle_return_t _stmt_execute_buffered(drizzle_stmt_st *stmt,
+                                               size_t size)
+{
+  unsigned char *end;
+  drizzle_return_t ret;
+
+  if (stmt->execute_buffer_size < size)
+  {
+    delete[] stmt->execute_buffer;
+    stmt->execute_buffer= new (std::nothrow) unsigned char[size];
+    if (stmt->execute_buffer == NULL)
+    {
+      stmt->execute_buffer_size= 0;
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    stmt->execute_buffer_size= size;
+  }
+
+  end= _stmt_execute_pack(stmt, stmt->execute_buffer);
+  if (end == NULL)
+  {
+    return DRIZZLE_RETURN_UNEXPECTED_DATA;
+  }
+  size= (size_t)(end - stmt->execute_buffer);
+  stmt->new_bind= false;
+
+  if (stmt->execute_result)
+  {
+    drizzle_result_free(stmt->execute_result);
+    stmt->execute_result= NULL;
+  }
+
+  stmt->execute_result= drizzle_command_write(stmt->con, NULL,
+                                              DRIZZLE_COMMAND_STMT_EXECUTE,
+                                              stmt->execute_buffer, size,
+                                              size, &ret);
+
+  return ret;
+}
+
+/* FNV-1a hash of the statement text */
+static uint32_t _stmt_cache_hash(const char *statement, size_t size)
+{
+  uint32_t hash= 2166136261U;
+
+  for (size_t x= 0; x < size; x++)
+  {
+    hash^= (unsigned char)statement[x];
+    hash*= 16777619U;
+  }
+
+  return hash;
+}
+
+static drizzle_stmt_st **_stmt_cache_bucket(drizzle_st *con, uint32_t hash)
+{
+  return &con->stmt_cache_buckets[hash & (con->stmt_cache_bucket_count - 1)];
+}
+
+/* Grow the hash index of the cache to a bucket for every cached statement.
+ * Returns false if there is no index and no memory for one. */
+static bool _stmt_cache_index(drizzle_st *con)
+{
+  uint32_t bucket_count= 16;
+  drizzle_stmt_st **buckets;
+
+  while (bucket_count < con->stmt_cache_size && bucket_count < (1U << 20))
+  {
+    bucket_count*= 2;
+  }
+
+  if (bucket_count <= con->stmt_cache_bucket_count)
+  {
+    return true;
+  }
+
+  /* Without memory the smaller index only makes longer chains */
+  buckets= new (std::nothrow) drizzle_stmt_st *[bucket_count];
+  if (buckets == NULL)
+  {
+    return con->stmt_cache_buckets != NULL;
+  }
+  memset(buckets, 0, bucket_count * sizeof(drizzle_stmt_st *));
+
+  delete[] con->stmt_cache_buckets;
+  con->stmt_cache_buckets= buckets;
+  con->stmt_cache_bucket_count= bucket_count;
+
+  for (drizzle_stmt_st *stmt= con->stmt_cache_list; stmt != NULL;
+       stmt= stmt->cache_next)
+  {
+    drizzle_stmt_st **bucket= _stmt_cache_bucket(con, stmt->cache_hash);
+    stmt->cache_bucket_next= *bucket;
+    *bucket= stmt;
+  }
+
+  return true;
+}
+
+static void _stmt_cache_unlink(drizzle_st *con, drizzle_stmt_st *stmt)
+{
+  drizzle_stmt_st **bucket;
+
+  for (bucket= _stmt_cache_bucket(con, stmt->cache_hash); *bucket != stmt;
+       bucket= &(*bucket)->cache_bucket_next)
+  { }
+  *bucket= stmt->cache_bucket_next;
+  stmt->cache_bucket_next= NULL;
+
+  if (stmt->cache_prev == NULL)
+  {
+    con->stmt_cache_list= stmt->cache_next;
+  }
+  else
+  {
+    stmt->cache_prev->cache_next= stmt->cache_next;
+  }
+
+  if (stmt->cache_next == NULL)
+  {
+    con->stmt_cache_last= stmt->cache_prev;
+  }
+  else
+  {
+    stmt->cache_next->cache_prev= stmt->cache_prev;
+  }
+
+  stmt->cache_next= NULL;
+  stmt->cache_prev= NULL;
+  con->stmt_cache_count--;
+}
+
+static void _stmt_cache_link_first(drizzle_st *con, drizzle_stmt_st *stmt)
+{
+  drizzle_stmt_st **bucket= _stmt_cache_bucket(con, stmt->cache_hash);
+
+  stmt->cache_bucket_next= *bucket;
+  *bucket= stmt;
+
+  stmt->cache_prev= NULL;
+  stmt->cache_next= con->stmt_cache_list;
+  if (con->stmt_cache_list == NULL)
+  {
+    con->stmt_cache_last= stmt;
+  }
+  else
+  {
+    con->stmt_cache_list->cache_prev= stmt;
+  }
+  con->stmt_cache_list= stmt;
+  con->stmt_cache_count++;
+}
+
+/* Queue closing the server side statement along with the next command sent
+ * on the connection */
+static void _stmt_queue_close(drizzle_st *con, drizzle_stmt_st *stmt)
+{
+  /* Statements from an earlier connection are already gone on the server */
+  if (stmt->cache_generation == con->generation)
+  {
+    if (con->stmt_close_count == con->stmt_close_allocation)
+    {
+      uint32_t allocation= con->stmt_close_allocation == 0 ? 8 : con->stmt_close_allocation * 2;
+      uint32_t *ids= (uint32_t *)realloc(con->stmt_close_ids,
+                                         allocation * sizeof(uint32_t));
+      if (ids != NULL)
+      {
+        con->stmt_close_ids= ids;
+        con->stmt_close_allocation= allocation;
+      }
+    }
+
+    /* Without memory the statement is left for the server to free when the
+     * connection closes. */
+    if (con->stmt_close_count < con->stmt_close_allocation)
+    {
+      con->stmt_close_ids[con->stmt_close_count]= stmt->id;
+      con->stmt_close_count++;
+    }
+  }
+}
+
+/* Remove a statement from the cache and free it. The server side statement
+ * is closed along with the next command sent on the connection. */
+static void _stmt_cache_evict(drizzle_st *con, drizzle_stmt_st *stmt)
+{
+  _stmt_cache_unlink(con, stmt);
+  _stmt_queue_close(con, stmt);
+  _stmt_free(stmt);
+}
+
+/* Evict the least recently used statement which is neither held by a caller
+ * nor has queued executions. Returns false if there is none. */
+static bool _stmt_cache_evict_last(drizzle_st *con)
+{
+  drizzle_stmt_st *stmt;
+
+  for (stmt= con->stmt_cache_last; stmt != NULL; stmt= stmt->cache_prev)
+  {
+    if (stmt->cache_users == 0 && !_stmt_queued(con, stmt))
+    {
+      _stmt_cache_evict(con, stmt);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/* Evict statements until at most size are cached or the rest are in use */
+static void _stmt_cache_trim(drizzle_st *con, uint32_t size)
+{
+  while (con->stmt_cache_count > size)
+  {
+    if (!_stmt_cache_evict_last(con))
+    {
+      break;
+    }
+  }
+}
+
+static drizzle_return_t _stmt_check_long_data(drizzle_stmt_st *stmt,
+                                              uint16_t param_num)
+{
+  if ((stmt == NULL) || (param_num >= stmt->param_count))
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (stmt->state < DRIZZLE_STMT_PREPARED)
+  {
+    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "stmt object has not been prepared");
+    return DRIZZLE_RETURN_STMT_ERROR;
+  }
+
+  if (!stmt->con->state.ready || !stmt->con->has_state() ||
+      _stmt_queue_busy(stmt->con))
+  {
+    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "connection not ready");
+    return DRIZZLE_RETURN_NOT_READY;
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Send the long data packets still to be sent */
+static drizzle_return_t _stmt_continue_long_data(drizzle_stmt_st *stmt)
+{
+  drizzle_return_t ret= drizzle_state_loop(stmt->con);
+
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return ret;
+  }
+
+  stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  stmt->long_data_iov= NULL;
+  stmt->long_data_iov_count= 0;
+  stmt->long_data_fd= -1;
+  stmt->con->write_iov_count= 0;
+
+  if (ret == DRIZZLE_RETURN_OK)
+  {
+    stmt->query_params[stmt->long_data_param].options.is_long_data= true;
+  }
+
+  return ret;
+}
+
+/* Stream the long data set up on the statement in chunked packets. The
+ * server does not reply to them. */
+static drizzle_return_t _stmt_send_long_data(drizzle_stmt_st *stmt,
+                                             uint16_t param_num)
+{
+  drizzle_st *con= stmt->con;
+
+  con->stmt= stmt;
+  con->command= DRIZZLE_COMMAND_STMT_SEND_LONG_DATA;
+  stmt->long_data_param= param_num;
+  stmt->long_data_sent= false;
+  stmt->pending= DRIZZLE_STMT_PENDING_LONG_DATA;
+
+  con->push_state(drizzle_state_stmt_long_data_write);
+
+  return _stmt_continue_long_data(stmt);
+}
+
+/* Set the window of bulk executions written before their replies are read.
+ * Bounding the window keeps the unread replies from filling the socket
+ * buffers while we are still writing. A COM_STMT_BULK_EXECUTE has a single
+ * reply, its window ends with the rows which fit into the packet. */
+static void _stmt_bulk_window(drizzle_stmt_st *stmt)
+{
+  stmt->bulk_window_end= stmt->bulk_row_count;
+  if (!stmt->bulk_native &&
+      stmt->bulk_row_count - stmt->bulk_row > DRIZZLE_STMT_BULK_WINDOW)
+  {
+    stmt->bulk_window_end= stmt->bulk_row + DRIZZLE_STMT_BULK_WINDOW;
+  }
+
+  stmt->pending= DRIZZLE_STMT_PENDING_BULK_WRITE;
+  stmt->con->push_state(drizzle_state_stmt_execute_write);
+}
+
+/* Write the windows of bulk executions and read their replies */
+static drizzle_return_t _stmt_continue_bulk(drizzle_stmt_st *stmt)
+{
+  drizzle_st *con= stmt->con;
+  drizzle_result_st *result= stmt->execute_result;
+  drizzle_return_t ret;
+
+  while (1)
+  {
+    if (stmt->pending == DRIZZLE_STMT_PENDING_BULK_WRITE)
+    {
+      ret= drizzle_state_loop(con);
+      if (ret == DRIZZLE_RETURN_IO_WAIT)
+      {
+        return ret;
+      }
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+        return ret;
+      }
+      stmt->pending= DRIZZLE_STMT_PENDING_BULK_READ;
+    }
+
+    while (stmt->bulk_read_row < stmt->bulk_window_end)
+    {
+      if (con->has_state())
+      {
+        con->result= result;
+        con->packet_number= 1;
+        result->affected_rows= 0;
+        result->insert_id= 0;
+        con->push_state(drizzle_state_result_read);
+        con->push_state(drizzle_state_packet_read);
+      }
+
+      ret= drizzle_state_loop(con);
+      if (ret == DRIZZLE_RETURN_IO_WAIT)
+      {
+        return ret;
+      }
+
+      if (ret == DRIZZLE_RETURN_OK)
+      {
+        stmt->bulk_affected_rows+= result->affected_rows;
+        if (stmt->bulk_insert_id == 0)
+        {
+          stmt->bulk_insert_id= result->insert_id;
+        }
+      }
+      else if (ret == DRIZZLE_RETURN_ERROR_CODE)
+      {
+        /* Keep reading the replies of the rows already sent, but report the
+         * first failure. A failed COM_STMT_BULK_EXECUTE reports its first
+         * row. */
+        if (!stmt->bulk_failed)
+        {
+          stmt->bulk_failed= true;
+          stmt->bulk_error_row= stmt->bulk_read_row;
+        }
+      }
+      else
+      {
+        stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+        return ret;
+      }
+
+      if (stmt->bulk_native)
+      {
+        stmt->bulk_read_row= stmt->bulk_window_end;
+      }
+      else
+      {
+        stmt->bulk_read_row++;
+      }
+    }
+
+    if (stmt->bulk_failed || stmt->bulk_row == stmt->bulk_row_count)
+    {
+      break;
+    }
+
+    _stmt_bulk_window(stmt);
+  }
+
+  stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  result->affected_rows= stmt->bulk_affected_rows;
+  result->insert_id= stmt->bulk_insert_id;
+  stmt->state= DRIZZLE_STMT_EXECUTED;
+
+  if (stmt->bulk_failed)
+  {
+    return DRIZZLE_RETURN_ERROR_CODE;
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Finish reading the reply to COM_STMT_EXECUTE, given the return of the
+ * state loop reading its header */
+static drizzle_return_t _stmt_execute_reply(drizzle_stmt_st *stmt,
+                                            drizzle_return_t ret)
+{
+  drizzle_result_st *result;
+
+  if (stmt->pending == DRIZZLE_STMT_PENDING_EXECUTE)
+  {
+    if (ret == DRIZZLE_RETURN_IO_WAIT)
+    {
+      return ret;
+    }
+
+    stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+
+    stmt->state= DRIZZLE_STMT_EXECUTED;
+
+    result= stmt->execute_result;
+    result->binary_rows= true;
+    result->options= (drizzle_result_options_t)((uint8_t)result->options | (uint8_t)DRIZZLE_RESULT_BINARY_ROWS);
+
+    if (result->column_count == 0)
+    {
+      return DRIZZLE_RETURN_OK;
+    }
+    stmt->pending= DRIZZLE_STMT_PENDING_EXECUTE_COLUMNS;
+  }
+
+  /* The column definitions follow the reply */
+  ret= _stmt_buffer_columns(stmt);
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return ret;
+  }
+
+  stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  if (ret == DRIZZLE_RETURN_OK)
+  {
+    ret= _stmt_alloc_result_params(stmt);
+  }
+
+  return ret;
+}
+
+/* Read the rows of the last queued execution the caller left unread */
+static drizzle_return_t _stmt_queue_skip_rows(drizzle_st *con)
+{
+  drizzle_result_st *result= con->stmt_queue_current->execute_result;
+  drizzle_return_t ret= DRIZZLE_RETURN_OK;
+  drizzle_row_t row;
+
+  while (!result->rows_read && !(result->options & DRIZZLE_RESULT_BUFFER_ROW))
+  {
+    row= drizzle_row_buffer(result, &ret);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
+    if (row == NULL)
+    {
+      break;
+    }
+    drizzle_row_free(result, row);
+  }
+
+  con->stmt_queue_current= NULL;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/* Decode the next row straight into the buffers bound with
+ * drizzle_stmt_bind_result(). Unbuffered rows are decoded from the
+ * connection buffer, without copying the fields first. */
+static drizzle_return_t _stmt_fetch_bound(drizzle_stmt_st *stmt)
+{
+  drizzle_result_st *result= stmt->execute_result;
+  drizzle_return_t ret= DRIZZLE_RETURN_OK;
+  drizzle_return_t field_ret;
+  drizzle_row_t row= NULL;
+  const unsigned char *field;
+  size_t size;
+  uint16_t column;
+  uint16_t current_field= 0;
+  bool buffered= result->options & DRIZZLE_RESULT_BUFFER_ROW;
+
+  if (buffered)
+  {
+    row= drizzle_row_next(result);
+    if (row == NULL)
+    {
+      return DRIZZLE_RETURN_ROW_END;
+    }
+  }
+  else if (drizzle_row_read(result, &ret) == 0 || ret != DRIZZLE_RETURN_OK)
+  {
+    return ret == DRIZZLE_RETURN_OK ? DRIZZLE_RETURN_ROW_END : ret;
+  }
+
+  /* Every field is read even after a failed conversion, so the next row
+   * starts at the right place */
+  for (column= 0; column < result->column_count; column++)
+  {
+    drizzle_result_bind_st *bind= NULL;
+
+    if (column < stmt->result_binds_count && stmt->result_binds[column].is_bound)
+    {
+      bind= &stmt->result_binds[column];
+    }
+
+    /* NULL fields are only in the bitmap, which skips the first 2 bits */
+    if (result->null_bitmap[(column + 2) / 8] & (1 << ((column + 2) % 8)))
+    {
+      if (bind != NULL && bind->is_null != NULL)
+      {
+        *bind->is_null= true;
+      }
+      if (bind != NULL && bind->length != NULL)
+      {
+        *bind->length= 0;
+      }
+      continue;
+    }
+
+    if (buffered)
+    {
+      field= (const unsigned char *)row[current_field];
+      size= result->field_sizes[current_field];
+    }
+    else
+    {
+      field= (const unsigned char *)drizzle_field_read(result, NULL, &size,
+                                                        NULL, &field_ret);
+      if (field_ret != DRIZZLE_RETURN_OK)
+      {
+        return field_ret;
+      }
+    }
+    current_field++;
+
+    if (bind == NULL)
+    {
+      continue;
+    }
+
+    field_ret= drizzle_stmt_bind_field(bind, &result->column_buffer[column],
+                                       field, size);
+    if (field_ret == DRIZZLE_RETURN_TRUNCATED)
+    {
+      if (ret == DRIZZLE_RETURN_OK)
+      {
+        ret= field_ret;
+      }
+    }
+    else if (field_ret != DRIZZLE_RETURN_OK)
+    {
+      if (ret == DRIZZLE_RETURN_OK || ret == DRIZZLE_RETURN_TRUNCATED)
+      {
+        drizzle_set_error(stmt->con, __FILE_LINE_FUNC__,
+                          "cannot convert column %" PRIu16, column);
+        ret= field_ret;
+      }
+    }
+  }
+
+  if (!buffered)
+  {
+    delete[] result->null_bitmap;
+    result->null_bitmap= NULL;
+  }
+  stmt->state= DRIZZLE_STMT_FETCHED;
+
+  return ret;
+}
+
+/*
+ * State definitions
+ */
+
+drizzle_return_t drizzle_state_stmt_execute_write(drizzle_st *con)
+{
+  drizzle_stmt_st *stmt;
+  unsigned char *start;
+  unsigned char *end;
+  size_t packet_size;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  __LOG_LOCATION__
+
+  stmt= con->stmt;
+
+  if (con->buffer_size == 0)
+  {
+    con->buffer_ptr= con->buffer;
+  }
+
+  if (con->stmt_close_count > 0)
+  {
+    start= con->buffer_ptr + con->buffer_size;
+    if ((size_t)(start - con->buffer) + DRIZZLE_STMT_CLOSE_PACKET_SIZE * con->stmt_close_count <= con->buffer_allocation)
+    {
+      end= drizzle_stmt_close_pending(con, start,
+                                      con->buffer_allocation - (size_t)(start - con->buffer));
+      con->buffer_size+= (size_t)(end - start);
+    }
+  }
+
+  if (stmt->bulk_native)
+  {
+    drizzle_return_t ret;
+    size_t size;
+
+    start= con->buffer_ptr + con->buffer_size;
+    size= con->buffer_allocation - (size_t)(start - con->buffer);
+    if (size > 4 + DRIZZLE_MAX_PAYLOAD_SIZE)
+    {
+      size= 4 + DRIZZLE_MAX_PAYLOAD_SIZE;
+    }
+
+    end= _stmt_bulk_pack(stmt, start, size, &ret);
+    if (end == NULL)
+    {
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        return ret;
+      }
+
+      /* Try again once the closes in front of it are written */
+      if (con->buffer_size > 0)
+      {
+        con->push_state(drizzle_state_write);
+        return DRIZZLE_RETURN_OK;
+      }
+
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "parameters of row %" PRIu32 " exceed the buffer size",
+                        stmt->bulk_row);
+      return DRIZZLE_RETURN_INTERNAL_ERROR;
+    }
+    con->buffer_size+= (size_t)(end - start);
+    stmt->bulk_window_end= stmt->bulk_row;
+
+    con->pop_state();
+    con->push_state(drizzle_state_write);
+
+    return DRIZZLE_RETURN_OK;
+  }
+
+  /* Pack as many executions as fit into the buffer, then send them all with
+   * a single write. */
+  while (stmt->bulk_row < stmt->bulk_window_end)
+  {
+    _stmt_bind_row(stmt, stmt->bulk_row);
+
+    packet_size= 1 + _stmt_execute_size(stmt);
+    if (packet_size > DRIZZLE_MAX_PAYLOAD_SIZE)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "parameters of row %" PRIu32 " exceed the packet size",
+                        stmt->bulk_row);
+      return DRIZZLE_RETURN_INTERNAL_ERROR;
+    }
+
+    start= con->buffer_ptr + con->buffer_size;
+    if ((size_t)(start - con->buffer) + 4 + packet_size > con->buffer_allocation)
+    {
+      if (con->buffer_size > 0)
+      {
+        break;
+      }
+
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "parameters of row %" PRIu32 " exceed the buffer size",
+                        stmt->bulk_row);
+      return DRIZZLE_RETURN_INTERNAL_ERROR;
+    }
+
+    start[3]= 0;
+    start[4]= (unsigned char)DRIZZLE_COMMAND_STMT_EXECUTE;
+    end= _stmt_execute_pack(stmt, start + 5);
+    if (end == NULL)
+    {
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+    drizzle_set_byte3(start, (size_t)(end - start) - 4);
+    con->buffer_size+= (size_t)(end - start);
+
+    /* The types are the same for every row */
+    stmt->new_bind= false;
+    stmt->bulk_row++;
+  }
+
+  if (stmt->bulk_row == stmt->bulk_window_end)
+  {
+    con->pop_state();
+  }
+
+  con->push_state(drizzle_state_write);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_state_stmt_long_data_write(drizzle_st *con)
+{
+  drizzle_stmt_st *stmt;
+  unsigned char *start;
+  size_t chunk_size= DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE;
+  size_t size= 0;
+  int count= 0;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  __LOG_LOCATION__
+
+  stmt= con->stmt;
+
+  /* Each packet carries the statement id and parameter in front of the data,
+   * later packets are appended to the earlier ones by the server. */
+  if (con->max_packet_size > 7 && con->max_packet_size - 7 < chunk_size)
+  {
+    chunk_size= con->max_packet_size - 7;
+  }
+
+  if (con->buffer_size == 0)
+  {
+    con->buffer_ptr= con->buffer;
+  }
+
+  start= con->buffer_ptr + con->buffer_size;
+  if (con->stmt_close_count > 0 &&
+      (size_t)(start - con->buffer) + DRIZZLE_STMT_CLOSE_PACKET_SIZE * con->stmt_close_count + 11 < con->buffer_allocation)
+  {
+    start= drizzle_stmt_close_pending(con, start,
+                                      con->buffer_allocation - (size_t)(start - con->buffer));
+    con->buffer_size= (size_t)(start - con->buffer_ptr);
+  }
+
+  if (stmt->long_data_fd != -1)
+  {
+    ssize_t read_size;
+
+    if (con->buffer_allocation - (size_t)(start - con->buffer) - 11 < chunk_size)
+    {
+      chunk_size= con->buffer_allocation - (size_t)(start - con->buffer) - 11;
+    }
+
+    do
+    {
+      read_size= read(stmt->long_data_fd, start + 11, chunk_size);
+    }
+    while (read_size == -1 && errno == EINTR);
+
+    if (read_size == -1)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "read: %s", strerror(errno));
+      con->last_errno= errno;
+      return DRIZZLE_RETURN_ERRNO;
+    }
+
+    size= (size_t)read_size;
+    if (size == 0)
+    {
+      con->pop_state();
+      if (stmt->long_data_sent)
+      {
+        if (con->buffer_size > 0)
+        {
+          con->push_state(drizzle_state_write);
+        }
+        return DRIZZLE_RETURN_OK;
+      }
+    }
+    con->buffer_size+= 11 + size;
+  }
+  else
+  {
+    /* Point the chunk at the caller's data, it is written right after the
+     * header without being copied */
+    while (stmt->long_data_iov_count > 0 && count < DRIZZLE_STMT_LONG_DATA_IOV_MAX &&
+           size < chunk_size)
+    {
+      const struct iovec *iov= stmt->long_data_iov;
+      size_t length= iov->iov_len - stmt->long_data_offset;
+
+      if (length > chunk_size - size)
+      {
+        length= chunk_size - size;
+      }
+
+      if (length > 0)
+      {
+        stmt->long_data_chunk[count].iov_base= (unsigned char *)iov->iov_base + stmt->long_data_offset;
+        stmt->long_data_chunk[count].iov_len= length;
+        count++;
+        size+= length;
+        stmt->long_data_offset+= length;
+      }
+
+      if (stmt->long_data_offset == iov->iov_len)
+      {
+        stmt->long_data_iov++;
+        stmt->long_data_iov_count--;
+        stmt->long_data_offset= 0;
+      }
+    }
+
+    if (stmt->long_data_iov_count == 0)
+    {
+      con->pop_state();
+    }
+
+    con->buffer_size+= 11;
+    con->write_iov= stmt->long_data_chunk;
+    con->write_iov_count= count;
+  }
+
+  drizzle_set_byte3(start, 7 + size);
+  start[3]= 0;
+  start[4]= (unsigned char)DRIZZLE_COMMAND_STMT_SEND_LONG_DATA;
+  drizzle_set_byte4(start + 5, stmt->id);
+  drizzle_set_byte2(start + 9, stmt->long_data_param);
+  stmt->long_data_sent= true;
+
+  con->push_state(drizzle_state_write);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+/*
+ * Public functions
+ */
+
+drizzle_stmt_st *drizzle_stmt_prepare(drizzle_st *con, const char *statement, size_t size, drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_stmt_st *stmt;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (con == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (_stmt_preparing(con))
+  {
+    stmt= con->stmt;
+  }
+  else
+  {
+    if (con->stmt != NULL && con->stmt->state == DRIZZLE_STMT_NONE)
+    {
+      /* The connection was closed while the statement was being prepared */
+      _stmt_free(con->stmt);
+    }
+
+    if (!con->has_state() || _stmt_queue_busy(con))
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      *ret_ptr= DRIZZLE_RETURN_NOT_READY;
+      return NULL;
+    }
+
+    stmt= new (std::nothrow) drizzle_stmt_st;
+    if (stmt == NULL)
+    {
+      *ret_ptr= DRIZZLE_RETURN_MEMORY;
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
+      return NULL;
+    }
+    con->stmt= stmt;
+    stmt->con= con;
+    stmt->cache_generation= con->generation;
+    stmt->pending= DRIZZLE_STMT_PENDING_PREPARE;
+  }
+
+  /* Until the statement is prepared it is only known to the connection, so
+   * a preparation which returned DRIZZLE_RETURN_IO_WAIT is continued by
+   * calling this function again. */
+  if (stmt->pending == DRIZZLE_STMT_PENDING_PREPARE)
+  {
+    stmt->prepare_result= drizzle_command_write(con, NULL, DRIZZLE_COMMAND_STMT_PREPARE,
+                                        statement, size, size, ret_ptr);
+    if (*ret_ptr == DRIZZLE_RETURN_IO_WAIT)
+    {
+      return NULL;
+    }
+    if (*ret_ptr != DRIZZLE_RETURN_OK)
+    {
+      _stmt_free(stmt);
+      return NULL;
+    }
+    stmt->prepare_skipped= 0;
+    stmt->pending= DRIZZLE_STMT_PENDING_PREPARE_PARAMS;
+  }
+
+  if (stmt->pending == DRIZZLE_STMT_PENDING_PREPARE_PARAMS)
+  {
+    /* Don't get the unused parameter packets.  Format is the same as column
+     * packets.  Deliberate off-by-one for the EOF packet */
+    while (stmt->param_count > 0 && stmt->prepare_skipped <= stmt->param_count)
+    {
+      *ret_ptr= drizzle_column_skip(stmt->prepare_result);
+      if (*ret_ptr == DRIZZLE_RETURN_IO_WAIT)
+      {
+        return NULL;
+      }
+      if ((*ret_ptr != DRIZZLE_RETURN_OK) && (*ret_ptr != DRIZZLE_RETURN_EOF))
+      {
+        _stmt_free(stmt);
+        return NULL;
+      }
+      stmt->prepare_skipped++;
+    }
+
+    /* Reset column counter which is incremented when skipping parameter
+     * packets and then buffer the columns */
+    stmt->prepare_result->column_current= 0;
+    stmt->pending= DRIZZLE_STMT_PENDING_PREPARE_COLUMNS;
+  }
+
+  *ret_ptr= drizzle_column_buffer(stmt->prepare_result);
+  if (*ret_ptr == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return NULL;
+  }
+  stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  if (*ret_ptr != DRIZZLE_RETURN_OK)
+  {
+    _stmt_free(stmt);
+    return NULL;
+  }
+
+  /* Parameter count can then be used to figure out the length of the null
+   * bitmap mask */
+
+  stmt->null_bitmap_length= (stmt->param_count + 7) / 8;
+  stmt->null_bitmap= new (std::nothrow) uint8_t[stmt->null_bitmap_length]();
+  if (stmt->null_bitmap == NULL)
+  {
+    _stmt_free(stmt);
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
+    return NULL;
+  }
+
+  /* One arena holds the parameters and the result columns of the prepare
+   * reply, reused by every execution */
+  *ret_ptr= _stmt_bind_arena_alloc(stmt, (uint32_t)stmt->param_count +
+                                         stmt->prepare_result->column_count);
+  if (*ret_ptr != DRIZZLE_RETURN_OK)
+  {
+    _stmt_free(stmt);
+    return NULL;
+  }
+  stmt->state= DRIZZLE_STMT_PREPARED;
+  stmt->fields= stmt->prepare_result->column_buffer;
+
+  return stmt;
+}
+
+drizzle_return_t drizzle_stmt_execute(drizzle_stmt_st *stmt)
+{
+  drizzle_st *con;
+  drizzle_result_st *result;
+  size_t size;
+  drizzle_return_t ret= DRIZZLE_RETURN_OK;
+
+  if (stmt == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  con= stmt->con;
+  if (_stmt_pending(stmt))
+  {
+    if (stmt->pending == DRIZZLE_STMT_PENDING_EXECUTE)
+    {
+      ret= drizzle_state_loop(con);
+    }
+    else if (stmt->pending != DRIZZLE_STMT_PENDING_EXECUTE_COLUMNS)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+  }
+  else
+  {
+    if (stmt->packed_params == NULL)
+    {
+      ret= _stmt_check_bound(stmt);
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        return ret;
+      }
+    }
+
+    if (!con->state.ready || !con->has_state() || _stmt_queue_busy(con))
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+
+    /* Parameters bound to arrays use their first entry */
+    _stmt_bind_row(stmt, 0);
+
+    if (stmt->execute_result)
+    {
+      _stmt_keep_columns(stmt);
+    }
+
+    size= _stmt_execute_size(stmt);
+    if (4 + 1 + size > con->buffer_allocation)
+    {
+      stmt->pending= DRIZZLE_STMT_PENDING_EXECUTE;
+      ret= _stmt_execute_buffered(stmt, size);
+    }
+    else
+    {
+      /* The packet is packed straight into the connection buffer and the
+       * result object of the previous execution is reused, so executing
+       * allocates nothing. */
+      result= stmt->execute_result;
+      if (result == NULL)
+      {
+        result= drizzle_result_create(con);
+        if (result == NULL)
+        {
+          return DRIZZLE_RETURN_MEMORY;
+        }
+        stmt->execute_result= result;
+      }
+      else
+      {
+        drizzle_result_reset(result);
+      }
+
+      con->result= result;
+      con->stmt= stmt;
+      con->command= DRIZZLE_COMMAND_STMT_EXECUTE;
+      con->packet_number= 1;
+      stmt->bulk_row= 0;
+      stmt->bulk_window_end= 1;
+      stmt->pending= DRIZZLE_STMT_PENDING_EXECUTE;
+
+      con->push_state(drizzle_state_result_read);
+      con->push_state(drizzle_state_packet_read);
+      con->push_state(drizzle_state_stmt_execute_write);
+      ret= drizzle_state_loop(con);
+    }
+  }
+
+  return _stmt_execute_reply(stmt, ret);
+}
+
+drizzle_return_t drizzle_stmt_execute_packed(drizzle_stmt_st *stmt,
+                                             uint16_t param_count,
+                                             const unsigned char *params,
+                                             size_t size)
+{
+  drizzle_return_t ret;
+
+  if (stmt == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (!_stmt_pending(stmt))
+  {
+    if (param_count != stmt->param_count || params == NULL ||
+        size < (size_t)stmt->null_bitmap_length + 1 + param_count * 2U)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__,
+                        "packed parameters do not match the statement");
+      return DRIZZLE_RETURN_INVALID_ARGUMENT;
+    }
+
+    for (uint16_t current_param= 0; current_param < stmt->param_count; current_param++)
+    {
+      if (stmt->query_params[current_param].options.is_long_data)
+      {
+        drizzle_set_error(stmt->con, __FILE_LINE_FUNC__,
+                          "long data cannot be sent with packed parameters");
+        return DRIZZLE_RETURN_STMT_ERROR;
+      }
+    }
+  }
+
+  /* The parameters may only be packed after an IO_WAIT, when commands
+   * queued before the execution have been written, so the caller passes
+   * them again to continue */
+  if (!_stmt_pending(stmt) || stmt->packed_params != NULL)
+  {
+    stmt->packed_params= params;
+    stmt->packed_params_size= size;
+  }
+  ret= drizzle_stmt_execute(stmt);
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return ret;
+  }
+  stmt->packed_params= NULL;
+  stmt->packed_params_size= 0;
+
+  /* The server now has the types of the packed parameters, the bound ones
+   * must send theirs again */
+  stmt->new_bind= true;
+
+  return ret;
+}
+
+drizzle_return_t drizzle_stmt_execute_bulk(drizzle_stmt_st *stmt,
+                                           uint32_t row_count)
+{
+  drizzle_st *con;
+  drizzle_result_st *result;
+  drizzle_return_t ret;
+
+  if (stmt == NULL || row_count == 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  con= stmt->con;
+
+  if (_stmt_pending(stmt))
+  {
+    if (stmt->pending != DRIZZLE_STMT_PENDING_BULK_WRITE &&
+        stmt->pending != DRIZZLE_STMT_PENDING_BULK_READ)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+
+    return _stmt_continue_bulk(stmt);
+  }
+
+  if (stmt->state < DRIZZLE_STMT_PREPARED)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "stmt object has not been prepared");
+    return DRIZZLE_RETURN_STMT_ERROR;
+  }
+
+  if (stmt->prepare_result->column_count > 0)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__,
+                      "bulk execution of statements returning rows is not supported");
+    return DRIZZLE_RETURN_STMT_ERROR;
+  }
+
+  ret= _stmt_check_bound(stmt);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  if (!con->state.ready || !con->has_state() || _stmt_queue_busy(con))
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+    return DRIZZLE_RETURN_NOT_READY;
+  }
+
+  result= stmt->execute_result;
+  if (result == NULL)
+  {
+    result= drizzle_result_create(con);
+    if (result == NULL)
+    {
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    stmt->execute_result= result;
+  }
+  else
+  {
+    drizzle_result_reset(result);
+  }
+
+  con->stmt= stmt;
+  con->command= DRIZZLE_COMMAND_STMT_EXECUTE;
+  stmt->bulk_row= 0;
+  stmt->bulk_row_count= row_count;
+  stmt->bulk_read_row= 0;
+  stmt->bulk_affected_rows= 0;
+  stmt->bulk_insert_id= 0;
+  stmt->bulk_failed= false;
+
+  /* Servers with bulk operations take all rows in one command, which cannot
+   * carry long data */
+  stmt->bulk_native= con->state.bulk_operations;
+  for (uint16_t x= 0; x < stmt->param_count; x++)
+  {
+    if (stmt->query_params[x].options.is_long_data)
+    {
+      stmt->bulk_native= false;
+    }
+  }
+
+  /* The executions are sent in windows, each written with as few writes as
+   * possible before all of its replies are read. */
+  _stmt_bulk_window(stmt);
+
+  return _stmt_continue_bulk(stmt);
+}
+
+uint32_t drizzle_stmt_bulk_error_row(drizzle_stmt_st *stmt)
+{
+  if (stmt == NULL)
+  {
+    return 0;
+  }
+
+  return stmt->bulk_error_row;
+}
+
+drizzle_return_t drizzle_stmt_queue(drizzle_stmt_st *stmt)
+{
+  drizzle_st *con;
+  drizzle_return_t ret;
+  uint16_t current_param;
+  size_t packet_size;
+  unsigned char *start;
+  unsigned char *end;
+
+  if (stmt == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  con= stmt->con;
+
+  if (stmt->state < DRIZZLE_STMT_PREPARED)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "stmt object has not been prepared");
+    return DRIZZLE_RETURN_STMT_ERROR;
+  }
+
+  if (_stmt_pending(stmt) || con->stmt_queue_writing)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+    return DRIZZLE_RETURN_NOT_READY;
+  }
+
+  if (con->stmt_queue_count >= con->stmt_queue_limit)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__,
+                      "%" PRIu32 " executions queued, read their replies first",
+                      con->stmt_queue_count);
+    return DRIZZLE_RETURN_NOT_READY;
+  }
+
+  ret= _stmt_check_bound(stmt);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  {
+    if (stmt->query_params[current_param].options.is_long_data)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__,
+                        "executions with long data cannot be queued");
+      return DRIZZLE_RETURN_STMT_ERROR;
+    }
+  }
+
+  if (con->stmt_queue == NULL)
+  {
+    con->stmt_queue= new (std::nothrow) drizzle_stmt_st*[con->stmt_queue_limit];
+    if (con->stmt_queue == NULL)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+  }
+
+  /* Parameters bound to arrays use their first entry */
+  _stmt_bind_row(stmt, 0);
+
+  packet_size= 1 + _stmt_execute_size(stmt);
+  if (packet_size > DRIZZLE_MAX_PAYLOAD_SIZE)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__,
+                      "parameters exceed the packet size");
+    return DRIZZLE_RETURN_INTERNAL_ERROR;
+  }
+
+  if (con->stmt_queue_size + 4 + packet_size > con->stmt_queue_allocation)
+  {
+    size_t allocation= con->stmt_queue_allocation == 0 ? DRIZZLE_DEFAULT_BUFFER_SIZE : con->stmt_queue_allocation;
+    unsigned char *buffer;
+
+    while (con->stmt_queue_size + 4 + packet_size > allocation)
+    {
+      allocation*= 2;
+    }
+
+    buffer= (unsigned char *)realloc(con->stmt_queue_buffer, allocation);
+    if (buffer == NULL)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "realloc");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    con->stmt_queue_buffer= buffer;
+    con->stmt_queue_allocation= allocation;
+  }
+
+  /* The parameters are packed now, so they can be changed for the next
+   * execution right away */
+  start= con->stmt_queue_buffer + con->stmt_queue_size;
+  start[3]= 0;
+  start[4]= (unsigned char)DRIZZLE_COMMAND_STMT_EXECUTE;
+  end= _stmt_execute_pack(stmt, start + 5);
+  if (end == NULL)
+  {
+    return DRIZZLE_RETURN_UNEXPECTED_DATA;
+  }
+  drizzle_set_byte3(start, (size_t)(end - start) - 4);
+  con->stmt_queue_size+= (size_t)(end - start);
+
+  /* The server knows the types from the earlier execution in the queue */
+  stmt->new_bind= false;
+
+  con->stmt_queue[(con->stmt_queue_first + con->stmt_queue_count) % con->stmt_queue_limit]= stmt;
+  con->stmt_queue_count++;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_stmt_queue_flush(drizzle_st *con)
+{
+  drizzle_return_t ret;
+  unsigned char *start;
+  unsigned char *end;
+  uint32_t generation;
+
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (!con->stmt_queue_writing)
+  {
+    if (con->stmt_queue_size == 0)
+    {
+      return DRIZZLE_RETURN_OK;
+    }
+
+    /* A reply which is partly read waits for the rest of it */
+    if (!con->state.ready || !con->has_state())
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+
+    if (con->stmt_queue_sent > 0)
+    {
+      /* Replies to the earlier executions may be in the connection buffer
+       * already. They are set aside while the new executions are written
+       * and read afterwards. */
+      con->stmt_queue_read_ptr= con->buffer_ptr;
+      con->stmt_queue_read_size= con->buffer_size;
+      con->buffer_size= 0;
+    }
+    else if (con->buffer_size == 0)
+    {
+      con->buffer_ptr= con->buffer;
+    }
+
+    if (con->stmt_close_count > 0 && con->stmt_queue_sent == 0)
+    {
+      start= con->buffer_ptr + con->buffer_size;
+      if ((size_t)(start - con->buffer) + DRIZZLE_STMT_CLOSE_PACKET_SIZE * con->stmt_close_count <= con->buffer_allocation)
+      {
+        end= drizzle_stmt_close_pending(con, start,
+                                        con->buffer_allocation - (size_t)(start - con->buffer));
+        con->buffer_size+= (size_t)(end - start);
+      }
+    }
+
+    /* All queued executions are sent with as few writes as possible,
+     * straight from the queue */
+    con->stmt_queue_iov.iov_base= con->stmt_queue_buffer;
+    con->stmt_queue_iov.iov_len= con->stmt_queue_size;
+    con->write_iov= &con->stmt_queue_iov;
+    con->write_iov_count= 1;
+    con->command= DRIZZLE_COMMAND_STMT_EXECUTE;
+    con->stmt_queue_writing= true;
+
+    con->push_state(drizzle_state_write);
+  }
+
+  generation= con->generation;
+  ret= drizzle_state_loop(con);
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return ret;
+  }
+
+  /* A lost connection has dropped the queue along with the buffer */
+  if (con->generation != generation)
+  {
+    return ret;
+  }
+
+  con->stmt_queue_writing= false;
+  con->write_iov_count= 0;
+  if (con->stmt_queue_sent > 0)
+  {
+    con->buffer_ptr= con->stmt_queue_read_ptr;
+    con->buffer_size= con->stmt_queue_read_size;
+  }
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  con->stmt_queue_sent= con->stmt_queue_count;
+  con->stmt_queue_size= 0;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_stmt_st *drizzle_stmt_queue_read(drizzle_st *con,
+                                         drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_stmt_st *stmt;
+  drizzle_result_st *result;
+  drizzle_return_t ret;
+  uint32_t generation;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (con == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  generation= con->generation;
+  stmt= con->stmt_queue_reading;
+  if (stmt != NULL && _stmt_pending(stmt))
+  {
+    ret= DRIZZLE_RETURN_OK;
+    if (stmt->pending == DRIZZLE_STMT_PENDING_EXECUTE)
+    {
+      ret= drizzle_state_loop(con);
+    }
+  }
+  else
+  {
+    if (con->stmt_queue_count == 0)
+    {
+      *ret_ptr= DRIZZLE_RETURN_OK;
+      return NULL;
+    }
+
+    if (con->stmt_queue_current != NULL)
+    {
+      ret= _stmt_queue_skip_rows(con);
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        *ret_ptr= ret;
+        return NULL;
+      }
+    }
+
+    /* Executions queued after the last flush are sent when there are no
+     * earlier ones to read replies to, a flush which returned
+     * DRIZZLE_RETURN_IO_WAIT is finished first */
+    if (con->stmt_queue_sent == 0 || con->stmt_queue_writing)
+    {
+      ret= drizzle_stmt_queue_flush(con);
+      if (ret != DRIZZLE_RETURN_OK)
+      {
+        *ret_ptr= ret;
+        return NULL;
+      }
+    }
+
+    stmt= con->stmt_queue[con->stmt_queue_first];
+
+    if (stmt->execute_result)
+    {
+      _stmt_keep_columns(stmt);
+    }
+
+    result= stmt->execute_result;
+    if (result == NULL)
+    {
+      result= drizzle_result_create(con);
+      if (result == NULL)
+      {
+        *ret_ptr= DRIZZLE_RETURN_MEMORY;
+        return NULL;
+      }
+      stmt->execute_result= result;
+    }
+    else
+    {
+      drizzle_result_reset(result);
+    }
+
+    con->result= result;
+    con->stmt= stmt;
+    con->command= DRIZZLE_COMMAND_STMT_EXECUTE;
+    con->packet_number= 1;
+    con->stmt_queue_reading= stmt;
+    stmt->pending= DRIZZLE_STMT_PENDING_EXECUTE;
+
+    con->push_state(drizzle_state_result_read);
+    con->push_state(drizzle_state_packet_read);
+    ret= drizzle_state_loop(con);
+  }
+
+  ret= _stmt_execute_reply(stmt, ret);
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    *ret_ptr= ret;
+    return NULL;
+  }
+
+  /* A lost connection has cleared the queue already */
+  if (con->generation == generation)
+  {
+    con->stmt_queue_reading= NULL;
+    con->stmt_queue_first= (con->stmt_queue_first + 1) % con->stmt_queue_limit;
+    con->stmt_queue_count--;
+    con->stmt_queue_sent--;
+    if (ret == DRIZZLE_RETURN_OK && stmt->execute_result->column_count > 0)
+    {
+      con->stmt_queue_current= stmt;
+    }
+  }
+
+  *ret_ptr= ret;
+  return stmt;
+}
+
+uint32_t drizzle_stmt_queue_count(const drizzle_st *con)
+{
+  if (con == NULL)
+  {
+    return 0;
+  }
+
+  return con->stmt_queue_count;
+}
+
+drizzle_return_t drizzle_set_stmt_queue_limit(drizzle_st *con, uint32_t limit)
+{
+  if (con == NULL || limit == 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (con->stmt_queue_count > 0)
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "executions are queued");
+    return DRIZZLE_RETURN_NOT_READY;
   }
 
-  /* Set buffer size to what we actually used */
-  buffer_size= data_pos - buffer;
+  delete[] con->stmt_queue;
+  con->stmt_queue= NULL;
+  con->stmt_queue_first= 0;
+  con->stmt_queue_limit= limit;
 
-  stmt->execute_result= drizzle_command_write(stmt->con, stmt->execute_result, DRIZZLE_COMMAND_STMT_EXECUTE, buffer, buffer_size, buffer_size, &ret);
+  return DRIZZLE_RETURN_OK;
+}
 
-  if (ret == DRIZZLE_RETURN_OK)
-  {
-    stmt->state= DRIZZLE_STMT_EXECUTED;
-  }
-  else
+uint32_t drizzle_stmt_queue_limit(const drizzle_st *con)
+{
+  if (con == NULL)
   {
-    delete[] buffer;
-    return ret;
+    return 0;
   }
 
-  stmt->new_bind= false;
+  return con->stmt_queue_limit;
+}
 
-  stmt->execute_result->binary_rows= true;
+void drizzle_stmt_queue_clear(drizzle_st *con)
+{
+  con->stmt_queue_size= 0;
+  con->stmt_queue_first= 0;
+  con->stmt_queue_count= 0;
+  con->stmt_queue_sent= 0;
+  con->stmt_queue_writing= false;
+  con->stmt_queue_reading= NULL;
+  con->stmt_queue_current= NULL;
+}
 
-  stmt->execute_result->options= (drizzle_result_options_t)((uint8_t)stmt->execute_result->options | (uint8_t)DRIZZLE_RESULT_BINARY_ROWS);
+drizzle_return_t drizzle_stmt_send_long_data(drizzle_stmt_st *stmt, uint16_t param_num, unsigned char *data, size_t len)
+{
+  if (stmt != NULL && stmt->pending == DRIZZLE_STMT_PENDING_LONG_DATA &&
+      _stmt_pending(stmt))
+  {
+    return _stmt_continue_long_data(stmt);
+  }
 
-  if (stmt->execute_result->column_count > 0)
+  /* Kept in the statement as the data may be sent after we return */
+  if (stmt != NULL)
   {
-    ret= drizzle_column_buffer(stmt->execute_result);
-    stmt->result_params= new (std::nothrow) drizzle_bind_st[stmt->execute_result->column_count];
+    stmt->long_data_single.iov_base= data;
+    stmt->long_data_single.iov_len= len;
+    return drizzle_stmt_send_long_data_iov(stmt, param_num,
+                                           &stmt->long_data_single, 1);
   }
 
-  delete[] buffer;
-  return ret;
+  return DRIZZLE_RETURN_INVALID_ARGUMENT;
 }
 
-drizzle_return_t drizzle_stmt_send_long_data(drizzle_stmt_st *stmt, uint16_t param_num, unsigned char *data, size_t len)
+drizzle_return_t drizzle_stmt_send_long_data_iov(drizzle_stmt_st *stmt,
+                                                 uint16_t param_num,
+                                                 const struct iovec *iov,
+                                                 int iovcnt)
 {
   drizzle_return_t ret;
-  unsigned char *buffer;
 
-  if ((stmt == NULL) || (param_num >= stmt->param_count))
+  if (stmt != NULL && stmt->pending == DRIZZLE_STMT_PENDING_LONG_DATA &&
+      _stmt_pending(stmt))
+  {
+    return _stmt_continue_long_data(stmt);
+  }
+
+  if (iovcnt < 0 || (iov == NULL && iovcnt > 0))
   {
     return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
 
-  if (stmt->state < DRIZZLE_STMT_PREPARED)
+  ret= _stmt_check_long_data(stmt, param_num);
+  if (ret != DRIZZLE_RETURN_OK)
   {
-    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "stmt object has not been prepared");
-    return DRIZZLE_RETURN_STMT_ERROR;
+    return ret;
   }
 
+  stmt->long_data_iov= iov;
+  stmt->long_data_iov_count= iovcnt;
+  stmt->long_data_offset= 0;
+  stmt->long_data_fd= -1;
 
-  /* TODO: rework drizzle_command_write so we can send a header and we don't
-   * need this copy
-   * */
-  buffer= new (std::nothrow) unsigned char[len + 6];
+  return _stmt_send_long_data(stmt, param_num);
+}
 
-  drizzle_set_byte4(buffer, stmt->id);
-  drizzle_set_byte2(&buffer[4], param_num);
-  memcpy(&buffer[6], data, len);
+drizzle_return_t drizzle_stmt_send_long_data_fd(drizzle_stmt_st *stmt,
+                                                uint16_t param_num, int fd)
+{
+  drizzle_return_t ret;
 
-  stmt->con->state.no_result_read= true;
-  drizzle_command_write(stmt->con, NULL, DRIZZLE_COMMAND_STMT_SEND_LONG_DATA,
-                        buffer, len+6, len+6, &ret);
-  stmt->con->state.no_result_read= false;
-  stmt->query_params[param_num].options.is_long_data= true;
+  if (stmt != NULL && stmt->pending == DRIZZLE_STMT_PENDING_LONG_DATA &&
+      _stmt_pending(stmt))
+  {
+    return _stmt_continue_long_data(stmt);
+  }
 
-  delete[] buffer;
-  return ret;
+  if (fd < 0)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  ret= _stmt_check_long_data(stmt, param_num);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  stmt->long_data_iov= NULL;
+  stmt->long_data_iov_count= 0;
+  stmt->long_data_fd= fd;
+
+  return _stmt_send_long_data(stmt, param_num);
 }
 
 drizzle_return_t drizzle_stmt_reset(drizzle_stmt_st *stmt)
 {
   drizzle_return_t ret;
+  drizzle_result_st *result;
   unsigned char buffer[4];
   uint16_t current_param;
+  drizzle_st *con;
 
   if (stmt == NULL)
   {
     return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
 
-  for (current_param= 0; current_param < stmt->param_count; current_param++)
+  con= stmt->con;
+  if (_stmt_pending(stmt))
+  {
+    if (stmt->pending != DRIZZLE_STMT_PENDING_RESET)
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+  }
+  else
   {
-    stmt->query_params[current_param].options.is_long_data= false;
+    if (!con->has_state() || _stmt_queue_busy(con))
+    {
+      drizzle_set_error(con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+
+    for (current_param= 0; current_param < stmt->param_count; current_param++)
+    {
+      stmt->query_params[current_param].options.is_long_data= false;
+    }
+    stmt->pending= DRIZZLE_STMT_PENDING_RESET;
   }
 
+  /* The server replies with an OK or error packet, which has to be read
+   * before the next command */
   drizzle_set_byte4(buffer, stmt->id);
-  stmt->con->state.no_result_read= true;
-  drizzle_command_write(stmt->con, NULL, DRIZZLE_COMMAND_STMT_RESET, buffer, 4,
-                        4, &ret);
-  stmt->con->state.no_result_read= false;
+  result= drizzle_command_write(con, NULL, DRIZZLE_COMMAND_STMT_RESET, buffer, 4,
+                                4, &ret);
+  if (ret == DRIZZLE_RETURN_IO_WAIT)
+  {
+    return ret;
+  }
+  stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  drizzle_result_free(result);
+
   if (stmt->execute_result)
   {
     drizzle_result_free(stmt->execute_result);
     stmt->execute_result= NULL;
   }
   stmt->state= DRIZZLE_STMT_PREPARED;
-  delete[] stmt->result_params;
+  _stmt_free_result_params(stmt);
 
   return ret;
 }
@@ -410,6 +2440,11 @@ drizzle_return_t drizzle_stmt_fetch(drizzle_stmt_st *stmt)
   }
   stmt->con->result= stmt->execute_result;
 
+  if (stmt->result_binds != NULL)
+  {
+    return _stmt_fetch_bound(stmt);
+  }
+
   /* Determine how to read the row based on whether or not it is already
    * buffered */
 
@@ -420,6 +2455,10 @@ drizzle_return_t drizzle_stmt_fetch(drizzle_stmt_st *stmt)
   else
   {
     row= drizzle_row_buffer(stmt->execute_result, &ret);
+    if (ret != DRIZZLE_RETURN_OK)
+    {
+      return ret;
+    }
   }
 
   if (row == NULL)
@@ -432,6 +2471,8 @@ drizzle_return_t drizzle_stmt_fetch(drizzle_stmt_st *stmt)
     drizzle_bind_st *param= &stmt->result_params[column_counter];
     drizzle_column_st *column= drizzle_column_index(stmt->execute_result, column_counter);
 
+    param->converted_length= 0;
+
     /* if this row is null in the result bitmap, skip first 2 bits */
     if (stmt->execute_result->null_bitmap[(column_counter+2)/8] & (1 << ((column_counter+2) % 8)))
     {
@@ -540,63 +2581,423 @@ drizzle_return_t drizzle_stmt_fetch(drizzle_stmt_st *stmt)
   return ret;
 }
 
+drizzle_return_t drizzle_stmt_bind_result(drizzle_stmt_st *stmt,
+                                          uint16_t column_number,
+                                          drizzle_column_type_t type,
+                                          void *buffer, size_t buffer_size,
+                                          size_t *length, bool *is_null)
+{
+  uint16_t column_count;
+
+  if (stmt == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (stmt->state < DRIZZLE_STMT_PREPARED)
+  {
+    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "stmt object has not been prepared");
+    return DRIZZLE_RETURN_STMT_ERROR;
+  }
+
+  column_count= stmt->prepare_result->column_count;
+  if (column_number >= column_count)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  switch (type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+      if (buffer == NULL)
+      {
+        return DRIZZLE_RETURN_INVALID_ARGUMENT;
+      }
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+      if (buffer == NULL && buffer_size > 0)
+      {
+        return DRIZZLE_RETURN_INVALID_ARGUMENT;
+      }
+      break;
+    case DRIZZLE_COLUMN_TYPE_NULL:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    default:
+      return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  if (stmt->result_binds == NULL)
+  {
+    stmt->result_binds= new (std::nothrow) drizzle_result_bind_st[column_count];
+    if (stmt->result_binds == NULL)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "new");
+      return DRIZZLE_RETURN_MEMORY;
+    }
+    stmt->result_binds_count= column_count;
+
+    /* The getters do not work with bound columns */
+    _stmt_free_result_params(stmt);
+  }
+
+  stmt->result_binds[column_number].type= type;
+  stmt->result_binds[column_number].buffer= buffer;
+  stmt->result_binds[column_number].buffer_size= buffer_size;
+  stmt->result_binds[column_number].length= length;
+  stmt->result_binds[column_number].is_null= is_null;
+  stmt->result_binds[column_number].is_bound= true;
+
+  return DRIZZLE_RETURN_OK;
+}
+
+drizzle_return_t drizzle_stmt_unbind_result(drizzle_stmt_st *stmt)
+{
+  if (stmt == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  delete[] stmt->result_binds;
+  stmt->result_binds= NULL;
+  stmt->result_binds_count= 0;
+
+  if (stmt->state >= DRIZZLE_STMT_EXECUTED && stmt->execute_result != NULL)
+  {
+    return _stmt_alloc_result_params(stmt);
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
 drizzle_return_t drizzle_stmt_buffer(drizzle_stmt_st *stmt)
 {
+  drizzle_return_t ret;
+
   if (stmt == NULL)
   {
     return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
-  if (stmt->state >= DRIZZLE_STMT_FETCHED)
+
+  if (_stmt_pending(stmt))
   {
-    drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "data set has already been read");
-    return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    if (stmt->pending != DRIZZLE_STMT_PENDING_BUFFER)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "connection not ready");
+      return DRIZZLE_RETURN_NOT_READY;
+    }
+  }
+  else
+  {
+    if (stmt->state >= DRIZZLE_STMT_FETCHED)
+    {
+      drizzle_set_error(stmt->con, __FILE_LINE_FUNC__, "data set has already been read");
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+    }
+
+    stmt->con->result= stmt->execute_result;
+    stmt->state= DRIZZLE_STMT_FETCHED;
+    stmt->pending= DRIZZLE_STMT_PENDING_BUFFER;
   }
 
-  stmt->con->result= stmt->execute_result;
-  stmt->state= DRIZZLE_STMT_FETCHED;
+  ret= drizzle_result_buffer(stmt->execute_result);
+  if (ret != DRIZZLE_RETURN_IO_WAIT)
+  {
+    stmt->pending= DRIZZLE_STMT_PENDING_NONE;
+  }
 
-  return drizzle_result_buffer(stmt->execute_result);
+  return ret;
 }
 
 drizzle_return_t drizzle_stmt_close(drizzle_stmt_st *stmt)
 {
   unsigned char buffer[4];
   drizzle_return_t ret;
+  drizzle_st *con;
 
   if (stmt == NULL)
   {
     return DRIZZLE_RETURN_INVALID_ARGUMENT;
   }
 
-  delete[] stmt->null_bitmap;
-  for (uint16_t x= 0; x < stmt->param_count; x++)
+  con= stmt->con;
+  if (_stmt_pending(stmt))
   {
-    delete[] stmt->query_params[x].data_buffer;
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "statement operation in progress");
+    return DRIZZLE_RETURN_NOT_READY;
   }
-  delete[] stmt->query_params;
-  if (stmt->execute_result)
+
+  if (_stmt_queued(con, stmt))
+  {
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "statement has queued executions");
+    return DRIZZLE_RETURN_NOT_READY;
+  }
+
+  /* A cached statement is released back to the cache and stays prepared,
+   * it is freed once it is evicted while no caller holds it */
+  if (stmt->cache_users > 0)
+  {
+    stmt->cache_users--;
+  }
+
+  if (stmt->cache_query != NULL)
   {
-    for (uint16_t x= 0; x < stmt->execute_result->column_count; x++)
+    if (stmt->cache_users == 0)
     {
-      delete[] stmt->result_params[x].data_buffer;
+      _stmt_cache_trim(con, con->stmt_cache_size);
     }
-    delete[] stmt->result_params;
-    drizzle_result_free(stmt->execute_result);
+    return DRIZZLE_RETURN_OK;
   }
-  if (stmt->prepare_result)
+
+  /* A statement which left the cache while held is freed by its last user */
+  if (stmt->cache_users > 0)
   {
-    drizzle_result_free(stmt->prepare_result);
+    return DRIZZLE_RETURN_OK;
+  }
+
+  /* Closing never waits on a non-blocking connection: the server does not
+   * reply, so the close is sent along with the next command */
+  if (con->options.non_blocking || !con->has_state() || _stmt_queue_busy(con))
+  {
+    _stmt_queue_close(con, stmt);
+    _stmt_free(stmt);
+    return DRIZZLE_RETURN_OK;
   }
 
   drizzle_set_byte4(buffer, stmt->id);
-  stmt->con->state.no_result_read= true;
-  drizzle_command_write(stmt->con, NULL, DRIZZLE_COMMAND_STMT_CLOSE, buffer, 4,
+  _stmt_free(stmt);
+
+  con->state.no_result_read= true;
+  drizzle_command_write(con, NULL, DRIZZLE_COMMAND_STMT_CLOSE, buffer, 4,
                         4, &ret);
-  stmt->con->state.no_result_read= false;
-  delete stmt;
+  con->state.no_result_read= false;
   return ret;
 }
 
+drizzle_stmt_st *drizzle_stmt_prepare_cached(drizzle_st *con,
+                                             const char *statement,
+                                             size_t size,
+                                             drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  drizzle_stmt_st *stmt;
+  uint32_t hash;
+
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if (con == NULL || statement == NULL)
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return NULL;
+  }
+
+  if (con->stmt_cache_size == 0)
+  {
+    return drizzle_stmt_prepare(con, statement, size, ret_ptr);
+  }
+
+  if (!_stmt_cache_index(con))
+  {
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
+    return NULL;
+  }
+
+  hash= _stmt_cache_hash(statement, size);
+
+  /* A preparation which returned DRIZZLE_RETURN_IO_WAIT is not looked up
+   * again */
+  for (stmt= _stmt_preparing(con) ? NULL : *_stmt_cache_bucket(con, hash);
+       stmt != NULL; stmt= stmt->cache_bucket_next)
+  {
+    if (stmt->cache_hash != hash || stmt->cache_query_size != size ||
+        memcmp(stmt->cache_query, statement, size) != 0)
+    {
+      continue;
+    }
+
+    if (stmt->cache_generation != con->generation)
+    {
+      /* Prepared on a previous connection, prepare it again. A statement
+       * still held by callers leaves the cache and is freed by the last
+       * drizzle_stmt_close(). */
+      if (stmt->cache_users == 0)
+      {
+        _stmt_cache_evict(con, stmt);
+      }
+      else
+      {
+        _stmt_cache_unlink(con, stmt);
+        delete[] stmt->cache_query;
+        stmt->cache_query= NULL;
+      }
+      break;
+    }
+
+    if (stmt != con->stmt_cache_list)
+    {
+      _stmt_cache_unlink(con, stmt);
+      _stmt_cache_link_first(con, stmt);
+    }
+    stmt->cache_users++;
+    con->stmt_cache_hits++;
+    *ret_ptr= DRIZZLE_RETURN_OK;
+    return stmt;
+  }
+
+  if (!_stmt_preparing(con))
+  {
+    con->stmt_cache_misses++;
+  }
+
+  stmt= drizzle_stmt_prepare(con, statement, size, ret_ptr);
+  if (stmt == NULL)
+  {
+    return NULL;
+  }
+
+  stmt->cache_query= new (std::nothrow) char[size > 0 ? size : 1];
+  if (stmt->cache_query == NULL)
+  {
+    drizzle_stmt_close(stmt);
+    *ret_ptr= DRIZZLE_RETURN_MEMORY;
+    drizzle_set_error(con, __FILE_LINE_FUNC__, "new");
+    return NULL;
+  }
+  memcpy(stmt->cache_query, statement, size);
+  stmt->cache_query_size= size;
+  stmt->cache_hash= hash;
+
+  /* Statements in use or with queued executions stay until they are
+   * released or their replies are read */
+  _stmt_cache_trim(con, con->stmt_cache_size - 1);
+  stmt->cache_users= 1;
+  _stmt_cache_link_first(con, stmt);
+
+  return stmt;
+}
+
+drizzle_return_t drizzle_set_stmt_cache_size(drizzle_st *con, uint32_t size)
+{
+  if (con == NULL)
+  {
+    return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  con->stmt_cache_size= size;
+  _stmt_cache_trim(con, size);
+
+  return DRIZZLE_RETURN_OK;
+}
+
+uint32_t drizzle_stmt_cache_size(const drizzle_st *con)
+{
+  if (con == NULL)
+  {
+    return 0;
+  }
+
+  return con->stmt_cache_size;
+}
+
+uint32_t drizzle_stmt_cache_count(const drizzle_st *con)
+{
+  if (con == NULL)
+  {
+    return 0;
+  }
+
+  return con->stmt_cache_count;
+}
+
+uint64_t drizzle_stmt_cache_hits(const drizzle_st *con)
+{
+  if (con == NULL)
+  {
+    return 0;
+  }
+
+  return con->stmt_cache_hits;
+}
+
+uint64_t drizzle_stmt_cache_misses(const drizzle_st *con)
+{
+  if (con == NULL)
+  {
+    return 0;
+  }
+
+  return con->stmt_cache_misses;
+}
+
+unsigned char *drizzle_stmt_close_pending(drizzle_st *con, unsigned char *ptr,
+                                          size_t size)
+{
+  uint32_t count= con->stmt_close_count;
+
+  if (size / DRIZZLE_STMT_CLOSE_PACKET_SIZE < count)
+  {
+    count= (uint32_t)(size / DRIZZLE_STMT_CLOSE_PACKET_SIZE);
+  }
+
+  for (uint32_t x= 0; x < count; x++)
+  {
+    drizzle_set_byte3(ptr, 5);
+    ptr[3]= 0;
+    ptr[4]= (unsigned char)DRIZZLE_COMMAND_STMT_CLOSE;
+    drizzle_set_byte4(ptr + 5, con->stmt_close_ids[x]);
+    ptr+= DRIZZLE_STMT_CLOSE_PACKET_SIZE;
+  }
+
+  con->stmt_close_count-= count;
+  memmove(con->stmt_close_ids, con->stmt_close_ids + count,
+          con->stmt_close_count * sizeof(uint32_t));
+
+  return ptr;
+}
+
+void drizzle_stmt_cache_free(drizzle_st *con)
+{
+  while (con->stmt_cache_list != NULL)
+  {
+    drizzle_stmt_st *stmt= con->stmt_cache_list;
+    _stmt_cache_unlink(con, stmt);
+    _stmt_free(stmt);
+  }
+
+  delete[] con->stmt_cache_buckets;
+  con->stmt_cache_buckets= NULL;
+  con->stmt_cache_bucket_count= 0;
+}
+
 uint16_t drizzle_stmt_column_count(drizzle_stmt_st *stmt)
 {
   if ((stmt == NULL) || (stmt->prepare_result == NULL))
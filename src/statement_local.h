@@ -43,6 +43,34 @@ extern "C" {
 
 drizzle_return_t drizzle_stmt_set_param(drizzle_stmt_st *stmt, uint16_t param_num, drizzle_column_type_t type, const void *data, size_t length, bool is_unsigned);
 
+void drizzle_stmt_bind_array_row(drizzle_bind_st *param, uint32_t row);
+
+/* Scratch space of each binding, holds a decoded value and its string form
+ * at offset 50 */
+#define DRIZZLE_BIND_BUFFER_SIZE 128
+
+/* Size of a COM_STMT_CLOSE packet: header, command byte and statement id */
+#define DRIZZLE_STMT_CLOSE_PACKET_SIZE 9
+
+/* MariaDB COM_STMT_BULK_EXECUTE, its flag to send the parameter types and
+ * the indicators in front of every parameter value */
+#define DRIZZLE_COMMAND_STMT_BULK_EXECUTE 0xFA
+#define DRIZZLE_STMT_BULK_SEND_TYPES 128
+#define DRIZZLE_STMT_BULK_INDICATOR_NONE 0
+#define DRIZZLE_STMT_BULK_INDICATOR_NULL 1
+
+/* Pack as many of the COM_STMT_CLOSE packets queued by statement cache
+ * evictions as fit into size bytes at ptr and remove them from the queue.
+ * Returns the end of the packed data. */
+unsigned char *drizzle_stmt_close_pending(drizzle_st *con, unsigned char *ptr,
+                                          size_t size);
+
+/* Free all statements in the statement cache without contacting the server */
+void drizzle_stmt_cache_free(drizzle_st *con);
+
+/* Drop the queued executions when the connection is closed */
+void drizzle_stmt_queue_clear(drizzle_st *con);
+
 char *long_to_string(drizzle_bind_st *param, uint32_t val);
 
 char *longlong_to_string(drizzle_bind_st *param, uint64_t val);
@@ -53,7 +81,31 @@ char *time_to_string(drizzle_bind_st *param, drizzle_datetime_st *time);
 
 char *timestamp_to_string(drizzle_bind_st *param, drizzle_datetime_st *timestamp);
 
-uint16_t drizzle_stmt_column_lookup(drizzle_result_st *result, const char *column_name, drizzle_return_t *ret_ptr);
+/* Format an integer into buffer, which holds at least 21 bytes. Returns the
+ * length of the terminated string. */
+size_t integer_format(char *buffer, uint64_t value, bool is_unsigned);
+
+/* Format the shortest string which reads back as the same double, or float
+ * if is_float, into buffer, which holds at least 32 bytes. Returns the
+ * length of the terminated string. */
+size_t double_format(char *buffer, double value, bool is_float);
+
+/* Format a time into buffer, which holds at least 17 bytes. Returns the
+ * length of the terminated string. */
+size_t time_format(char *buffer, const drizzle_datetime_st *time);
+
+/* Format a date or timestamp into buffer, which holds at least 27 bytes.
+ * Returns the length of the terminated string. */
+size_t timestamp_format(char *buffer, const drizzle_datetime_st *timestamp,
+                        bool date_only);
+
+/* Decode a binary protocol field of column into the buffer bound to it.
+ * Returns DRIZZLE_RETURN_TRUNCATED if the value did not fit. */
+drizzle_return_t drizzle_stmt_bind_field(drizzle_result_bind_st *bind,
+                                         drizzle_column_st *column,
+                                         const unsigned char *field,
+                                         size_t size);
+
 
 #ifdef __cplusplus
 }
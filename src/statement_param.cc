@@ -38,7 +38,9 @@
 #include "config.h"
 #include "src/common.h"
 
+#include <float.h>
 #include <inttypes.h>
+#include <math.h>
 
 #define CHECK_PARAM_NUM do { \
   if (stmt == NULL) return DRIZZLE_RETURN_INVALID_ARGUMENT; \
@@ -59,15 +61,171 @@ drizzle_return_t drizzle_stmt_set_param(drizzle_stmt_st *stmt, uint16_t param_nu
     return DRIZZLE_RETURN_STMT_ERROR;
   }
 
+  /* The server only learns about type changes with the next new bind */
+  if (stmt->query_params[param_num].type != type ||
+      stmt->query_params[param_num].options.is_unsigned != is_unsigned)
+  {
+    stmt->new_bind= true;
+  }
+
   stmt->query_params[param_num].type= type;
   stmt->query_params[param_num].data= (void*)data;
   stmt->query_params[param_num].length= length;
   stmt->query_params[param_num].options.is_unsigned= is_unsigned;
+  stmt->query_params[param_num].options.is_null= false;
+  stmt->query_params[param_num].options.is_array= false;
   stmt->query_params[param_num].is_bound= true;
 
   return DRIZZLE_RETURN_OK;
 }
 
+/* Internal function */
+void drizzle_stmt_bind_array_row(drizzle_bind_st *param, uint32_t row)
+{
+  const char *const *strings;
+
+  param->options.is_null= param->array_nulls != NULL && param->array_nulls[row];
+  param->data= NULL;
+  param->length= 0;
+
+  if (param->options.is_null)
+  {
+    return;
+  }
+
+  switch (param->type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+      param->data= (void*)((const uint8_t*)param->array_data + row);
+      param->length= 1;
+      break;
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+      param->data= (void*)((const uint16_t*)param->array_data + row);
+      param->length= 2;
+      break;
+    case DRIZZLE_COLUMN_TYPE_LONG:
+      param->data= (void*)((const uint32_t*)param->array_data + row);
+      param->length= 4;
+      break;
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+      param->data= (void*)((const uint64_t*)param->array_data + row);
+      param->length= 8;
+      break;
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+      param->data= (void*)((const float*)param->array_data + row);
+      param->length= 4;
+      break;
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      param->data= (void*)((const double*)param->array_data + row);
+      param->length= 8;
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+      strings= (const char *const *)param->array_data;
+      if (strings[row] == NULL)
+      {
+        param->options.is_null= true;
+        break;
+      }
+      param->data= (void*)strings[row];
+      param->length= param->array_lengths != NULL ? param->array_lengths[row]
+                                                  : strlen(strings[row]);
+      break;
+    case DRIZZLE_COLUMN_TYPE_NULL:
+      break;
+    /* Rejected by drizzle_stmt_set_param_array() */
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    default:
+      break;
+  }
+}
+
+
+drizzle_return_t drizzle_stmt_set_param_array(drizzle_stmt_st *stmt, uint16_t param_num, drizzle_column_type_t type, const void *values, const size_t *lengths, const bool *nulls, bool is_unsigned)
+{
+  drizzle_return_t ret;
+  drizzle_bind_st *param;
+
+  switch (type)
+  {
+    case DRIZZLE_COLUMN_TYPE_NULL:
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+      if (values == NULL)
+      {
+        return DRIZZLE_RETURN_INVALID_ARGUMENT;
+      }
+      break;
+    /* Arrays hold plain numbers or strings, temporal and other types have
+     * no packed element layout here. Bind temporal values as strings, the
+     * server converts them. */
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    default:
+      return DRIZZLE_RETURN_INVALID_ARGUMENT;
+  }
+
+  ret= drizzle_stmt_set_param(stmt, param_num, type, NULL, 0, is_unsigned);
+  if (ret != DRIZZLE_RETURN_OK)
+  {
+    return ret;
+  }
+
+  param= &stmt->query_params[param_num];
+  param->array_data= values;
+  param->array_lengths= lengths;
+  param->array_nulls= nulls;
+  param->options.is_array= true;
+  drizzle_stmt_bind_array_row(param, 0);
+
+  return DRIZZLE_RETURN_OK;
+}
 
 drizzle_return_t drizzle_stmt_set_tiny(drizzle_stmt_st *stmt, uint16_t param_num, uint8_t value, bool is_unsigned)
 {
@@ -186,7 +344,7 @@ bool drizzle_stmt_get_is_null_from_name(drizzle_stmt_st *stmt, const char *colum
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -214,7 +372,7 @@ bool drizzle_stmt_get_is_unsigned_from_name(drizzle_stmt_st *stmt, const char *c
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -242,7 +400,7 @@ const char *drizzle_stmt_get_string_from_name(drizzle_stmt_st *stmt, const char
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -271,39 +429,39 @@ const char *drizzle_stmt_get_string(drizzle_stmt_st *stmt, uint16_t column_numbe
       break;
     case DRIZZLE_COLUMN_TYPE_TINY:
       val= long_to_string(param, (uint32_t)(*(uint8_t*)param->data));
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_SHORT:
     case DRIZZLE_COLUMN_TYPE_YEAR:
       val= long_to_string(param, (uint32_t)(*(uint16_t*)param->data));
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_INT24:
     case DRIZZLE_COLUMN_TYPE_LONG:
       val= long_to_string(param, *(uint32_t*)param->data);
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_LONGLONG:
       val= longlong_to_string(param, *(uint64_t*)param->data);
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_FLOAT:
       val= double_to_string(param, (double) (*(float*)param->data));
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_DOUBLE:
       val= double_to_string(param, *(double*)param->data);
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_TIME:
       val= time_to_string(param, (drizzle_datetime_st*)param->data);
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_DATE:
     case DRIZZLE_COLUMN_TYPE_DATETIME:
     case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
       val= timestamp_to_string(param, (drizzle_datetime_st*)param->data);
-      *len= strlen(val);
+      *len= param->converted_length;
       break;
     case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
     case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
@@ -346,7 +504,7 @@ uint32_t drizzle_stmt_get_int_from_name(drizzle_stmt_st *stmt, const char *colum
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -436,7 +594,7 @@ uint64_t drizzle_stmt_get_bigint_from_name(drizzle_stmt_st *stmt, const char *co
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -522,7 +680,7 @@ double drizzle_stmt_get_double_from_name(drizzle_stmt_st *stmt, const char *colu
     *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
     return 0;
   }
-  column_number=  drizzle_stmt_column_lookup(stmt->prepare_result, column_name, ret_ptr);
+  column_number=  drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
   if (*ret_ptr != DRIZZLE_RETURN_OK)
   {
     return 0;
@@ -604,97 +762,710 @@ char *long_to_string(drizzle_bind_st *param, uint32_t val)
 {
   /* Pick an empty point in the buffer to make the str */
   char* buffer= param->data_buffer + 50;
-  if (param->options.is_unsigned)
+  if (param->converted_length == 0)
   {
-    snprintf(buffer, 12, "%" PRIu32, val);
+    param->converted_length= integer_format(buffer,
+      param->options.is_unsigned ? val : (uint64_t)(int64_t)(int32_t)val,
+      param->options.is_unsigned);
   }
-  else
+  return buffer;
+}
+
+char *longlong_to_string(drizzle_bind_st *param, uint64_t val)
+{
+  char* buffer= param->data_buffer + 50;
+  if (param->converted_length == 0)
   {
-    snprintf(buffer, 12, "%" PRId32, (int32_t)val);
+    param->converted_length= integer_format(buffer, val,
+                                            param->options.is_unsigned);
   }
   return buffer;
 }
 
-char *longlong_to_string(drizzle_bind_st *param, uint64_t val)
+char *double_to_string(drizzle_bind_st *param, double val)
 {
-  /* Max length is -INT64_MAX + NUL = 21 */
   char* buffer= param->data_buffer + 50;
-  if (param->options.is_unsigned)
+  if (param->converted_length == 0)
   {
-    snprintf(buffer, 21, "%" PRIu64, val);
+    param->converted_length= double_format(buffer, val,
+      param->type == DRIZZLE_COLUMN_TYPE_FLOAT);
   }
-  else
+  return buffer;
+}
+
+char *time_to_string(drizzle_bind_st *param, drizzle_datetime_st *time)
+{
+  char* buffer= param->data_buffer + 50;
+  if (param->converted_length == 0)
   {
-    snprintf(buffer, 21, "%" PRId64, (int64_t)val);
+    param->converted_length= time_format(buffer, time);
   }
   return buffer;
 }
 
-char *double_to_string(drizzle_bind_st *param, double val)
+char *timestamp_to_string(drizzle_bind_st *param, drizzle_datetime_st *timestamp)
 {
-  /* Max length is 23 */
   char* buffer= param->data_buffer + 50;
-  snprintf(buffer, 23, "%f", val);
+  if (param->converted_length == 0)
+  {
+    param->converted_length= timestamp_format(buffer, timestamp,
+      param->type == DRIZZLE_COLUMN_TYPE_DATE);
+  }
   return buffer;
 }
 
-char *time_to_string(drizzle_bind_st *param, drizzle_datetime_st *time)
+/* "00" to "99", so integers are formatted two digits at a time */
+static const char _digit_pairs[201]=
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+/* Write value with at least width digits, zero padded, and return the end */
+static char *_digits_format(char *buffer, uint32_t value, int width)
+{
+  char *ptr;
+  uint32_t rest;
+  int digits= 1;
+
+  for (rest= value; rest >= 10; rest/= 10)
+  {
+    digits++;
+  }
+  if (digits > width)
+  {
+    width= digits;
+  }
+
+  ptr= buffer + width;
+  while (ptr - buffer >= 2)
+  {
+    ptr-= 2;
+    memcpy(ptr, &_digit_pairs[(value % 100) * 2], 2);
+    value/= 100;
+  }
+  if (ptr != buffer)
+  {
+    *buffer= (char)('0' + value % 10);
+  }
+
+  return buffer + width;
+}
+
+size_t integer_format(char *buffer, uint64_t value, bool is_unsigned)
+{
+  char digits[20];
+  char *ptr= digits + sizeof(digits);
+  char *start= buffer;
+  size_t length;
+
+  if (!is_unsigned && (int64_t)value < 0)
+  {
+    *buffer++= '-';
+    value= 0 - value;
+  }
+
+  while (value >= 100)
+  {
+    ptr-= 2;
+    memcpy(ptr, &_digit_pairs[(value % 100) * 2], 2);
+    value/= 100;
+  }
+  if (value >= 10)
+  {
+    ptr-= 2;
+    memcpy(ptr, &_digit_pairs[value * 2], 2);
+  }
+  else
+  {
+    *--ptr= (char)('0' + value);
+  }
+
+  length= (size_t)(digits + sizeof(digits) - ptr);
+  memcpy(buffer, ptr, length);
+  buffer[length]= '\0';
+
+  return (size_t)(buffer - start) + length;
+}
+
+/* Whether two values are the same, without -Wfloat-equal complaining */
+static bool _same_double(double a, double b)
+{
+  return !(a < b) && !(a > b);
+}
+
+/* Exact in a double, and up to 1e10 in a float */
+static const double _powers_of_ten[]=
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13,
+  1e14, 1e15
+};
+
+/* Format value as a decimal of up to digits significant digits if one
+ * reads back as the same value, which covers most values that were
+ * written as decimals. Returns 0 if there is none. */
+static size_t _double_format_short(char *buffer, double value, bool is_float,
+                                   int digits)
+{
+  double magnitude= value < 0 ? -value : value;
+  double limit= _powers_of_ten[digits];
+  int decimals;
+
+  /* %g switches to exponents outside of this range */
+  if (!(magnitude >= 1e-4 && magnitude < limit))
+  {
+    return 0;
+  }
+
+  for (decimals= 1; decimals <= digits; decimals++)
+  {
+    double scaled= magnitude * _powers_of_ten[decimals];
+    uint64_t mantissa;
+    bool same;
+    char *ptr= buffer;
+    size_t length;
+
+    if (scaled >= limit)
+    {
+      return 0;
+    }
+    mantissa= (uint64_t)(scaled + 0.5);
+
+    /* Both operands are exact, so the division rounds like strtod() */
+    if (is_float)
+    {
+      same= _same_double((float)mantissa / (float)_powers_of_ten[decimals],
+                         (float)magnitude);
+    }
+    else
+    {
+      same= _same_double((double)mantissa / _powers_of_ten[decimals],
+                         magnitude);
+    }
+    if (!same)
+    {
+      continue;
+    }
+
+    if (value < 0)
+    {
+      *ptr++= '-';
+    }
+    length= integer_format(ptr, mantissa, true);
+    if (length > (size_t)decimals)
+    {
+      /* Make room for the point */
+      memmove(ptr + length - decimals + 1, ptr + length - decimals,
+              (size_t)decimals + 1);
+      ptr[length - decimals]= '.';
+      ptr+= length + 1;
+    }
+    else
+    {
+      /* 0.000ddd */
+      size_t zeros= (size_t)decimals - length;
+      memmove(ptr + 2 + zeros, ptr, length + 1);
+      ptr[0]= '0';
+      ptr[1]= '.';
+      memset(ptr + 2, '0', zeros);
+      ptr+= 2 + zeros + length;
+    }
+
+    return (size_t)(ptr - buffer);
+  }
+
+  return 0;
+}
+
+size_t double_format(char *buffer, double value, bool is_float)
+{
+  int precision= is_float ? FLT_DIG : DBL_DIG;
+  int max_precision= is_float ? 9 : 17;
+  size_t length;
+  int used;
+
+  /* Whole numbers which %g prints without an exponent are integers */
+  if (value > -1e15 && value < 1e15 && _same_double(value, (double)(int64_t)value)
+      && !(_same_double(value, 0) && signbit(value)))
+  {
+    return integer_format(buffer, (uint64_t)(int64_t)value, false);
+  }
+
+  length= _double_format_short(buffer, value, is_float, precision);
+  if (length > 0)
+  {
+    return length;
+  }
+
+  /* The shortest representation which reads back as the same value */
+  for (;;)
+  {
+    used= snprintf(buffer, 32, "%.*g", precision, value);
+    if (precision == max_precision)
+    {
+      break;
+    }
+    if (is_float ? _same_double(strtof(buffer, NULL), (float)value)
+                 : _same_double(strtod(buffer, NULL), value))
+    {
+      break;
+    }
+    precision++;
+  }
+
+  return (size_t)used;
+}
+
+size_t time_format(char *buffer, const drizzle_datetime_st *time)
 {
   /* Max time is -HHH:MM:SS.ssssss + NUL = 17 */
-  char* buffer= param->data_buffer + 50;
-  int buffersize = 17;
-  int used = 0;
+  char *ptr= buffer;
+
+  if (time->negative)
+  {
+    *ptr++= '-';
+  }
 
   /* Values are transferred with days separated from hours, but presented with days folded into hours. */
-  used = snprintf(buffer, buffersize-used, "%s%02u:%02" PRIu8 ":%02" PRIu8, (time->negative) ? "-" : "", time->hour + 24 * time->day, time->minute, time->second);
+  ptr= _digits_format(ptr, time->hour + 24 * time->day, 2);
+  *ptr++= ':';
+  ptr= _digits_format(ptr, time->minute, 2);
+  *ptr++= ':';
+  ptr= _digits_format(ptr, time->second, 2);
 
   /* TODO: the existence (and length) of the decimals should be decided based on the number of fields sent by the server or possibly the column's "decimals" value, not by whether the microseconds are 0 */
   if (time->microsecond || time->show_microseconds)
-    used += snprintf(buffer+used, buffersize-used, ".%06" PRIu32, time->microsecond);
-
-  assert(used < buffersize);
+  {
+    *ptr++= '.';
+    ptr= _digits_format(ptr, time->microsecond, 6);
+  }
+  *ptr= '\0';
 
-  return buffer;
+  return (size_t)(ptr - buffer);
 }
 
-char *timestamp_to_string(drizzle_bind_st *param, drizzle_datetime_st *timestamp)
+size_t timestamp_format(char *buffer, const drizzle_datetime_st *timestamp,
+                        bool date_only)
 {
   /* Max timestamp is YYYY-MM-DD HH:MM:SS.ssssss + NUL = 27 */
-  char* buffer= param->data_buffer + 50;
-  int buffersize = 27;
-  int used = 0;
+  char *ptr= buffer;
 
-  used += snprintf(buffer, buffersize-used, "%04" PRIu16 "-%02" PRIu8 "-%02" PRIu32,
-     timestamp->year, timestamp->month, timestamp->day);
-  assert(used < buffersize);
+  ptr= _digits_format(ptr, timestamp->year, 4);
+  *ptr++= '-';
+  ptr= _digits_format(ptr, timestamp->month, 2);
+  *ptr++= '-';
+  ptr= _digits_format(ptr, timestamp->day, 2);
 
-  if (param->type == DRIZZLE_COLUMN_TYPE_DATE)
-    return buffer;
+  if (!date_only)
+  {
+    *ptr++= ' ';
+    ptr= _digits_format(ptr, timestamp->hour, 2);
+    *ptr++= ':';
+    ptr= _digits_format(ptr, timestamp->minute, 2);
+    *ptr++= ':';
+    ptr= _digits_format(ptr, timestamp->second, 2);
+
+    if (timestamp->microsecond || timestamp->show_microseconds)
+    {
+      *ptr++= '.';
+      ptr= _digits_format(ptr, timestamp->microsecond, 6);
+    }
+  }
+  *ptr= '\0';
 
-  used += snprintf(buffer+used, buffersize-used, " %02" PRIu16 ":%02" PRIu8 ":%02" PRIu8,
-    timestamp->hour, timestamp->minute, timestamp->second);
+  return (size_t)(ptr - buffer);
+}
 
-  if (timestamp->microsecond || timestamp->show_microseconds)
+/* Whether an integer fits into size bytes with the signedness of its column */
+static bool _integer_fits(uint64_t value, bool is_unsigned, size_t size)
+{
+  if (size == 8)
   {
-    used += snprintf(buffer+used, buffersize-used, ".%06" PRIu32, timestamp->microsecond);
+    return true;
   }
 
-  assert(used < buffersize);
+  if (is_unsigned)
+  {
+    return value <= (UINT64_C(1) << (size * 8)) - 1;
+  }
 
-  return buffer;
+  return (int64_t)value >= -(INT64_C(1) << (size * 8 - 1)) &&
+         (int64_t)value <= (INT64_C(1) << (size * 8 - 1)) - 1;
 }
 
-uint16_t drizzle_stmt_column_lookup(drizzle_result_st *result, const char *column_name, drizzle_return_t *ret_ptr)
+/* Terminated copy of a string field for strtoull() and strtod(), in text
+ * if it fits or on the heap, as DECIMAL(65,30) values do not. Returns NULL
+ * without memory. */
+static char *_field_number(char *text, size_t text_size, const char *string,
+                           size_t size)
 {
-  uint16_t current_column;
-  for (current_column= 0; current_column < result->column_count; current_column++)
+  char *number= text;
+
+  if (size >= text_size)
   {
-    if (strncmp(column_name, result->column_buffer[current_column].name, DRIZZLE_MAX_COLUMN_NAME_SIZE) == 0)
+    number= new (std::nothrow) char[size + 1];
+    if (number == NULL)
     {
-      *ret_ptr= DRIZZLE_RETURN_OK;
-      return current_column;
+      return NULL;
     }
   }
-  *ret_ptr= DRIZZLE_RETURN_NOT_FOUND;
-  return 0;
+
+  memcpy(number, string, size);
+  number[size]= 0;
+
+  return number;
+}
+
+/* Internal function */
+drizzle_return_t drizzle_stmt_bind_field(drizzle_result_bind_st *bind,
+                                         drizzle_column_st *column,
+                                         const unsigned char *field,
+                                         size_t size)
+{
+  enum { FIELD_INTEGER, FIELD_REAL, FIELD_TEMPORAL, FIELD_STRING } kind;
+  drizzle_return_t ret= DRIZZLE_RETURN_OK;
+  bool is_unsigned= column->flags & DRIZZLE_COLUMN_FLAGS_UNSIGNED;
+  uint64_t integer= 0;
+  double real= 0;
+  drizzle_datetime_st datetime;
+  const char *string= (const char *)field;
+  size_t string_size= size;
+  char text[64];
+  char *number;
+  char *end;
+
+  if (bind->is_null != NULL)
+  {
+    *bind->is_null= false;
+  }
+
+  switch (column->type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+      integer= is_unsigned ? field[0] : (uint64_t)(int64_t)(int8_t)field[0];
+      kind= FIELD_INTEGER;
+      break;
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+      integer= drizzle_get_byte2(field);
+      if (!is_unsigned)
+      {
+        integer= (uint64_t)(int64_t)(int16_t)integer;
+      }
+      kind= FIELD_INTEGER;
+      break;
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+      integer= drizzle_get_byte4(field);
+      if (!is_unsigned)
+      {
+        integer= (uint64_t)(int64_t)(int32_t)integer;
+      }
+      kind= FIELD_INTEGER;
+      break;
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+      integer= drizzle_get_byte8(field);
+      kind= FIELD_INTEGER;
+      break;
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+      {
+        float value;
+        memcpy(&value, field, 4);
+        real= value;
+      }
+      kind= FIELD_REAL;
+      break;
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      memcpy(&real, field, 8);
+      kind= FIELD_REAL;
+      break;
+    case DRIZZLE_COLUMN_TYPE_TIME:
+      drizzle_unpack_time((drizzle_field_t)field, size, &datetime, column->decimals);
+      kind= FIELD_TEMPORAL;
+      break;
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+      drizzle_unpack_datetime((drizzle_field_t)field, size, &datetime, column->decimals);
+      kind= FIELD_TEMPORAL;
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+      kind= FIELD_STRING;
+      break;
+    /* These types aren't handled yet, most are for older MySQL versions */
+    case DRIZZLE_COLUMN_TYPE_NULL:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    default:
+      return DRIZZLE_RETURN_UNEXPECTED_DATA;
+  }
+
+  switch (bind->type)
+  {
+    case DRIZZLE_COLUMN_TYPE_TINY:
+    case DRIZZLE_COLUMN_TYPE_SHORT:
+    case DRIZZLE_COLUMN_TYPE_LONG:
+    case DRIZZLE_COLUMN_TYPE_LONGLONG:
+      {
+        size_t width= bind->type == DRIZZLE_COLUMN_TYPE_TINY ? 1 :
+                      bind->type == DRIZZLE_COLUMN_TYPE_SHORT ? 2 :
+                      bind->type == DRIZZLE_COLUMN_TYPE_LONG ? 4 : 8;
+
+        if (kind == FIELD_REAL)
+        {
+          is_unsigned= false;
+          if (real >= -9223372036854775808.0 && real < 9223372036854775808.0)
+          {
+            integer= (uint64_t)(int64_t)real;
+            if ((double)(int64_t)integer < real || (double)(int64_t)integer > real)
+            {
+              ret= DRIZZLE_RETURN_TRUNCATED;
+            }
+          }
+          else
+          {
+            ret= DRIZZLE_RETURN_TRUNCATED;
+          }
+        }
+        else if (kind == FIELD_STRING)
+        {
+          if (string_size == 0)
+          {
+            return DRIZZLE_RETURN_INVALID_CONVERSION;
+          }
+          number= _field_number(text, sizeof(text), string, string_size);
+          if (number == NULL)
+          {
+            return DRIZZLE_RETURN_MEMORY;
+          }
+          errno= 0;
+          is_unsigned= number[0] != '-';
+          if (is_unsigned)
+          {
+            integer= strtoull(number, &end, 10);
+          }
+          else
+          {
+            integer= (uint64_t)strtoll(number, &end, 10);
+          }
+          if (end == number)
+          {
+            ret= DRIZZLE_RETURN_INVALID_CONVERSION;
+          }
+          else if (*end != 0 || errno == ERANGE)
+          {
+            ret= DRIZZLE_RETURN_TRUNCATED;
+          }
+          if (number != text)
+          {
+            delete[] number;
+          }
+          if (ret == DRIZZLE_RETURN_INVALID_CONVERSION)
+          {
+            return ret;
+          }
+        }
+        else if (kind == FIELD_TEMPORAL)
+        {
+          return DRIZZLE_RETURN_INVALID_CONVERSION;
+        }
+
+        if (!_integer_fits(integer, is_unsigned, width))
+        {
+          ret= DRIZZLE_RETURN_TRUNCATED;
+        }
+
+        switch (width)
+        {
+          case 1:
+            *(uint8_t *)bind->buffer= (uint8_t)integer;
+            break;
+          case 2:
+            *(uint16_t *)bind->buffer= (uint16_t)integer;
+            break;
+          case 4:
+            *(uint32_t *)bind->buffer= (uint32_t)integer;
+            break;
+          default:
+            *(uint64_t *)bind->buffer= integer;
+            break;
+        }
+        string_size= width;
+      }
+      break;
+    case DRIZZLE_COLUMN_TYPE_FLOAT:
+    case DRIZZLE_COLUMN_TYPE_DOUBLE:
+      if (kind == FIELD_INTEGER)
+      {
+        real= is_unsigned ? (double)integer : (double)(int64_t)integer;
+      }
+      else if (kind == FIELD_STRING)
+      {
+        if (string_size == 0)
+        {
+          return DRIZZLE_RETURN_INVALID_CONVERSION;
+        }
+        number= _field_number(text, sizeof(text), string, string_size);
+        if (number == NULL)
+        {
+          return DRIZZLE_RETURN_MEMORY;
+        }
+        real= strtod(number, &end);
+        if (end == number)
+        {
+          ret= DRIZZLE_RETURN_INVALID_CONVERSION;
+        }
+        else if (*end != 0)
+        {
+          ret= DRIZZLE_RETURN_TRUNCATED;
+        }
+        if (number != text)
+        {
+          delete[] number;
+        }
+        if (ret == DRIZZLE_RETURN_INVALID_CONVERSION)
+        {
+          return ret;
+        }
+      }
+      else if (kind == FIELD_TEMPORAL)
+      {
+        return DRIZZLE_RETURN_INVALID_CONVERSION;
+      }
+
+      if (bind->type == DRIZZLE_COLUMN_TYPE_FLOAT)
+      {
+        float value= (float)real;
+        if (((double)value < real || (double)value > real) &&
+            column->type != DRIZZLE_COLUMN_TYPE_FLOAT)
+        {
+          ret= DRIZZLE_RETURN_TRUNCATED;
+        }
+        *(float *)bind->buffer= value;
+        string_size= sizeof(float);
+      }
+      else
+      {
+        *(double *)bind->buffer= real;
+        string_size= sizeof(double);
+      }
+      break;
+    case DRIZZLE_COLUMN_TYPE_TIME:
+    case DRIZZLE_COLUMN_TYPE_DATE:
+    case DRIZZLE_COLUMN_TYPE_DATETIME:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP:
+      if (kind != FIELD_TEMPORAL)
+      {
+        return DRIZZLE_RETURN_INVALID_CONVERSION;
+      }
+      memcpy(bind->buffer, &datetime, sizeof(drizzle_datetime_st));
+      string_size= sizeof(drizzle_datetime_st);
+      break;
+    case DRIZZLE_COLUMN_TYPE_TINY_BLOB:
+    case DRIZZLE_COLUMN_TYPE_MEDIUM_BLOB:
+    case DRIZZLE_COLUMN_TYPE_LONG_BLOB:
+    case DRIZZLE_COLUMN_TYPE_BLOB:
+    case DRIZZLE_COLUMN_TYPE_STRING:
+    case DRIZZLE_COLUMN_TYPE_VAR_STRING:
+      if (kind == FIELD_INTEGER)
+      {
+        string_size= integer_format(text, integer, is_unsigned);
+        string= text;
+      }
+      else if (kind == FIELD_REAL)
+      {
+        string_size= double_format(text, real,
+                                   column->type == DRIZZLE_COLUMN_TYPE_FLOAT);
+        string= text;
+      }
+      else if (kind == FIELD_TEMPORAL)
+      {
+        if (column->type == DRIZZLE_COLUMN_TYPE_TIME)
+        {
+          string_size= time_format(text, &datetime);
+        }
+        else
+        {
+          string_size= timestamp_format(text, &datetime,
+                                        column->type == DRIZZLE_COLUMN_TYPE_DATE);
+        }
+        string= text;
+      }
+
+      /* Terminated when there is room, like the strings of the getters */
+      if (string_size > bind->buffer_size)
+      {
+        memcpy(bind->buffer, string, bind->buffer_size);
+        ret= DRIZZLE_RETURN_TRUNCATED;
+      }
+      else
+      {
+        memcpy(bind->buffer, string, string_size);
+        if (string_size < bind->buffer_size)
+        {
+          ((char *)bind->buffer)[string_size]= 0;
+        }
+      }
+      break;
+    case DRIZZLE_COLUMN_TYPE_NULL:
+    case DRIZZLE_COLUMN_TYPE_INT24:
+    case DRIZZLE_COLUMN_TYPE_YEAR:
+    case DRIZZLE_COLUMN_TYPE_NEWDATE:
+    case DRIZZLE_COLUMN_TYPE_VARCHAR:
+    case DRIZZLE_COLUMN_TYPE_BIT:
+    case DRIZZLE_COLUMN_TYPE_DECIMAL:
+    case DRIZZLE_COLUMN_TYPE_NEWDECIMAL:
+    case DRIZZLE_COLUMN_TYPE_ENUM:
+    case DRIZZLE_COLUMN_TYPE_SET:
+    case DRIZZLE_COLUMN_TYPE_GEOMETRY:
+    case DRIZZLE_COLUMN_TYPE_TIMESTAMP2:
+    case DRIZZLE_COLUMN_TYPE_DATETIME2:
+    case DRIZZLE_COLUMN_TYPE_TIME2:
+    default:
+      return DRIZZLE_RETURN_INVALID_CONVERSION;
+  }
+
+  if (bind->length != NULL)
+  {
+    *bind->length= string_size;
+  }
+
+  return ret;
+}
+
+uint16_t drizzle_stmt_column_lookup(drizzle_stmt_st *stmt, const char *column_name, drizzle_return_t *ret_ptr)
+{
+  drizzle_return_t unused_ret;
+  if (ret_ptr == NULL)
+  {
+    ret_ptr= &unused_ret;
+  }
+
+  if ((stmt == NULL) || (stmt->prepare_result == NULL))
+  {
+    *ret_ptr= DRIZZLE_RETURN_INVALID_ARGUMENT;
+    return 0;
+  }
+
+  return drizzle_column_lookup(stmt->prepare_result, column_name, ret_ptr);
 }
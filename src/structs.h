@@ -64,7 +64,6 @@
 extern "C" {
 #endif
 
-#include "src/datetime.h"
 #include "src/packet.h"
 
 #if defined _WIN32 || defined __CYGWIN__
@@ -128,6 +127,30 @@ enum drizzle_socket_t
   DRIZZLE_CON_SOCKET_UDS
 };
 
+/**
+ * @ingroup drizzle_statement
+ * Statement operation which returned DRIZZLE_RETURN_IO_WAIT and continues
+ * when the same function is called again.
+ */
+enum drizzle_stmt_pending_t
+{
+  DRIZZLE_STMT_PENDING_NONE,
+  DRIZZLE_STMT_PENDING_PREPARE,
+  DRIZZLE_STMT_PENDING_PREPARE_PARAMS,
+  DRIZZLE_STMT_PENDING_PREPARE_COLUMNS,
+  DRIZZLE_STMT_PENDING_EXECUTE,
+  DRIZZLE_STMT_PENDING_EXECUTE_COLUMNS,
+  DRIZZLE_STMT_PENDING_BULK_WRITE,
+  DRIZZLE_STMT_PENDING_BULK_READ,
+  DRIZZLE_STMT_PENDING_LONG_DATA,
+  DRIZZLE_STMT_PENDING_RESET,
+  DRIZZLE_STMT_PENDING_BUFFER
+};
+
+#ifndef __cplusplus
+typedef enum drizzle_stmt_pending_t drizzle_stmt_pending_t;
+#endif
+
 /**
  * @ingroup drizzle_con
  */
@@ -159,6 +182,9 @@ struct drizzle_options_st
   bool interactive;
   bool multi_statements;
   bool auth_plugin;
+  bool local_infile;
+  bool cache_metadata;
+  bool bulk_operations;
   drizzle_socket_owner_t socket_owner;
   int wait_timeout;
   int keepidle;  // default value under linux: 7200
@@ -172,6 +198,9 @@ struct drizzle_options_st
     interactive(false),
     multi_statements(false),
     auth_plugin(false),
+    local_infile(false),
+    cache_metadata(false),
+    bulk_operations(true),
     socket_owner(DRIZZLE_SOCKET_OWNER_NATIVE),
     wait_timeout(DRIZZLE_DEFAULT_SOCKET_TIMEOUT),
     keepidle(7200),
@@ -194,6 +223,7 @@ struct drizzle_st
   short events;
   short revents;
   drizzle_capabilities_t capabilities;
+  uint32_t extended_capabilities; /* MariaDB server capabilities above bit 31 */
   drizzle_charset_t charset;
   drizzle_command_t command;
   struct state_t
@@ -202,12 +232,16 @@ struct drizzle_st
     bool no_result_read;
     bool io_ready;
     bool raw_packet;
+    bool cache_metadata; /* server may skip unchanged result set metadata */
+    bool bulk_operations; /* server takes COM_STMT_BULK_EXECUTE */
 
     state_t() :
       ready(false),
       no_result_read(false),
       io_ready(false),
-      raw_packet(false)
+      raw_packet(false),
+      cache_metadata(false),
+      bulk_operations(false)
     { }
   } state;
 
@@ -232,6 +266,10 @@ struct drizzle_st
   drizzle_context_free_fn *context_free_fn;
   void *event_watch_context; /* context for custom callback function  */
   drizzle_event_watch_fn *event_watch_fn; /* custom call back function */
+  void *local_infile_context; /* context for LOAD DATA LOCAL read function */
+  drizzle_local_infile_fn *local_infile_fn; /* LOAD DATA LOCAL read function */
+  int local_infile_fd; /* file descriptor used when no read function is set */
+  drizzle_return_t local_infile_ret; /* why the file was cut short, reported with the reply */
   drizzle_result_st *result;
   drizzle_result_st *result_list;
   unsigned char *scramble;
@@ -266,6 +304,35 @@ struct drizzle_st
   char sqlstate[DRIZZLE_MAX_SQLSTATE_SIZE + 1];
   char last_error[DRIZZLE_MAX_ERROR_SIZE];
   drizzle_stmt_st *stmt;
+  drizzle_query_template_st *query_template; /* the query template being written */
+  drizzle_stmt_st *stmt_cache_list; /* most recently used first */
+  drizzle_stmt_st *stmt_cache_last;
+  drizzle_stmt_st **stmt_cache_buckets; /* cached statements by hash of their text */
+  uint32_t stmt_cache_bucket_count; /* a power of two */
+  uint32_t stmt_cache_count;
+  uint32_t stmt_cache_size;
+  uint64_t stmt_cache_hits;
+  uint64_t stmt_cache_misses;
+  uint32_t *stmt_close_ids; /* evicted statements, closed with the next command */
+  uint32_t stmt_close_count;
+  uint32_t stmt_close_allocation;
+  uint32_t generation; /* incremented when the connection is closed */
+  struct iovec *write_iov; /* caller data written after 'buffer' by drizzle_state_write */
+  int write_iov_count;
+  unsigned char *stmt_queue_buffer; /* executions queued but not sent yet */
+  size_t stmt_queue_size;
+  size_t stmt_queue_allocation;
+  struct iovec stmt_queue_iov;
+  unsigned char *stmt_queue_read_ptr; /* replies buffered while a flush writes */
+  size_t stmt_queue_read_size;
+  drizzle_stmt_st **stmt_queue; /* ring of queued executions, oldest first */
+  uint32_t stmt_queue_first;
+  uint32_t stmt_queue_count; /* queued executions whose reply is not read */
+  uint32_t stmt_queue_sent; /* how many of the oldest ones have been sent */
+  uint32_t stmt_queue_limit;
+  bool stmt_queue_writing;
+  drizzle_stmt_st *stmt_queue_reading; /* statement whose reply is being read */
+  drizzle_stmt_st *stmt_queue_current; /* last reply read, its rows may be unread */
   drizzle_binlog_st *binlog;
 private:
   size_t _state_stack_count;
@@ -281,6 +348,7 @@ public:
     events(0),
     revents(0),
     capabilities(DRIZZLE_CAPABILITIES_NONE),
+    extended_capabilities(0),
     charset(DRIZZLE_CHARSET_NONE),
     command(DRIZZLE_COMMAND_SLEEP),
     socket_type(DRIZZLE_CON_SOCKET_TCP),
@@ -302,6 +370,10 @@ public:
     context_free_fn(NULL),
     event_watch_context(NULL),
     event_watch_fn(NULL),
+    local_infile_context(NULL),
+    local_infile_fn(NULL),
+    local_infile_fd(-1),
+    local_infile_ret(DRIZZLE_RETURN_OK),
     result(NULL),
     result_list(NULL),
     scramble(NULL),
@@ -316,6 +388,34 @@ public:
     log_fn(NULL),
     log_context(NULL),
     stmt(NULL),
+    query_template(NULL),
+    stmt_cache_list(NULL),
+    stmt_cache_last(NULL),
+    stmt_cache_buckets(NULL),
+    stmt_cache_bucket_count(0),
+    stmt_cache_count(0),
+    stmt_cache_size(0),
+    stmt_cache_hits(0),
+    stmt_cache_misses(0),
+    stmt_close_ids(NULL),
+    stmt_close_count(0),
+    stmt_close_allocation(0),
+    generation(0),
+    write_iov(NULL),
+    write_iov_count(0),
+    stmt_queue_buffer(NULL),
+    stmt_queue_size(0),
+    stmt_queue_allocation(0),
+    stmt_queue_read_ptr(NULL),
+    stmt_queue_read_size(0),
+    stmt_queue(NULL),
+    stmt_queue_first(0),
+    stmt_queue_count(0),
+    stmt_queue_sent(0),
+    stmt_queue_limit(DRIZZLE_STMT_QUEUE_LIMIT),
+    stmt_queue_writing(false),
+    stmt_queue_reading(NULL),
+    stmt_queue_current(NULL),
     binlog(NULL),
     _state_stack_count(0),
     _state_stack_list(NULL),
@@ -463,19 +563,24 @@ struct drizzle_column_st
   drizzle_column_st *next;
   drizzle_column_st *prev;
   drizzle_column_options_t options;
-  char catalog[DRIZZLE_MAX_CATALOG_SIZE];
-  char db[DRIZZLE_MAX_DB_SIZE];
-  char table[DRIZZLE_MAX_TABLE_SIZE];
-  char orig_table[DRIZZLE_MAX_TABLE_SIZE];
-  char name[DRIZZLE_MAX_COLUMN_NAME_SIZE];
-  char orig_name[DRIZZLE_MAX_COLUMN_NAME_SIZE];
+  /* The definition packet as read, its strings terminated in place. The
+   * string members are offsets into it. */
+  unsigned char *packet;
+  size_t packet_size;
+  size_t packet_allocation;
+  uint32_t catalog;
+  uint32_t db;
+  uint32_t table;
+  uint32_t orig_table;
+  uint32_t name;
+  uint32_t orig_name;
   drizzle_charset_t charset;
   uint32_t size;
   size_t max_size;
   drizzle_column_type_t type;
   int flags;
   uint8_t decimals;
-  unsigned char default_value[DRIZZLE_MAX_DEFAULT_VALUE_SIZE];
+  uint32_t default_value;
   size_t default_value_size;
 
   drizzle_column_st() :
@@ -483,50 +588,140 @@ struct drizzle_column_st
     next(NULL),
     prev(NULL),
     options(DRIZZLE_COLUMN_UNUSED),
+    packet(NULL),
+    packet_size(0),
+    packet_allocation(0),
+    catalog(0),
+    db(0),
+    table(0),
+    orig_table(0),
+    name(0),
+    orig_name(0),
     charset(DRIZZLE_CHARSET_NONE),
     size(0),
     max_size(0),
     type(DRIZZLE_COLUMN_TYPE_NONE),
     flags(DRIZZLE_COLUMN_FLAGS_NONE),
     decimals(0),
+    default_value(0),
     default_value_size(0)
+  { }
+
+  ~drizzle_column_st()
   {
-    catalog[0]= '\0';
-    db[0]= '\0';
-    table[0]= '\0';
-    orig_table[0] ='\0';
-    name[0]= '\0';
+    free(packet);
   }
+
+private:
+  /* Use drizzle_column_copy(), the packet is owned */
+  drizzle_column_st(const drizzle_column_st&);
+  drizzle_column_st& operator=(const drizzle_column_st&);
 };
 
+struct drizzle_result_bind_st;
+
 struct drizzle_stmt_st
 {
   drizzle_st *con;
   drizzle_stmt_state_t state;
+  drizzle_stmt_pending_t pending;
   uint32_t id;
   uint16_t param_count;
   drizzle_bind_st *query_params;
   drizzle_bind_st *result_params;
+  uint16_t result_params_count;
+  char *bind_arena; /* query_params, result_params and their scratch buffers */
+  uint32_t bind_arena_slots; /* bindings the arena holds, parameters first */
+  drizzle_result_bind_st *result_binds; /* decoded into by drizzle_stmt_fetch() */
+  uint16_t result_binds_count;
   uint16_t null_bitmap_length;
   uint8_t *null_bitmap;
   bool new_bind;
   drizzle_result_st *prepare_result;
   drizzle_result_st *execute_result;
   drizzle_column_st *fields;
+  uint32_t bulk_row;
+  uint32_t bulk_window_end;
+  uint32_t bulk_error_row;
+  uint32_t bulk_row_count;
+  uint32_t bulk_read_row; /* next row whose reply is read */
+  uint64_t bulk_affected_rows;
+  uint64_t bulk_insert_id;
+  bool bulk_failed;
+  bool bulk_native; /* rows are sent with COM_STMT_BULK_EXECUTE */
+  uint16_t prepare_skipped; /* parameter packets skipped while preparing */
+  char *cache_query;
+  size_t cache_query_size;
+  uint32_t cache_hash;
+  uint32_t cache_generation;
+  uint32_t cache_users; /* callers holding it from drizzle_stmt_prepare_cached() */
+  drizzle_stmt_st *cache_next;
+  drizzle_stmt_st *cache_prev;
+  drizzle_stmt_st *cache_bucket_next; /* next statement in the hash bucket */
+  drizzle_column_st *columns; /* metadata of the last result set, reused when the server skips it */
+  uint16_t columns_count;
+  unsigned char *execute_buffer; /* parameters too large for the connection buffer */
+  size_t execute_buffer_size;
+  const unsigned char *packed_params; /* caller encoded parameters, see drizzle_stmt_execute_packed() */
+  size_t packed_params_size;
+  const struct iovec *long_data_iov; /* data left to send with send_long_data */
+  int long_data_iov_count;
+  size_t long_data_offset; /* bytes of long_data_iov[0] already sent */
+  int long_data_fd;
+  uint16_t long_data_param;
+  bool long_data_sent;
+  struct iovec long_data_single; /* data of drizzle_stmt_send_long_data() */
+  struct iovec long_data_chunk[DRIZZLE_STMT_LONG_DATA_IOV_MAX];
 
   drizzle_stmt_st() :
     con(NULL),
     state(DRIZZLE_STMT_NONE),
+    pending(DRIZZLE_STMT_PENDING_NONE),
     id(0),
     param_count(0),
     query_params(NULL),
     result_params(NULL),
+    result_params_count(0),
+    bind_arena(NULL),
+    bind_arena_slots(0),
+    result_binds(NULL),
+    result_binds_count(0),
     null_bitmap_length(0),
     null_bitmap(NULL),
     new_bind(true),
     prepare_result(NULL),
     execute_result(NULL),
-    fields(NULL)
+    fields(NULL),
+    bulk_row(0),
+    bulk_window_end(0),
+    bulk_error_row(0),
+    bulk_row_count(0),
+    bulk_read_row(0),
+    bulk_affected_rows(0),
+    bulk_insert_id(0),
+    bulk_failed(false),
+    bulk_native(false),
+    prepare_skipped(0),
+    cache_query(NULL),
+    cache_query_size(0),
+    cache_hash(0),
+    cache_generation(0),
+    cache_users(0),
+    cache_next(NULL),
+    cache_prev(NULL),
+    cache_bucket_next(NULL),
+    columns(NULL),
+    columns_count(0),
+    execute_buffer(NULL),
+    execute_buffer_size(0),
+    packed_params(NULL),
+    packed_params_size(0),
+    long_data_iov(NULL),
+    long_data_iov_count(0),
+    long_data_offset(0),
+    long_data_fd(-1),
+    long_data_param(0),
+    long_data_sent(false)
   { }
 };
 
@@ -534,29 +729,127 @@ struct drizzle_bind_st
 {
   drizzle_column_type_t type;
   void *data;
-  char *data_buffer;
+  char *data_buffer; /* DRIZZLE_BIND_BUFFER_SIZE bytes in the statement's bind arena */
   size_t length;  /* amount of data in 'data' */
+  size_t converted_length;  /* string made by drizzle_stmt_get_string(), 0 if none */
   bool is_bound;
+  /* column-wise values for bulk execution */
+  const void *array_data;
+  const size_t *array_lengths;
+  const bool *array_nulls;
   struct options_t
   {
     bool is_null;
     bool is_unsigned;
     bool is_long_data;
+    bool is_array;
 
     options_t() :
       is_null(false),
       is_unsigned(false),
-      is_long_data(false)
+      is_long_data(false),
+      is_array(false)
     { }
   } options;
   drizzle_bind_st() :
     type(DRIZZLE_COLUMN_TYPE_NONE),
     data(NULL),
+    data_buffer(NULL),
     length(0),
+    converted_length(0),
+    is_bound(false),
+    array_data(NULL),
+    array_lengths(NULL),
+    array_nulls(NULL)
+  { }
+};
+
+/* Destination of a result column bound with drizzle_stmt_bind_result() */
+struct drizzle_result_bind_st
+{
+  drizzle_column_type_t type;
+  void *buffer;
+  size_t buffer_size;
+  size_t *length;
+  bool *is_null;
+  bool is_bound;
+
+  drizzle_result_bind_st() :
+    type(DRIZZLE_COLUMN_TYPE_NULL),
+    buffer(NULL),
+    buffer_size(0),
+    length(NULL),
+    is_null(NULL),
     is_bound(false)
-  {
-    data_buffer= new (std::nothrow) char[128];
-  }
+  { }
+};
+
+struct drizzle_query_batch_st
+{
+  drizzle_st *con;
+  char *buffer;
+  size_t buffer_allocation;
+  size_t buffer_size;
+  size_t prefix_size;
+  size_t row_start;
+  size_t max_size;
+  uint32_t row_count;
+  uint64_t affected_rows;
+  bool in_row;
+  bool first_value;
+
+  drizzle_query_batch_st() :
+    con(NULL),
+    buffer(NULL),
+    buffer_allocation(0),
+    buffer_size(0),
+    prefix_size(0),
+    row_start(0),
+    max_size(0),
+    row_count(0),
+    affected_rows(0),
+    in_row(false),
+    first_value(false)
+  { }
+};
+
+struct drizzle_query_template_st
+{
+  drizzle_st *con;
+  char *text; /* the query with its placeholders */
+  size_t text_size;
+  size_t *param_offsets; /* offset of every placeholder in text */
+  uint16_t param_count;
+  char *values; /* SQL literals of the parameters */
+  size_t values_size;
+  size_t values_allocation;
+  size_t *value_offsets;
+  size_t *value_sizes; /* SIZE_MAX if the parameter is not set */
+  char *buffer; /* the query built by drizzle_query_template_build() */
+  size_t buffer_size;
+  size_t buffer_allocation;
+  size_t query_size; /* size of the query being sent */
+  bool pending; /* the query is being sent on a non-blocking connection */
+  bool packed; /* the query is packed straight into the connection buffer */
+
+  drizzle_query_template_st() :
+    con(NULL),
+    text(NULL),
+    text_size(0),
+    param_offsets(NULL),
+    param_count(0),
+    values(NULL),
+    values_size(0),
+    values_allocation(0),
+    value_offsets(NULL),
+    value_sizes(NULL),
+    buffer(NULL),
+    buffer_size(0),
+    buffer_allocation(0),
+    query_size(0),
+    pending(false),
+    packed(false)
+  { }
 };
 
 #ifdef __cplusplus
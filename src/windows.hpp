@@ -76,6 +76,12 @@ struct sockaddr_un
   char sun_path[108];
 };
 
+struct iovec
+{
+  void *iov_base;
+  size_t iov_len;
+};
+
 static inline int translate_windows_error()
 {
   int local_errno= WSAGetLastError();
@@ -0,0 +1,275 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/* Microbenchmark of drizzle_stmt_get_string() on buffered statement rows.
+ *
+ * Every column is fetched once without and once with converting its fields,
+ * the difference is the cost of the formatter. A third pass converts every
+ * field twice, the second call returns the string cached in the bind. The
+ * same values are formatted with snprintf() for comparison, doubles with the
+ * shortest "%.*g" that strtod() reads back as the same value.
+ *
+ * Run with "make bench", the server settings are those of the unit tests.
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ROWS 20000
+#define BENCH_PASSES 5
+
+static const char *columns[]= { "i", "d", "ts" };
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1000000000;
+}
+
+static uint64_t random_state= UINT64_C(88172645463325252);
+
+static uint64_t random_next(void)
+{
+  random_state^= random_state << 13;
+  random_state^= random_state >> 7;
+  random_state^= random_state << 17;
+  return random_state;
+}
+
+/* Shortest "%.*g" which reads back as value */
+static int double_snprintf(char *buffer, size_t size, double value)
+{
+  int length= 0;
+
+  for (int precision= 1; precision <= 17; precision++)
+  {
+    double read;
+
+    length= snprintf(buffer, size, "%.*g", precision, value);
+    read= strtod(buffer, NULL);
+    if (!(read < value) && !(read > value))
+    {
+      break;
+    }
+  }
+
+  return length;
+}
+
+/* Seconds to fetch every row of column, converting each field calls times */
+static double fetch_column(drizzle_stmt_st *stmt, uint16_t column, int calls)
+{
+  drizzle_return_t driz_ret;
+  double best= 0;
+  size_t length;
+
+  for (int pass= 0; pass < BENCH_PASSES; pass++)
+  {
+    double start;
+
+    CHECK(drizzle_stmt_execute(stmt));
+    CHECK(drizzle_stmt_buffer(stmt));
+
+    start= now();
+    while (drizzle_stmt_fetch(stmt) == DRIZZLE_RETURN_OK)
+    {
+      for (int call= 0; call < calls; call++)
+      {
+        drizzle_stmt_get_string(stmt, column, &length, &driz_ret);
+      }
+    }
+    start= now() - start;
+
+    if (pass == 0 || start < best)
+    {
+      best= start;
+    }
+  }
+
+  return best;
+}
+
+/* Seconds to format the values of column with snprintf() */
+static double snprintf_column(drizzle_stmt_st *stmt, uint16_t column)
+{
+  drizzle_return_t driz_ret;
+  static int64_t integers[BENCH_ROWS];
+  static double doubles[BENCH_ROWS];
+  static unsigned timestamps[BENCH_ROWS][7];
+  char text[32];
+  volatile size_t sink= 0;
+  uint32_t rows= 0;
+  double best= 0;
+  size_t length;
+
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_buffer(stmt));
+  while (drizzle_stmt_fetch(stmt) == DRIZZLE_RETURN_OK && rows < BENCH_ROWS)
+  {
+    unsigned *timestamp= timestamps[rows];
+
+    integers[rows]= (int64_t)drizzle_stmt_get_bigint(stmt, 0, &driz_ret);
+    doubles[rows]= drizzle_stmt_get_double(stmt, 1, &driz_ret);
+    sscanf(drizzle_stmt_get_string(stmt, 2, &length, &driz_ret),
+           "%u-%u-%u %u:%u:%u.%u", &timestamp[0], &timestamp[1],
+           &timestamp[2], &timestamp[3], &timestamp[4], &timestamp[5],
+           &timestamp[6]);
+    rows++;
+  }
+
+  for (int pass= 0; pass < BENCH_PASSES; pass++)
+  {
+    double start= now();
+
+    for (uint32_t row= 0; row < rows; row++)
+    {
+      const unsigned *timestamp= timestamps[row];
+
+      if (column == 0)
+      {
+        sink+= (size_t)snprintf(text, sizeof(text), "%" PRId64, integers[row]);
+      }
+      else if (column == 1)
+      {
+        sink+= (size_t)double_snprintf(text, sizeof(text), doubles[row]);
+      }
+      else
+      {
+        sink+= (size_t)snprintf(text, sizeof(text),
+                                "%04u-%02u-%02u %02u:%02u:%02u.%06u",
+                                timestamp[0], timestamp[1], timestamp[2],
+                                timestamp[3], timestamp[4], timestamp[5],
+                                timestamp[6]);
+      }
+    }
+    start= now() - start;
+
+    if (pass == 0 || start < best)
+    {
+      best= start;
+    }
+  }
+  (void)sink;
+
+  return best;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  const char *query= "SELECT i, d, ts FROM test_bench_getters.t1";
+  char insert[64 * 100 + 64];
+
+  set_up_connection();
+  set_up_schema("test_bench_getters");
+
+  CHECKED_QUERY("CREATE TABLE test_bench_getters.t1 (i BIGINT, d DOUBLE, ts DATETIME(6))");
+  drizzle_result_free(result);
+
+  /* Random 64 bit integers, doubles from decimals and from any bits, and
+   * timestamps with microseconds */
+  for (uint32_t row= 0; row < BENCH_ROWS; row+= 100)
+  {
+    size_t size= (size_t)snprintf(insert, sizeof(insert),
+                                  "INSERT INTO test_bench_getters.t1 VALUES ");
+    for (uint32_t x= 0; x < 100; x++)
+    {
+      uint64_t bits= random_next();
+      double real;
+
+      if (x % 2 == 0)
+      {
+        real= (double)(int64_t)(random_next() % 100000000) / 1000;
+      }
+      else
+      {
+        memcpy(&real, &bits, sizeof(real));
+        if (!isfinite(real))
+        {
+          real= (double)bits;
+        }
+      }
+      size+= (size_t)snprintf(insert + size, sizeof(insert) - size,
+                              "%s(%" PRId64 ",%.17g,'%04u-%02u-%02u %02u:%02u:%02u.%06u')",
+                              x == 0 ? "" : ",", (int64_t)random_next(), real,
+                              (unsigned)(1970 + bits % 60), (unsigned)(1 + bits % 12),
+                              (unsigned)(1 + bits % 28), (unsigned)(bits % 24),
+                              (unsigned)(bits % 60), (unsigned)(bits / 60 % 60),
+                              (unsigned)(bits % 1000000));
+    }
+    CHECKED_QUERY(insert);
+    drizzle_result_free(result);
+  }
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  printf("%d rows, best of %d passes, ns per value\n", BENCH_ROWS, BENCH_PASSES);
+  printf("%-8s %12s %12s %12s\n", "column", "get_string", "cached", "snprintf");
+  for (uint16_t column= 0; column < 3; column++)
+  {
+    double fetch= fetch_column(stmt, column, 0);
+    double once= fetch_column(stmt, column, 1);
+    double twice= fetch_column(stmt, column, 2);
+    double baseline= snprintf_column(stmt, column);
+
+    printf("%-8s %12.1f %12.1f %12.1f\n", columns[column],
+           (once - fetch) / BENCH_ROWS * 1000000000,
+           (twice - once) / BENCH_ROWS * 1000000000,
+           baseline / BENCH_ROWS * 1000000000);
+  }
+
+  CHECK(drizzle_stmt_close(stmt));
+  tear_down_schema("test_bench_getters");
+
+  return EXIT_SUCCESS;
+}
@@ -160,6 +160,14 @@ int main(int argc, char *argv[])
     column = drizzle_column_index(result, 1);
     ASSERT_NULL_(drizzle_column_index(NULL, 1), "Can't get column by index with result=NULL");
     ASSERT_NULL_(drizzle_column_index(result, 999), "Column index is out of bounds");
+    ASSERT_EQ(2, drizzle_column_lookup(result, "column_3", &driz_ret));
+    ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+    ASSERT_EQ(0, drizzle_column_lookup(result, "column_1", &driz_ret));
+    ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+    drizzle_column_lookup(result, "c", &driz_ret);
+    ASSERT_EQ(DRIZZLE_RETURN_NOT_FOUND, driz_ret);
+    drizzle_column_lookup(NULL, "column_1", &driz_ret);
+    ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
     column = drizzle_column_prev(NULL);
     ASSERT_NULL_(column, "Result set is NULL");
     column = drizzle_column_next(NULL);
@@ -171,6 +179,20 @@ int main(int argc, char *argv[])
 
   drizzle_result_free(result);
 
+  /* Names of more than 250 bytes have a longer length prefix */
+  char long_name[256];
+  char long_query[300];
+  memset(long_name, 'x', sizeof(long_name) - 1);
+  long_name[sizeof(long_name) - 1]= '\0';
+  snprintf(long_query, sizeof(long_query), "SELECT 1 AS %s", long_name);
+  CHECKED_QUERY(long_query);
+  CHECK(drizzle_column_buffer(result));
+  ASSERT_STREQ_(long_name, drizzle_column_name(drizzle_column_index(result, 0)),
+                "Wrong long column alias");
+  ASSERT_EQ(0, drizzle_column_lookup(result, long_name, &driz_ret));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_result_free(result);
+
   CHECKED_QUERY("DROP TABLE test_column.t1");
 
   tear_down_schema("test_column");
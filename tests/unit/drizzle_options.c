@@ -72,6 +72,10 @@ int main(int argc, char *argv[]) {
   CHECK_DRIZZLE_OPTION(drizzle_options_set_found_rows, drizzle_options_get_found_rows);
   CHECK_DRIZZLE_OPTION(drizzle_options_set_interactive, drizzle_options_get_interactive);
   CHECK_DRIZZLE_OPTION(drizzle_options_set_multi_statements, drizzle_options_get_multi_statements);
+  CHECK_DRIZZLE_OPTION(drizzle_options_set_local_infile, drizzle_options_get_local_infile);
+  CHECK_DRIZZLE_OPTION(drizzle_options_set_cache_metadata, drizzle_options_get_cache_metadata);
+  ASSERT_TRUE(drizzle_options_get_bulk_operations(opts));
+  CHECK_DRIZZLE_OPTION(drizzle_options_set_bulk_operations, drizzle_options_get_bulk_operations);
   CHECK_DRIZZLE_OPTION(drizzle_options_set_auth_plugin, drizzle_options_get_auth_plugin);
 
   drizzle_options_set_socket_owner(NULL, DRIZZLE_SOCKET_OWNER_CLIENT);
@@ -0,0 +1,195 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+
+#define ROW_COUNT 20000
+
+struct infile_state
+{
+  uint32_t next_row;
+  char pending[32];
+  size_t pending_size;
+};
+
+/* Generates "n\n" lines, handing them out in whatever sized chunks the
+ * library asks for. */
+static ssize_t generate_rows(drizzle_st *connection, const char *filename,
+                             unsigned char *buffer, size_t size,
+                             void *context)
+{
+  struct infile_state *state= (struct infile_state *)context;
+  size_t written= 0;
+  (void)connection;
+  (void)filename;
+
+  while (written < size)
+  {
+    size_t copy;
+    if (state->pending_size == 0)
+    {
+      if (state->next_row == ROW_COUNT)
+      {
+        break;
+      }
+      state->next_row++;
+      state->pending_size= (size_t)snprintf(state->pending,
+                                            sizeof(state->pending),
+                                            "%" PRIu32 "\n", state->next_row);
+    }
+
+    copy= state->pending_size < size - written ? state->pending_size
+                                               : size - written;
+    memcpy(buffer + written, state->pending, copy);
+    memmove(state->pending, state->pending + copy, state->pending_size - copy);
+    state->pending_size-= copy;
+    written+= copy;
+  }
+
+  return (ssize_t)written;
+}
+
+static ssize_t fail_read(drizzle_st *connection, const char *filename,
+                         unsigned char *buffer, size_t size, void *context)
+{
+  (void)connection;
+  (void)filename;
+  (void)buffer;
+  (void)size;
+  (void)context;
+
+  return -1;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  struct infile_state state;
+  int pipe_fds[2];
+  char lines[64];
+  size_t length= 0;
+  uint32_t x;
+
+  opts= drizzle_options_create();
+  ASSERT_NOT_NULL_(opts, "drizzle_options_create() failed");
+  drizzle_options_set_local_infile(opts, true);
+
+  set_up_connection();
+  set_up_schema("test_local_infile");
+
+  CHECKED_QUERY("CREATE TABLE test_local_infile.t1 (a INT PRIMARY KEY)");
+  drizzle_result_free(result);
+
+  memset(&state, 0, sizeof(state));
+  drizzle_set_local_infile_fn(con, generate_rows, &state);
+
+  result= drizzle_query(con, "LOAD DATA LOCAL INFILE 'generated' "
+                             "INTO TABLE test_local_infile.t1", 0, &driz_ret);
+  SKIP_IF_(driz_ret == DRIZZLE_RETURN_ERROR_CODE,
+           "server rejected LOAD DATA LOCAL INFILE: %s", drizzle_error(con));
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s(%s)", drizzle_error(con),
+             drizzle_strerror(driz_ret));
+  ASSERT_EQ(ROW_COUNT, drizzle_result_affected_rows(result));
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("SELECT COUNT(*), SUM(a) FROM test_local_infile.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_STREQ("20000", row[0]);
+  ASSERT_STREQ("200010000", row[1]);
+  drizzle_result_free(result);
+
+  /* A file descriptor, read until EOF */
+  for (x= ROW_COUNT + 1; x <= ROW_COUNT + 5; x++)
+  {
+    length+= (size_t)snprintf(lines + length, sizeof(lines) - length,
+                              "%" PRIu32 "\n", x);
+  }
+  ASSERT_EQ(0, pipe(pipe_fds));
+  ASSERT_EQ((ssize_t)length, write(pipe_fds[1], lines, length));
+  close(pipe_fds[1]);
+  drizzle_set_local_infile_fn(con, NULL, NULL);
+  drizzle_set_local_infile_fd(con, pipe_fds[0]);
+
+  result= drizzle_query(con, "LOAD DATA LOCAL INFILE 'fd' "
+                             "INTO TABLE test_local_infile.t1", 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s(%s)", drizzle_error(con),
+             drizzle_strerror(driz_ret));
+  ASSERT_EQ(5, drizzle_result_affected_rows(result));
+  drizzle_result_free(result);
+  close(pipe_fds[0]);
+
+  /* A failing source or none at all fails the query, not the connection */
+  drizzle_set_local_infile_fd(con, -1);
+  drizzle_set_local_infile_fn(con, fail_read, NULL);
+  result= drizzle_query(con, "LOAD DATA LOCAL INFILE 'failing' "
+                             "INTO TABLE test_local_infile.t1", 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_ERROR_CODE, driz_ret, "%s", drizzle_strerror(driz_ret));
+  ASSERT_NOT_NULL_(strstr(drizzle_error(con), "local infile"), "%s", drizzle_error(con));
+  drizzle_result_free(result);
+
+  drizzle_set_local_infile_fn(con, NULL, NULL);
+  result= drizzle_query(con, "LOAD DATA LOCAL INFILE 'unset' "
+                             "INTO TABLE test_local_infile.t1", 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_ERROR_CODE, driz_ret, "%s", drizzle_strerror(driz_ret));
+  ASSERT_NOT_NULL_(strstr(drizzle_error(con), "no local infile source"),
+                   "%s", drizzle_error(con));
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("SELECT COUNT(*) FROM test_local_infile.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_STREQ("20005", row[0]);
+  drizzle_result_free(result);
+
+  tear_down_schema("test_local_infile");
+
+  return EXIT_SUCCESS;
+}
@@ -352,6 +352,9 @@ int main(int argc, char *argv[])
 
     col_strval = drizzle_stmt_get_string(sth, 7, &lth, &driz_ret);
     ASSERT_EQ(driz_ret, DRIZZLE_RETURN_OK);
+    ASSERT_EQ(lth, strlen(col_strval));
+    /* The string reads back as the same value */
+    ASSERT_FLOATEQEXACT(strtod(col_strval, NULL), col_dblval);
 
     printf("  Column %d: %" PRIdMAX "  \"%s\"   %f\n", 8, col_val, col_strval,
            col_dblval);
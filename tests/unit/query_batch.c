@@ -0,0 +1,184 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+#define PREFIX "INSERT INTO test_query_batch.t1 (a, b) VALUES "
+#define ROW_COUNT 5000
+
+static void check_offline(void)
+{
+  drizzle_st *offline;
+  drizzle_query_batch_st *batch;
+  drizzle_return_t driz_ret;
+  char big[64];
+
+  offline= drizzle_create("localhost", 0, NULL, NULL, NULL, NULL);
+  ASSERT_NOT_NULL_(offline, "drizzle_create() failed");
+
+  ASSERT_NULL_(drizzle_query_batch_create(NULL, PREFIX, 0, &driz_ret),
+               "batch created without a connection");
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  batch= drizzle_query_batch_create(offline, PREFIX, 0, &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_NOT_NULL_(batch, "drizzle_query_batch_create() failed");
+
+  /* The prefix has to fit */
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_query_batch_set_max_packet_size(batch, 10));
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_batch_set_max_packet_size(batch,
+                                                    sizeof(PREFIX) + 40));
+
+  /* Values only inside rows, rows must be closed before flushing */
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_query_batch_add_int64(batch, 1));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_query_batch_row_end(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_begin(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_query_batch_flush(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_add_int64(batch, -1));
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_batch_add_string(batch, "it's", 4));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_end(batch));
+  ASSERT_EQ(1, drizzle_query_batch_row_count(batch));
+
+  /* A row which can never fit is dropped */
+  memset(big, 'x', sizeof(big));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_begin(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED,
+            drizzle_query_batch_add_string(batch, big, sizeof(big)));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_begin(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_add_null(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_end(batch));
+  ASSERT_EQ(2, drizzle_query_batch_row_count(batch));
+
+  /* Only the escaped size counts, not twice the value */
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_row_begin(batch));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_query_batch_add_string(batch, big, 30));
+
+  drizzle_query_batch_free(batch);
+  drizzle_quit(offline);
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  drizzle_query_batch_st *batch;
+  uint32_t i;
+
+  check_offline();
+
+  set_up_connection();
+  set_up_schema("test_query_batch");
+
+  CHECKED_QUERY("CREATE TABLE test_query_batch.t1 (a INT, b VARCHAR(64))");
+  drizzle_result_free(result);
+
+  batch= drizzle_query_batch_create(con, PREFIX, 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  /* Small packets so the batch has to flush on its own */
+  CHECK(drizzle_query_batch_set_max_packet_size(batch, 4096));
+
+  for (i= 1; i <= ROW_COUNT; i++)
+  {
+    CHECK(drizzle_query_batch_row_begin(batch));
+    CHECK(drizzle_query_batch_add_uint64(batch, i));
+    CHECK(drizzle_query_batch_add_string(batch, "a 'quoted'\n\\value", 18));
+    CHECK(drizzle_query_batch_row_end(batch));
+  }
+  ASSERT_TRUE(drizzle_query_batch_affected_rows(batch) > 0);
+  ASSERT_TRUE(drizzle_query_batch_row_count(batch) < ROW_COUNT);
+  CHECK(drizzle_query_batch_flush(batch));
+  ASSERT_EQ(0, drizzle_query_batch_row_count(batch));
+  ASSERT_EQ(ROW_COUNT, drizzle_query_batch_affected_rows(batch));
+  drizzle_query_batch_free(batch);
+
+  CHECKED_QUERY("SELECT COUNT(*), SUM(a), COUNT(DISTINCT b), MAX(b) "
+                "FROM test_query_batch.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_STREQ("5000", row[0]);
+  ASSERT_STREQ("12502500", row[1]);
+  ASSERT_STREQ("1", row[2]);
+  ASSERT_STREQ("a 'quoted'\n\\value", row[3]);
+  drizzle_result_free(result);
+
+  /* Backslashes are ordinary characters with NO_BACKSLASH_ESCAPES, a quote
+   * after one must still not end the literal */
+  CHECKED_QUERY("SET SESSION sql_mode='NO_BACKSLASH_ESCAPES'");
+  drizzle_result_free(result);
+  ASSERT_TRUE(drizzle_status(con) & DRIZZLE_CON_STATUS_NO_BACKSLASH_ESCAPES);
+  batch= drizzle_query_batch_create(con, PREFIX, 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_query_batch_row_begin(batch));
+  CHECK(drizzle_query_batch_add_int64(batch, -1));
+  CHECK(drizzle_query_batch_add_string(batch, "\\'), (-2, 'x", 12));
+  CHECK(drizzle_query_batch_row_end(batch));
+  CHECK(drizzle_query_batch_flush(batch));
+  ASSERT_EQ(1, drizzle_query_batch_affected_rows(batch));
+  drizzle_query_batch_free(batch);
+  CHECKED_QUERY("SET SESSION sql_mode=DEFAULT");
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("SELECT COUNT(*), MIN(a), MIN(b) FROM test_query_batch.t1 "
+                "WHERE a < 0");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_STREQ("1", row[0]);
+  ASSERT_STREQ("-1", row[1]);
+  ASSERT_STREQ("\\'), (-2, 'x", row[2]);
+  drizzle_result_free(result);
+
+  tear_down_schema("test_query_batch");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+#define INSERT "INSERT INTO test_query_template.t1 (a, b, c) VALUES (?, ?, ?)"
+
+static void check_offline(void)
+{
+  drizzle_st *offline;
+  drizzle_query_template_st *query_template;
+  drizzle_return_t driz_ret;
+  const char *query;
+  size_t size;
+  const unsigned char binary[]= { 0x00, 0x5C, 0xFF };
+
+  offline= drizzle_create("localhost", 0, NULL, NULL, NULL, NULL);
+  ASSERT_NOT_NULL_(offline, "drizzle_create() failed");
+
+  ASSERT_NULL_(drizzle_query_template_create(NULL, INSERT, 0, &driz_ret),
+               "template created without a connection");
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  /* Question marks in literals, identifiers and comments are no placeholders */
+  query_template= drizzle_query_template_create(offline,
+    "SELECT '?', \"it\\\"s?\", `a?` /* ? */, ? # ?\n, ? -- ?\n, 'x''?', ?", 0,
+    &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_EQ(3, drizzle_query_template_param_count(query_template));
+
+  ASSERT_NULL_(drizzle_query_template_build(query_template, &size, &driz_ret),
+               "built with parameters not set");
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_query_template_set_int64(query_template, 3, 1));
+
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_template_set_int64(query_template, 0, -42));
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_template_set_string(query_template, 1, "it's\\", 5));
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_template_set_binary(query_template, 2, binary, sizeof(binary)));
+  query= drizzle_query_template_build(query_template, &size, &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_STREQ("SELECT '?', \"it\\\"s?\", `a?` /* ? */, -42 # ?\n, 'it\\'s\\\\' -- ?\n, 'x''?', X'005CFF'",
+               query);
+  ASSERT_EQ(strlen(query), size);
+
+  /* Values are kept until they are set again */
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_template_set_null(query_template, 1));
+  ASSERT_EQ(DRIZZLE_RETURN_OK,
+            drizzle_query_template_set_double(query_template, 2, (double)1 / 10));
+  query= drizzle_query_template_build(query_template, &size, &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_STREQ("SELECT '?', \"it\\\"s?\", `a?` /* ? */, -42 # ?\n, NULL -- ?\n, 'x''?', 0.1",
+               query);
+
+  drizzle_query_template_free(query_template);
+  drizzle_quit(offline);
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  drizzle_query_template_st *query_template;
+  char value[32];
+  uint32_t i;
+
+  check_offline();
+
+  set_up_connection();
+  set_up_schema("test_query_template");
+
+  CHECKED_QUERY("CREATE TABLE test_query_template.t1 (a INT, b VARCHAR(64), c VARBINARY(8))");
+  drizzle_result_free(result);
+
+  query_template= drizzle_query_template_create(con, INSERT, 0, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  CHECK(drizzle_query_template_set_binary(query_template, 2, (const unsigned char *)"\0'\\", 3));
+  for (i= 1; i <= 100; i++)
+  {
+    snprintf(value, sizeof(value), "row '%u'\n\\", i);
+    CHECK(drizzle_query_template_set_uint64(query_template, 0, i));
+    CHECK(drizzle_query_template_set_string(query_template, 1, value, strlen(value)));
+    result= drizzle_query_template_execute(query_template, &driz_ret);
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    ASSERT_EQ(1, drizzle_result_affected_rows(result));
+    drizzle_result_free(result);
+  }
+  drizzle_query_template_free(query_template);
+
+  CHECKED_QUERY("SELECT COUNT(*), SUM(a), MAX(b), HEX(MIN(c)) FROM test_query_template.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_STREQ("100", row[0]);
+  ASSERT_STREQ("5050", row[1]);
+  ASSERT_STREQ("row '99'\n\\", row[2]);
+  ASSERT_STREQ("00275C", row[3]);
+  drizzle_result_free(result);
+
+  tear_down_schema("test_query_template");
+
+  return EXIT_SUCCESS;
+}
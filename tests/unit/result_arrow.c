@@ -0,0 +1,147 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  struct ArrowArrayStream stream;
+  struct ArrowSchema schema;
+  struct ArrowArray batch;
+  const int64_t *ids;
+  const int32_t *days;
+  const int64_t *offsets;
+  int64_t rows= 0;
+  int batches= 0;
+
+  set_up_connection();
+  set_up_schema("test_result_arrow");
+
+  CHECKED_QUERY("CREATE TABLE test_result_arrow.t1 (a INT NOT NULL, b DATE, c VARCHAR(10))");
+  CHECKED_QUERY("INSERT INTO test_result_arrow.t1 VALUES "
+                "(1, '1970-01-02', 'one'), (2, NULL, 'two'), (3, '1969-12-31', NULL), "
+                "(4, '2000-01-01', ''), (5, '1970-01-01', 'five')");
+
+  CHECKED_QUERY("SELECT a, b, c FROM test_result_arrow.t1 ORDER BY a");
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_result_arrow_stream(result, 0, &stream));
+  CHECK(drizzle_result_arrow_stream(result, 2, &stream));
+
+  ASSERT_EQ(0, stream.get_schema(&stream, &schema));
+  ASSERT_STREQ("+s", schema.format);
+  ASSERT_EQ(3, schema.n_children);
+  ASSERT_STREQ("l", schema.children[0]->format);
+  ASSERT_STREQ("a", schema.children[0]->name);
+  ASSERT_EQ(0, schema.children[0]->flags);
+  ASSERT_STREQ("tdD", schema.children[1]->format);
+  ASSERT_EQ(ARROW_FLAG_NULLABLE, schema.children[1]->flags);
+  ASSERT_STREQ("U", schema.children[2]->format);
+  schema.release(&schema);
+  ASSERT_NULL_(schema.release, "schema not released");
+
+  /* Batches of 2, 2 and 1 rows, then the end of the stream */
+  while (1)
+  {
+    ASSERT_EQ(0, stream.get_next(&stream, &batch));
+    if (batch.release == NULL)
+    {
+      break;
+    }
+    ASSERT_EQ(3, batch.n_children);
+    ASSERT_EQ(batches < 2 ? 2 : 1, batch.length);
+
+    ids= (const int64_t *)batch.children[0]->buffers[1];
+    ASSERT_EQ(rows + 1, ids[0]);
+    if (batches == 0)
+    {
+      days= (const int32_t *)batch.children[1]->buffers[1];
+      ASSERT_EQ(1, days[0]);
+      ASSERT_EQ(1, batch.children[1]->null_count);
+      offsets= (const int64_t *)batch.children[2]->buffers[1];
+      ASSERT_EQ(0, offsets[0]);
+      ASSERT_EQ(3, offsets[1]);
+      ASSERT_EQ(6, offsets[2]);
+      ASSERT_EQ(0, memcmp(batch.children[2]->buffers[2], "onetwo", 6));
+    }
+    else if (batches == 1)
+    {
+      days= (const int32_t *)batch.children[1]->buffers[1];
+      ASSERT_EQ(-1, days[0]);
+      ASSERT_EQ(10957, days[1]);
+      ASSERT_EQ(1, batch.children[2]->null_count);
+      ASSERT_EQ(0x02, ((const uint8_t *)batch.children[2]->buffers[0])[0]);
+    }
+    rows+= batch.length;
+    batches++;
+    batch.release(&batch);
+  }
+  ASSERT_EQ(5, rows);
+  ASSERT_EQ(3, batches);
+  stream.release(&stream);
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_result_arrow.t1");
+
+  /* A zero date is NULL, so the NOT NULL column is nullable */
+  CHECKED_QUERY("SET SESSION sql_mode= ''");
+  CHECKED_QUERY("CREATE TABLE test_result_arrow.t2 (d DATE NOT NULL)");
+  CHECKED_QUERY("INSERT INTO test_result_arrow.t2 VALUES ('0000-00-00'), ('1970-01-03')");
+  CHECKED_QUERY("SELECT d FROM test_result_arrow.t2");
+  CHECK(drizzle_result_arrow_stream(result, 10, &stream));
+  ASSERT_EQ(0, stream.get_schema(&stream, &schema));
+  ASSERT_EQ(ARROW_FLAG_NULLABLE, schema.children[0]->flags);
+  schema.release(&schema);
+  ASSERT_EQ(0, stream.get_next(&stream, &batch));
+  ASSERT_EQ(2, batch.length);
+  ASSERT_EQ(1, batch.children[0]->null_count);
+  batch.release(&batch);
+  stream.release(&stream);
+  drizzle_result_free(result);
+
+  tear_down_schema("test_result_arrow");
+
+  return EXIT_SUCCESS;
+}
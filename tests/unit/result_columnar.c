@@ -0,0 +1,134 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  const int64_t *ints;
+  const uint64_t *big;
+  const double *reals;
+  const int64_t *offsets;
+  const char *data;
+  const uint8_t *validity;
+  int64_t sum= 0;
+  uint64_t x;
+
+  set_up_connection();
+  set_up_schema("test_result_columnar");
+
+  CHECKED_QUERY("CREATE TABLE test_result_columnar.t1 (a INT, b BIGINT UNSIGNED, c DOUBLE, d VARCHAR(10))");
+  CHECKED_QUERY("INSERT INTO test_result_columnar.t1 VALUES "
+                "(1, 18446744073709551615, 1.5, 'one'), "
+                "(-2, 0, NULL, ''), "
+                "(NULL, 7, -0.25, NULL), "
+                "(40, NULL, 8, 'four')");
+
+  CHECKED_QUERY("SELECT a, b, c, d FROM test_result_columnar.t1 ORDER BY b IS NULL, b DESC");
+  CHECK(drizzle_result_buffer_columnar(result));
+  ASSERT_EQ(4, drizzle_result_row_count(result));
+  ASSERT_NULL_(drizzle_row_next(result), "rows are only in the vectors");
+
+  ASSERT_EQ(DRIZZLE_VECTOR_INT64, drizzle_result_vector_type(result, 0));
+  ASSERT_EQ(DRIZZLE_VECTOR_UINT64, drizzle_result_vector_type(result, 1));
+  ASSERT_EQ(DRIZZLE_VECTOR_DOUBLE, drizzle_result_vector_type(result, 2));
+  ASSERT_EQ(DRIZZLE_VECTOR_STRING, drizzle_result_vector_type(result, 3));
+  ASSERT_EQ(DRIZZLE_VECTOR_NONE, drizzle_result_vector_type(result, 4));
+  ASSERT_NULL_(drizzle_result_vector_double(result, 0), "INT column as double");
+
+  /* Rows: b = max, 7, 0, NULL */
+  ints= drizzle_result_vector_int64(result, 0);
+  ASSERT_NOT_NULL_(ints, "no int64 vector");
+  validity= drizzle_result_vector_validity(result, 0);
+  for (x= 0; x < 4; x++)
+  {
+    if (validity[x / 8] & (1 << (x % 8)))
+    {
+      sum+= ints[x];
+    }
+  }
+  ASSERT_EQ(39, sum);
+  ASSERT_EQ(1, drizzle_result_vector_null_count(result, 0));
+  ASSERT_EQ(0, ints[1]);
+
+  big= drizzle_result_vector_uint64(result, 1);
+  ASSERT_NOT_NULL_(big, "no uint64 vector");
+  ASSERT_TRUE(big[0] == UINT64_MAX);
+  ASSERT_EQ(7, big[1]);
+  ASSERT_EQ(0x07, drizzle_result_vector_validity(result, 1)[0]);
+
+  reals= drizzle_result_vector_double(result, 2);
+  ASSERT_NOT_NULL_(reals, "no double vector");
+  ASSERT_TRUE(reals[0] > 1 && reals[0] < 2);
+  ASSERT_TRUE(reals[1] < 0);
+  ASSERT_EQ(1, drizzle_result_vector_null_count(result, 2));
+
+  /* An empty string is not NULL */
+  offsets= drizzle_result_vector_offsets(result, 3);
+  data= drizzle_result_vector_data(result, 3);
+  ASSERT_NOT_NULL_(offsets, "no string offsets");
+  ASSERT_EQ(0, offsets[0]);
+  ASSERT_EQ(0, memcmp(data, "onefour", 7));
+  ASSERT_EQ(3, offsets[1]);
+  ASSERT_EQ(3, offsets[2]);
+  ASSERT_EQ(3, offsets[3]);
+  ASSERT_EQ(7, offsets[4]);
+  ASSERT_EQ(0x0d, drizzle_result_vector_validity(result, 3)[0]);
+  drizzle_result_free(result);
+
+  /* Rows already buffered by row cannot be buffered by column */
+  CHECKED_QUERY("SELECT a FROM test_result_columnar.t1");
+  CHECK(drizzle_result_buffer(result));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_result_buffer_columnar(result));
+  ASSERT_NULL_(drizzle_result_vector_int64(result, 0), "vector of a row buffered result");
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_result_columnar.t1");
+
+  tear_down_schema("test_result_columnar");
+
+  return EXIT_SUCCESS;
+}
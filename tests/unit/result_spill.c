@@ -0,0 +1,147 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ROWS 1000
+#define TEST_FIELD_SIZE 2000
+
+static void check_rows(drizzle_result_st *result)
+{
+  drizzle_row_t row;
+  size_t *sizes;
+  char buf[32];
+  int rows= 0;
+
+  ASSERT_EQ(TEST_ROWS, drizzle_result_row_count(result));
+  while ((row= drizzle_row_next(result)) != NULL)
+  {
+    sizes= drizzle_row_field_sizes(result);
+    snprintf(buf, sizeof(buf), "%d", rows);
+    ASSERT_STREQ(buf, row[0]);
+    ASSERT_EQ(TEST_FIELD_SIZE, sizes[1]);
+    ASSERT_EQ('x', row[1][TEST_FIELD_SIZE - 1]);
+    ASSERT_EQ(0, row[1][TEST_FIELD_SIZE]);
+    rows++;
+  }
+  ASSERT_EQ(TEST_ROWS, rows);
+
+  row= drizzle_row_prev(result);
+  ASSERT_NOT_NULL_(row, "last row");
+  snprintf(buf, sizeof(buf), "%d", TEST_ROWS - 1);
+  ASSERT_STREQ(buf, row[0]);
+  row= drizzle_row_index(result, 123);
+  ASSERT_NOT_NULL_(row, "row 123");
+  ASSERT_STREQ("123", row[0]);
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  char query[16 * TEST_ROWS];
+  size_t length;
+  size_t x;
+
+  set_up_connection();
+  set_up_schema("test_result_spill");
+
+  CHECKED_QUERY("CREATE TABLE test_result_spill.t1 (a INT)");
+  length= (size_t)snprintf(query, sizeof(query), "INSERT INTO test_result_spill.t1 VALUES ");
+  for (x= 0; x < TEST_ROWS; x++)
+  {
+    length+= (size_t)snprintf(query + length, sizeof(query) - length, "%s(%zu)",
+                              x ? "," : "", x);
+  }
+  result= drizzle_query(con, query, length, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  drizzle_result_free(result);
+
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_result_buffer_spill(NULL, 0));
+
+  /* Every row in the file */
+  CHECKED_QUERY("SELECT a, REPEAT('x', 2000) FROM test_result_spill.t1 ORDER BY a");
+  CHECK(drizzle_result_buffer_spill(result, 0));
+  ASSERT_TRUE(drizzle_result_spill_size(result) >= TEST_ROWS * TEST_FIELD_SIZE);
+  check_rows(result);
+  drizzle_result_free(result);
+
+  /* The first 1 MB block of rows on the heap, the rest in the file */
+  CHECKED_QUERY("SELECT a, REPEAT('x', 2000) FROM test_result_spill.t1 ORDER BY a");
+  CHECK(drizzle_result_buffer_spill(result, 1100 * 1024));
+  ASSERT_TRUE(drizzle_result_spill_size(result) > 0);
+  ASSERT_TRUE(drizzle_result_spill_size(result) < TEST_ROWS * TEST_FIELD_SIZE);
+  check_rows(result);
+  drizzle_result_free(result);
+
+  /* Every row on the heap */
+  CHECKED_QUERY("SELECT a, REPEAT('x', 2000) FROM test_result_spill.t1 ORDER BY a");
+  CHECK(drizzle_result_buffer_spill(result, SIZE_MAX));
+  ASSERT_EQ(0, drizzle_result_spill_size(result));
+  check_rows(result);
+  drizzle_result_free(result);
+
+  /* A file which cannot be created fails with the error of mkostemp() */
+  ASSERT_EQ(0, setenv("TMPDIR", "/nonexistent/libdrizzle", 1));
+  CHECKED_QUERY("SELECT a, REPEAT('x', 2000) FROM test_result_spill.t1 ORDER BY a");
+  ASSERT_EQ(DRIZZLE_RETURN_ERRNO, drizzle_result_buffer_spill(result, 0));
+  ASSERT_NOT_NULL_(strstr(drizzle_error(con), "mkostemp"), "%s", drizzle_error(con));
+  while ((row= drizzle_row_buffer(result, &driz_ret)) != NULL)
+  {
+    drizzle_row_free(result, row);
+  }
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_result_free(result);
+  ASSERT_EQ(0, unsetenv("TMPDIR"));
+
+  CHECKED_QUERY("DROP TABLE test_result_spill.t1");
+
+  tear_down_schema("test_result_spill");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,126 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct visit_sum_st
+{
+  int64_t sum;
+  uint32_t rows;
+  uint32_t stop_after;
+};
+
+static drizzle_return_t _sum_rows(drizzle_result_st *result,
+                                  const drizzle_field_view_st *fields,
+                                  void *context)
+{
+  struct visit_sum_st *visit= (struct visit_sum_st *)context;
+  char buf[32];
+  (void)result;
+
+  ASSERT_TRUE(fields[0].size < sizeof(buf));
+  memcpy(buf, fields[0].data, fields[0].size);
+  buf[fields[0].size]= 0;
+  visit->sum+= strtoll(buf, NULL, 10);
+  if (fields[1].data == NULL)
+  {
+    visit->sum+= 1000;
+  }
+
+  visit->rows++;
+  if (visit->rows == visit->stop_after)
+  {
+    return DRIZZLE_RETURN_EOF;
+  }
+
+  return DRIZZLE_RETURN_OK;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  struct visit_sum_st visit;
+
+  set_up_connection();
+  set_up_schema("test_result_visit");
+
+  CHECKED_QUERY("CREATE TABLE test_result_visit.t1 (a INT, b VARCHAR(10))");
+  CHECKED_QUERY("INSERT INTO test_result_visit.t1 VALUES (1, 'a'), (2, NULL), (3, 'c'), (4, 'd')");
+
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_result_visit(NULL, _sum_rows, NULL));
+
+  memset(&visit, 0, sizeof(visit));
+  CHECKED_QUERY("SELECT a, b FROM test_result_visit.t1 ORDER BY a");
+  CHECK(drizzle_result_visit(result, _sum_rows, &visit));
+  ASSERT_EQ(4, visit.rows);
+  ASSERT_EQ(1010, visit.sum);
+  ASSERT_EQ(4, drizzle_result_row_count(result));
+  drizzle_result_free(result);
+
+  /* Stop after two rows, then continue with the rest */
+  memset(&visit, 0, sizeof(visit));
+  visit.stop_after= 2;
+  CHECKED_QUERY("SELECT a, b FROM test_result_visit.t1 ORDER BY a");
+  ASSERT_EQ(DRIZZLE_RETURN_EOF, drizzle_result_visit(result, _sum_rows, &visit));
+  ASSERT_EQ(2, visit.rows);
+  ASSERT_EQ(1003, visit.sum);
+  CHECK(drizzle_result_visit(result, _sum_rows, &visit));
+  ASSERT_EQ(4, visit.rows);
+  ASSERT_EQ(1010, visit.sum);
+  drizzle_result_free(result);
+
+  /* Buffered rows have been read already */
+  CHECKED_QUERY("SELECT a, b FROM test_result_visit.t1");
+  CHECK(drizzle_result_buffer(result));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_result_visit(result, _sum_rows, &visit));
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_result_visit.t1");
+
+  tear_down_schema("test_result_visit");
+
+  return EXIT_SUCCESS;
+}
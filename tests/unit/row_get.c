@@ -0,0 +1,194 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <stdint.h>
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_datetime_st datetime;
+  drizzle_decimal_st decimal;
+  drizzle_row_t row;
+  double real;
+  int rows= 0;
+
+  set_up_connection();
+  set_up_schema("test_row_get");
+
+  CHECKED_QUERY("CREATE TABLE test_row_get.t1 (a BIGINT, b BIGINT UNSIGNED,"
+                " c DECIMAL(10,2), d DOUBLE, e DATETIME(6), f TIME,"
+                " g VARCHAR(10))");
+  CHECKED_QUERY("INSERT INTO test_row_get.t1 VALUES"
+                " (-9223372036854775808, 18446744073709551615, -12.50, 2.5,"
+                "  '2024-02-29 13:45:07.250000', '-838:59:59', 'x'),"
+                " (NULL, 7, 3.00, 1e300, '1999-12-31 23:59:59', '25:00:00', '')");
+
+  ASSERT_EQ(0, drizzle_row_get_int64(NULL, 0, &driz_ret));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  CHECKED_QUERY("SELECT a, b, c, d, e, f, g FROM test_row_get.t1 ORDER BY b DESC");
+  CHECK(drizzle_column_buffer(result));
+
+  /* No row has been read yet */
+  drizzle_row_get_int64(result, 0, &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  while ((row= drizzle_row_buffer(result, &driz_ret)) != NULL)
+  {
+    rows++;
+    if (rows == 1)
+    {
+      ASSERT_EQ(INT64_MIN, drizzle_row_get_int64(result, 0, &driz_ret));
+      ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+      ASSERT_EQ(UINT64_MAX, drizzle_row_get_uint64(result, 1, &driz_ret));
+      ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+      drizzle_row_get_int64(result, 1, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED, driz_ret);
+      drizzle_row_get_uint64(result, 0, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED, driz_ret);
+
+      CHECK(drizzle_row_get_decimal_as_int128(result, 2, &decimal));
+      ASSERT_TRUE(decimal.high == 0);
+      ASSERT_TRUE(decimal.low == 1250);
+      ASSERT_TRUE(decimal.negative);
+      ASSERT_EQ(2, decimal.scale);
+      ASSERT_EQ(-12, drizzle_row_get_int64(result, 2, &driz_ret));
+      ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED, driz_ret);
+
+      real= drizzle_row_get_double(result, 3, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+      ASSERT_TRUE(real > 2.49f && real < 2.51f);
+      real= drizzle_row_get_double(result, 2, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+      ASSERT_TRUE(real > -12.51f && real < -12.49f);
+
+      ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_row_get_datetime(result, 4, &datetime));
+      ASSERT_EQ(2024, datetime.year);
+      ASSERT_EQ(2, datetime.month);
+      ASSERT_EQ(29, datetime.day);
+      ASSERT_EQ(13, datetime.hour);
+      ASSERT_EQ(45, datetime.minute);
+      ASSERT_EQ(7, datetime.second);
+      ASSERT_EQ(250000, datetime.microsecond);
+
+      /* 838 hours are 34 days and 22 hours */
+      ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_row_get_datetime(result, 5, &datetime));
+      ASSERT_TRUE(datetime.negative);
+      ASSERT_EQ(34, datetime.day);
+      ASSERT_EQ(22, datetime.hour);
+      ASSERT_EQ(59, datetime.minute);
+      ASSERT_EQ(59, datetime.second);
+
+      drizzle_row_get_int64(result, 6, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_INVALID_CONVERSION, driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_INVALID_CONVERSION,
+                drizzle_row_get_datetime(result, 0, &datetime));
+      ASSERT_EQ(DRIZZLE_RETURN_INVALID_CONVERSION,
+                drizzle_row_get_decimal_as_int128(result, 3, &decimal));
+    }
+    else
+    {
+      drizzle_row_get_int64(result, 0, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_NULL_SIZE, driz_ret);
+      ASSERT_EQ(3, drizzle_row_get_int64(result, 2, &driz_ret));
+      ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+      drizzle_row_get_int64(result, 3, &driz_ret);
+      ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED, driz_ret);
+
+      ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_row_get_datetime(result, 4, &datetime));
+      ASSERT_EQ(1999, datetime.year);
+      ASSERT_EQ(0, datetime.microsecond);
+      ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_row_get_datetime(result, 5, &datetime));
+      ASSERT_FALSE(datetime.negative);
+      ASSERT_EQ(1, datetime.day);
+      ASSERT_EQ(1, datetime.hour);
+    }
+    drizzle_row_free(result, row);
+  }
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_EQ(2, rows);
+  drizzle_result_free(result);
+
+  /* The current row of a buffered result is the one drizzle_row_next()
+   * returned last */
+  CHECKED_QUERY("SELECT a, b FROM test_row_get.t1 ORDER BY b");
+  CHECK(drizzle_result_buffer(result));
+  ASSERT_NOT_NULL_(drizzle_row_next(result), "first buffered row");
+  ASSERT_EQ(7, drizzle_row_get_uint64(result, 1, &driz_ret));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_row_get_int64(result, 2, &driz_ret);
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+  drizzle_result_free(result);
+
+  /* DECIMAL(38,10) values beyond 64 bits */
+  CHECKED_QUERY("SELECT CAST('1234567890123456789012345678.0123456789' AS DECIMAL(38,10)),"
+                " CAST('-0.5' AS DECIMAL(38,10)), CAST(NULL AS DECIMAL(38,10)), 'x'");
+  CHECK(drizzle_result_buffer(result));
+  ASSERT_NOT_NULL_(drizzle_row_next(result), "decimal row");
+  CHECK(drizzle_row_get_decimal_as_int128(result, 0, &decimal));
+  ASSERT_TRUE(decimal.high == UINT64_C(0x0949b0f6f0023313));
+  ASSERT_TRUE(decimal.low == UINT64_C(0xc449904ecc674515));
+  ASSERT_FALSE(decimal.negative);
+  ASSERT_EQ(10, decimal.scale);
+  CHECK(drizzle_row_get_decimal_as_int128(result, 1, &decimal));
+  ASSERT_TRUE(decimal.high == 0);
+  ASSERT_TRUE(decimal.low == UINT64_C(5000000000));
+  ASSERT_TRUE(decimal.negative);
+  ASSERT_EQ(10, decimal.scale);
+  ASSERT_EQ(DRIZZLE_RETURN_NULL_SIZE,
+            drizzle_row_get_decimal_as_int128(result, 2, &decimal));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_CONVERSION,
+            drizzle_row_get_decimal_as_int128(result, 3, &decimal));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_row_get_decimal_as_int128(result, 0, NULL));
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_row_get.t1");
+
+  tear_down_schema("test_row_get");
+
+  return EXIT_SUCCESS;
+}
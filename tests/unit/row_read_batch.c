@@ -0,0 +1,121 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_ROWS 1000
+#define TEST_BATCH 64
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  const drizzle_field_view_st *rows[TEST_BATCH];
+  char buf[32];
+  char query[32 * TEST_ROWS];
+  size_t length;
+  size_t count;
+  size_t x;
+  int total= 0;
+  int batches= 0;
+
+  set_up_connection();
+  set_up_schema("test_row_read_batch");
+
+  CHECKED_QUERY("CREATE TABLE test_row_read_batch.t1 (a INT, b VARCHAR(10))");
+  /* Odd rows have a NULL b */
+  length= (size_t)snprintf(query, sizeof(query), "INSERT INTO test_row_read_batch.t1 VALUES ");
+  for (x= 0; x < TEST_ROWS; x++)
+  {
+    length+= (size_t)snprintf(query + length, sizeof(query) - length, "%s(%zu, %s)",
+                              x ? "," : "", x, x % 2 ? "NULL" : "'zero'");
+  }
+  result= drizzle_query(con, query, length, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  drizzle_result_free(result);
+
+  ASSERT_EQ(0, drizzle_row_read_batch(NULL, rows, TEST_BATCH, &driz_ret));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  CHECKED_QUERY("SELECT a, b FROM test_row_read_batch.t1 ORDER BY a");
+  CHECK(drizzle_column_buffer(result));
+
+  while ((count= drizzle_row_read_batch(result, rows, TEST_BATCH, &driz_ret)) > 0)
+  {
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "drizzle_row_read_batch(): %s", drizzle_error(con));
+    ASSERT_TRUE(count <= TEST_BATCH);
+    batches++;
+    for (x= 0; x < count; x++, total++)
+    {
+      snprintf(buf, sizeof(buf), "%d", total);
+      ASSERT_EQ(strlen(buf), rows[x][0].size);
+      ASSERT_EQ(0, memcmp(rows[x][0].data, buf, rows[x][0].size));
+      if (total % 2)
+      {
+        ASSERT_NULL_(rows[x][1].data, "NULL field has data");
+      }
+      else
+      {
+        ASSERT_EQ(4, rows[x][1].size);
+        ASSERT_EQ(0, memcmp(rows[x][1].data, "zero", 4));
+      }
+    }
+  }
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_EQ(TEST_ROWS, total);
+  ASSERT_TRUE(batches < TEST_ROWS);
+  ASSERT_EQ(TEST_ROWS, drizzle_result_row_count(result));
+
+  /* The end of the result stays the end */
+  ASSERT_EQ(0, drizzle_row_read_batch(result, rows, TEST_BATCH, &driz_ret));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_row_read_batch.t1");
+
+  tear_down_schema("test_row_read_batch");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,121 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  const drizzle_field_view_st *view;
+  char buf[10];
+  char query[512];
+  size_t length;
+  int rows= 0;
+
+  set_up_connection();
+  set_up_schema("test_row_view");
+
+  CHECKED_QUERY("CREATE TABLE test_row_view.t1 (a INT, b VARCHAR(10))");
+  CHECKED_QUERY("INSERT INTO test_row_view.t1 VALUES (1, 'one'), (2, NULL), (3, '')");
+
+  ASSERT_NULL_(drizzle_row_view(NULL, &driz_ret), "view of a NULL result");
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, driz_ret);
+
+  CHECKED_QUERY("SELECT a, b FROM test_row_view.t1 ORDER BY a");
+  CHECK(drizzle_column_buffer(result));
+
+  while ((view= drizzle_row_view(result, &driz_ret)) != NULL)
+  {
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "drizzle_row_view(): %s", drizzle_error(con));
+    rows++;
+    snprintf(buf, sizeof(buf), "%d", rows);
+    ASSERT_EQ(strlen(buf), view[0].size);
+    ASSERT_EQ(0, memcmp(view[0].data, buf, view[0].size));
+    switch (rows)
+    {
+    case 1:
+      ASSERT_EQ(3, view[1].size);
+      ASSERT_EQ(0, memcmp(view[1].data, "one", 3));
+      break;
+
+    case 2:
+      ASSERT_NULL_(view[1].data, "NULL field has data");
+      ASSERT_EQ(0, view[1].size);
+      break;
+
+    default:
+      /* An empty string is not NULL */
+      ASSERT_NOT_NULL_(view[1].data, "empty field is NULL");
+      ASSERT_EQ(0, view[1].size);
+      break;
+    }
+  }
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  ASSERT_EQ(3, rows);
+  drizzle_result_free(result);
+
+  /* Fields of a wide row are reached without reading the ones before */
+  length= (size_t)snprintf(query, sizeof(query), "SELECT 0");
+  for (int x= 1; x < 60; x++)
+  {
+    length+= (size_t)snprintf(query + length, sizeof(query) - length, ", %d", x);
+  }
+  CHECKED_QUERY(query);
+  CHECK(drizzle_column_buffer(result));
+  view= drizzle_row_view(result, &driz_ret);
+  ASSERT_NOT_NULL_(view, "drizzle_row_view(): %s", drizzle_error(con));
+  ASSERT_EQ(2, view[40].size);
+  ASSERT_EQ(0, memcmp(view[40].data, "40", 2));
+  ASSERT_EQ(0, memcmp(view[59].data, "59", 2));
+  ASSERT_NULL_(drizzle_row_view(result, &driz_ret), "more than one row");
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_result_free(result);
+
+  CHECKED_QUERY("DROP TABLE test_row_view.t1");
+
+  tear_down_schema("test_row_view");
+
+  return EXIT_SUCCESS;
+}
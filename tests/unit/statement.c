@@ -150,6 +150,13 @@ int main(int argc, char *argv[])
   ASSERT_EQ_(DRIZZLE_RETURN_OK, ret, "%s", drizzle_error(con));
   ASSERT_EQ(2, drizzle_stmt_column_count(stmt));
 
+  ASSERT_EQ(1, drizzle_stmt_column_lookup(stmt, "b", &ret));
+  ASSERT_EQ(DRIZZLE_RETURN_OK, ret);
+  drizzle_stmt_column_lookup(stmt, "z", &ret);
+  ASSERT_EQ(DRIZZLE_RETURN_NOT_FOUND, ret);
+  drizzle_stmt_column_lookup(NULL, "a", &ret);
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, ret);
+
   ASSERT_EQ(0, drizzle_stmt_affected_rows(stmt));
   drizzle_stmt_get_is_unsigned(NULL, 0, &ret);
   ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, ret);
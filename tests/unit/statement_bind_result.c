@@ -0,0 +1,136 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  const char *query= "SELECT a, b, c, d FROM test_stmt_bind_result.t1 ORDER BY a";
+  int32_t a;
+  double b;
+  int64_t e;
+  char c[6];
+  size_t c_length;
+  bool c_null;
+  drizzle_datetime_st d;
+  uint32_t x;
+  int pass;
+
+  set_up_connection();
+  set_up_schema("test_stmt_bind_result");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_bind_result.t1 (a INT, b DECIMAL(5,2), c VARCHAR(20), d DATETIME)");
+  drizzle_result_free(result);
+  CHECKED_QUERY("INSERT INTO test_stmt_bind_result.t1 VALUES "
+                "(1, 1.25, 'one', '2020-02-29 13:14:15'), "
+                "(2, 2.5, NULL, '2021-01-01 00:00:00'), "
+                "(3, 3.75, 'three and more', '2022-12-31 23:59:59')");
+  drizzle_result_free(result);
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_bind_result(stmt, 0, DRIZZLE_COLUMN_TYPE_LONG, &a, 0, NULL, NULL));
+  CHECK(drizzle_stmt_bind_result(stmt, 1, DRIZZLE_COLUMN_TYPE_DOUBLE, &b, 0, NULL, NULL));
+  CHECK(drizzle_stmt_bind_result(stmt, 2, DRIZZLE_COLUMN_TYPE_VARCHAR, c, sizeof(c), &c_length, &c_null));
+  CHECK(drizzle_stmt_bind_result(stmt, 3, DRIZZLE_COLUMN_TYPE_DATETIME, &d, 0, NULL, NULL));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_stmt_bind_result(stmt, 4, DRIZZLE_COLUMN_TYPE_LONG, &a, 0, NULL, NULL));
+
+  /* Unbuffered, then buffered */
+  for (pass= 0; pass < 2; pass++)
+  {
+    CHECK(drizzle_stmt_execute(stmt));
+    if (pass == 1)
+    {
+      CHECK(drizzle_stmt_buffer(stmt));
+    }
+    for (x= 1; x <= 3; x++)
+    {
+      driz_ret= drizzle_stmt_fetch(stmt);
+      ASSERT_EQ_(x == 3 ? DRIZZLE_RETURN_TRUNCATED : DRIZZLE_RETURN_OK, driz_ret,
+                 "%s", drizzle_strerror(driz_ret));
+      ASSERT_EQ((int32_t)x, a);
+      ASSERT_EQ(x * 125, (uint32_t)(b * 100));
+      ASSERT_EQ(x == 2, c_null);
+      ASSERT_EQ(2019 + x, d.year);
+    }
+    ASSERT_EQ(0, memcmp(c, "three ", 6));
+    ASSERT_EQ(14, c_length);
+    ASSERT_EQ(DRIZZLE_RETURN_ROW_END, drizzle_stmt_fetch(stmt));
+  }
+
+  /* The getters are back once the columns are unbound */
+  CHECK(drizzle_stmt_unbind_result(stmt));
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_buffer(stmt));
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_EQ(1, drizzle_stmt_get_int(stmt, 0, &driz_ret));
+  CHECK(drizzle_stmt_close(stmt));
+
+  /* DECIMAL(65,30) values are longer than 64 characters */
+  CHECKED_QUERY("CREATE TABLE test_stmt_bind_result.t2 (e DECIMAL(65,30))");
+  drizzle_result_free(result);
+  CHECKED_QUERY("INSERT INTO test_stmt_bind_result.t2 VALUES "
+                "(12345678901234567890123456789012345.25)");
+  drizzle_result_free(result);
+
+  query= "SELECT e, e FROM test_stmt_bind_result.t2";
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_bind_result(stmt, 0, DRIZZLE_COLUMN_TYPE_DOUBLE, &b, 0, NULL, NULL));
+  CHECK(drizzle_stmt_bind_result(stmt, 1, DRIZZLE_COLUMN_TYPE_LONGLONG, &e, 0, NULL, NULL));
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_buffer(stmt));
+  /* The integer does not fit, the double is rounded */
+  ASSERT_EQ(DRIZZLE_RETURN_TRUNCATED, drizzle_stmt_fetch(stmt));
+  ASSERT_TRUE(b > 1.2345678901234e34L && b < 1.2345678901235e34L);
+  CHECK(drizzle_stmt_close(stmt));
+
+  tear_down_schema("test_stmt_bind_result");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* More than one window, so the pipeline is refilled */
+#define ROW_COUNT (DRIZZLE_STMT_BULK_WINDOW * 2 + 10)
+
+static uint32_t ids[ROW_COUNT];
+static const char *names[ROW_COUNT];
+static bool nulls[ROW_COUNT];
+static const char *query= "INSERT INTO test_stmt_bulk.t1 (a, b, c) VALUES (?, ?, ?)";
+
+static void fill_rows(void)
+{
+  uint32_t i;
+
+  for (i= 0; i < ROW_COUNT; i++)
+  {
+    ids[i]= i + 1;
+    names[i]= (i % 3 == 0) ? NULL : "row";
+    nulls[i]= (i % 2 == 0);
+  }
+}
+
+/* One execution per row, pipelined in windows */
+static void check_pipelined(void)
+{
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  drizzle_stmt_st *stmt;
+  uint32_t i;
+
+  fill_rows();
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_stmt_execute_bulk(stmt, 0));
+  ASSERT_EQ(DRIZZLE_RETURN_STMT_ERROR, drizzle_stmt_execute_bulk(stmt, 1));
+
+  /* Temporal values are not accepted as arrays */
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_stmt_set_param_array(stmt, 0, DRIZZLE_COLUMN_TYPE_DATETIME,
+                                         ids, NULL, NULL, false));
+
+  CHECK(drizzle_stmt_set_param_array(stmt, 0, DRIZZLE_COLUMN_TYPE_LONG, ids,
+                                     NULL, NULL, true));
+  CHECK(drizzle_stmt_set_param_array(stmt, 1, DRIZZLE_COLUMN_TYPE_STRING,
+                                     names, NULL, NULL, false));
+  /* Scalar parameters repeat for every row */
+  CHECK(drizzle_stmt_set_int(stmt, 2, 7, false));
+  CHECK(drizzle_stmt_execute_bulk(stmt, ROW_COUNT));
+  ASSERT_EQ(ROW_COUNT, drizzle_stmt_affected_rows(stmt));
+
+  /* A duplicate key stops the bulk execution after the current window */
+  for (i= 0; i < ROW_COUNT; i++)
+  {
+    ids[i]= ROW_COUNT + 1 + i;
+  }
+  ids[5]= 1;
+  CHECK(drizzle_stmt_set_param_array(stmt, 2, DRIZZLE_COLUMN_TYPE_LONG, ids,
+                                     NULL, nulls, false));
+  driz_ret= drizzle_stmt_execute_bulk(stmt, ROW_COUNT);
+  ASSERT_EQ_(DRIZZLE_RETURN_ERROR_CODE, driz_ret, "%s",
+             drizzle_strerror(driz_ret));
+  ASSERT_EQ(5, drizzle_stmt_bulk_error_row(stmt));
+  CHECK(drizzle_stmt_close(stmt));
+
+  CHECKED_QUERY("SELECT COUNT(*), COUNT(b), COUNT(c), SUM(c = 7) "
+                "FROM test_stmt_bulk.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_EQ(ROW_COUNT + DRIZZLE_STMT_BULK_WINDOW - 1, atoi(row[0]));
+  ASSERT_EQ(ROW_COUNT + DRIZZLE_STMT_BULK_WINDOW - 1
+            - (ROW_COUNT + 2) / 3 - (DRIZZLE_STMT_BULK_WINDOW + 2) / 3,
+            atoi(row[1]));
+  ASSERT_EQ(ROW_COUNT + DRIZZLE_STMT_BULK_WINDOW / 2 - 1, atoi(row[2]));
+  ASSERT_EQ(ROW_COUNT, atoi(row[3]));
+  drizzle_result_free(result);
+}
+
+/* COM_STMT_BULK_EXECUTE on servers with bulk operations, otherwise the
+ * same pipelined executions. The rows of a failed command may or may not
+ * have been applied, that is up to the server. */
+static void check_bulk_operations(void)
+{
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  drizzle_stmt_st *stmt;
+  uint32_t i;
+
+  CHECKED_QUERY("TRUNCATE TABLE test_stmt_bulk.t1");
+  drizzle_result_free(result);
+
+  fill_rows();
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_set_param_array(stmt, 0, DRIZZLE_COLUMN_TYPE_LONG, ids,
+                                     NULL, NULL, true));
+  CHECK(drizzle_stmt_set_param_array(stmt, 1, DRIZZLE_COLUMN_TYPE_STRING,
+                                     names, NULL, NULL, false));
+  CHECK(drizzle_stmt_set_param_array(stmt, 2, DRIZZLE_COLUMN_TYPE_LONG, ids,
+                                     NULL, nulls, false));
+  CHECK(drizzle_stmt_execute_bulk(stmt, ROW_COUNT));
+  ASSERT_EQ(ROW_COUNT, drizzle_stmt_affected_rows(stmt));
+
+  CHECKED_QUERY("SELECT COUNT(*), COUNT(b), COUNT(c), SUM(a), SUM(c) "
+                "FROM test_stmt_bulk.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_EQ(ROW_COUNT, atoi(row[0]));
+  ASSERT_EQ(ROW_COUNT - (ROW_COUNT + 2) / 3, atoi(row[1]));
+  ASSERT_EQ(ROW_COUNT / 2, atoi(row[2]));
+  ASSERT_EQ((uint64_t)ROW_COUNT * (ROW_COUNT + 1) / 2,
+            strtoull(row[3], NULL, 10));
+  /* c is set on the odd rows, whose a is even */
+  ASSERT_EQ((uint64_t)(ROW_COUNT / 2) * (ROW_COUNT / 2 + 1),
+            strtoull(row[4], NULL, 10));
+  drizzle_result_free(result);
+
+  for (i= 0; i < ROW_COUNT; i++)
+  {
+    ids[i]= ROW_COUNT + 1 + i;
+  }
+  ids[5]= 1;
+  driz_ret= drizzle_stmt_execute_bulk(stmt, ROW_COUNT);
+  ASSERT_EQ_(DRIZZLE_RETURN_ERROR_CODE, driz_ret, "%s",
+             drizzle_strerror(driz_ret));
+  ASSERT_TRUE(drizzle_stmt_bulk_error_row(stmt) <= 5);
+  CHECK(drizzle_stmt_close(stmt));
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+
+  opts= drizzle_options_create();
+  ASSERT_NOT_NULL(opts);
+  drizzle_options_set_bulk_operations(opts, false);
+
+  set_up_connection();
+  set_up_schema("test_stmt_bulk");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_bulk.t1 (a INT UNSIGNED PRIMARY KEY, "
+                "b VARCHAR(16), c INT)");
+  drizzle_result_free(result);
+
+  check_pipelined();
+
+  /* Reconnect with bulk operations, the default */
+  close_connection_on_exit();
+  opts= NULL;
+  set_up_connection();
+
+  check_bulk_operations();
+
+  tear_down_schema("test_stmt_bulk");
+
+  return EXIT_SUCCESS;
+}
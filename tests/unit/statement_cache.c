@@ -0,0 +1,166 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2026 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *select_query= "SELECT a FROM test_stmt_cache.t1 WHERE a = ?";
+static const char *insert_query= "INSERT INTO test_stmt_cache.t1 (a) VALUES (?)";
+static const char *delete_query= "DELETE FROM test_stmt_cache.t1 WHERE a = ?";
+
+static drizzle_stmt_st *prepare(const char *query)
+{
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt= drizzle_stmt_prepare_cached(con, query, strlen(query),
+                                                     &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  ASSERT_NOT_NULL(stmt);
+  return stmt;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  drizzle_stmt_st *select_stmt;
+  char query[32];
+
+  ASSERT_EQ(0, drizzle_stmt_cache_size(NULL));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, drizzle_set_stmt_cache_size(NULL, 1));
+
+  set_up_connection();
+  set_up_schema("test_stmt_cache");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_cache.t1 (a INT)");
+  drizzle_result_free(result);
+
+  ASSERT_EQ(0, drizzle_stmt_cache_size(con));
+  CHECK(drizzle_set_stmt_cache_size(con, 2));
+  ASSERT_EQ(2, drizzle_stmt_cache_size(con));
+
+  /* The second prepare of the same text is a hit */
+  select_stmt= prepare(select_query);
+  ASSERT_EQ(select_stmt, prepare(select_query));
+  ASSERT_EQ(1, drizzle_stmt_cache_hits(con));
+  ASSERT_EQ(1, drizzle_stmt_cache_misses(con));
+  CHECK(drizzle_stmt_close(select_stmt));
+  CHECK(drizzle_stmt_close(select_stmt));
+
+  stmt= prepare(insert_query);
+  CHECK(drizzle_stmt_set_int(stmt, 0, 1, false));
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_close(stmt));
+  ASSERT_EQ(2, drizzle_stmt_cache_count(con));
+
+  /* The select statement is the least recently used one and gets evicted;
+   * it is closed on the server by the next command */
+  stmt= prepare(delete_query);
+  ASSERT_EQ(2, drizzle_stmt_cache_count(con));
+  ASSERT_EQ(3, drizzle_stmt_cache_misses(con));
+  CHECK(drizzle_stmt_close(stmt));
+  CHECKED_QUERY("SELECT 1");
+  drizzle_result_free(result);
+
+  stmt= prepare(insert_query);
+  ASSERT_EQ(2, drizzle_stmt_cache_hits(con));
+  CHECK(drizzle_stmt_set_int(stmt, 0, 2, false));
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_close(stmt));
+
+  select_stmt= prepare(select_query);
+  ASSERT_EQ(4, drizzle_stmt_cache_misses(con));
+  CHECK(drizzle_stmt_set_int(select_stmt, 0, 2, false));
+  CHECK(drizzle_stmt_execute(select_stmt));
+  CHECK(drizzle_stmt_buffer(select_stmt));
+  ASSERT_EQ(1, drizzle_stmt_row_count(select_stmt));
+
+  /* Closing a cached statement releases it back to the cache */
+  CHECK(drizzle_stmt_close(select_stmt));
+  ASSERT_EQ(2, drizzle_stmt_cache_count(con));
+  ASSERT_EQ(select_stmt, prepare(select_query));
+  ASSERT_EQ(3, drizzle_stmt_cache_hits(con));
+
+  /* A statement in use is not evicted, the cache grows until it is released */
+  stmt= prepare(insert_query);
+  CHECK(drizzle_set_stmt_cache_size(con, 1));
+  ASSERT_EQ(2, drizzle_stmt_cache_count(con));
+  CHECK(drizzle_stmt_set_int(select_stmt, 0, 2, false));
+  CHECK(drizzle_stmt_execute(select_stmt));
+  CHECK(drizzle_stmt_buffer(select_stmt));
+  ASSERT_EQ(1, drizzle_stmt_row_count(select_stmt));
+  CHECK(drizzle_stmt_close(select_stmt));
+  ASSERT_EQ(1, drizzle_stmt_cache_count(con));
+  CHECK(drizzle_stmt_close(stmt));
+  ASSERT_EQ(1, drizzle_stmt_cache_count(con));
+
+  CHECK(drizzle_set_stmt_cache_size(con, 0));
+  ASSERT_EQ(0, drizzle_stmt_cache_count(con));
+
+  /* Without a cache every prepare goes to the server */
+  stmt= prepare(select_query);
+  CHECK(drizzle_stmt_close(stmt));
+  ASSERT_EQ(4, drizzle_stmt_cache_misses(con));
+
+  /* Shrinking a full cache closes every statement with the next command */
+  CHECK(drizzle_set_stmt_cache_size(con, 100));
+  for (int x= 0; x < 100; x++)
+  {
+    snprintf(query, sizeof(query), "SELECT %d + ?", x);
+    CHECK(drizzle_stmt_close(prepare(query)));
+  }
+  ASSERT_EQ(100, drizzle_stmt_cache_count(con));
+  snprintf(query, sizeof(query), "SELECT %d + ?", 42);
+  CHECK(drizzle_stmt_close(prepare(query)));
+  ASSERT_EQ(5, drizzle_stmt_cache_hits(con));
+
+  CHECK(drizzle_set_stmt_cache_size(con, 0));
+  ASSERT_EQ(0, drizzle_stmt_cache_count(con));
+  CHECKED_QUERY("SELECT 1");
+  drizzle_result_free(result);
+
+  tear_down_schema("test_stmt_cache");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/statement.hpp>
+#include "tests/unit/common.h"
+
+#include <cstring>
+#include <string>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  const char *insert_query= "INSERT INTO test_stmt_cxx.t1 VALUES (?, ?, ?, ?, ?, ?)";
+  const char *select_query= "SELECT a, b, c, d, e, f FROM test_stmt_cxx.t1 ORDER BY a";
+  drizzle_datetime_st timestamp;
+  std::string text(300, 'x');
+  size_t length;
+  const uint64_t big= ((uint64_t)1 << 63) + 5;
+
+  set_up_connection();
+  set_up_schema("test_stmt_cxx");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_cxx.t1 (a INT, b BIGINT UNSIGNED, "
+                "c DOUBLE, d VARCHAR(400), e DATETIME(3), f TINYINT)");
+  drizzle_result_free(result);
+
+  drizzle::statement insert(drizzle_stmt_prepare(con, insert_query,
+                                                 strlen(insert_query),
+                                                 &driz_ret));
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  memset(&timestamp, 0, sizeof(timestamp));
+  timestamp.year= 2020;
+  timestamp.month= 2;
+  timestamp.day= 29;
+  timestamp.hour= 13;
+  timestamp.microsecond= 250000;
+
+  CHECK(insert.execute(-1, big, 0.5, "short",
+                       timestamp, (int8_t)-7));
+  CHECK(insert.execute(2, 3U, 1.5, text, timestamp, true));
+  CHECK(insert.execute(3, nullptr, 2.5, (const char *)NULL, nullptr, false));
+  ASSERT_EQ(1, drizzle_stmt_affected_rows(insert.get()));
+
+  /* The parameter count is checked when executing */
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT, insert.execute(4, 5));
+
+  /* The C interface still binds its own parameters afterwards */
+  CHECK(drizzle_stmt_set_int(insert.get(), 0, 4, false));
+  CHECK(drizzle_stmt_set_null(insert.get(), 1));
+  CHECK(drizzle_stmt_set_double(insert.get(), 2, 3.5));
+  CHECK(drizzle_stmt_set_string(insert.get(), 3, (char *)"c", 1));
+  CHECK(drizzle_stmt_set_null(insert.get(), 4));
+  CHECK(drizzle_stmt_set_tiny(insert.get(), 5, 9, false));
+  CHECK(drizzle_stmt_execute(insert.get()));
+  CHECK(drizzle_stmt_close(insert.get()));
+
+  drizzle_stmt_st *stmt= drizzle_stmt_prepare(con, select_query,
+                                              strlen(select_query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_execute(stmt));
+  CHECK(drizzle_stmt_buffer(stmt));
+
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_EQ(-1, (int32_t)drizzle_stmt_get_int(stmt, 0, &driz_ret));
+  ASSERT_EQ(big, drizzle_stmt_get_bigint(stmt, 1, &driz_ret));
+  ASSERT_STREQ("short", drizzle_stmt_get_string(stmt, 3, &length, &driz_ret));
+  ASSERT_STREQ("2020-02-29 13:00:00.250000", drizzle_stmt_get_string(stmt, 4, &length, &driz_ret));
+  ASSERT_EQ(-7, (int32_t)drizzle_stmt_get_int(stmt, 5, &driz_ret));
+
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_EQ(3, drizzle_stmt_get_bigint(stmt, 1, &driz_ret));
+  drizzle_stmt_get_string(stmt, 3, &length, &driz_ret);
+  ASSERT_EQ(text.size(), length);
+  ASSERT_EQ(1, drizzle_stmt_get_int(stmt, 5, &driz_ret));
+
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_TRUE(drizzle_stmt_get_is_null(stmt, 1, &driz_ret));
+  ASSERT_TRUE(drizzle_stmt_get_is_null(stmt, 3, &driz_ret));
+  ASSERT_TRUE(drizzle_stmt_get_is_null(stmt, 4, &driz_ret));
+  ASSERT_EQ(0, drizzle_stmt_get_int(stmt, 5, &driz_ret));
+
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_EQ(4, drizzle_stmt_get_int(stmt, 0, &driz_ret));
+  ASSERT_STREQ("c", drizzle_stmt_get_string(stmt, 3, &length, &driz_ret));
+  ASSERT_EQ(9, drizzle_stmt_get_int(stmt, 5, &driz_ret));
+
+  ASSERT_EQ(DRIZZLE_RETURN_ROW_END, drizzle_stmt_fetch(stmt));
+  CHECK(drizzle_stmt_close(stmt));
+
+  tear_down_schema("test_stmt_cxx");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* More than two chunks, split over buffers which do not line up with them */
+#define DATA_SIZE (DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE * 2 + 1000)
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_row_t row;
+  drizzle_stmt_st *stmt;
+  const char *query= "INSERT INTO test_stmt_long_data.t1 VALUES (?, ?)";
+  unsigned char *data;
+  struct iovec iov[3];
+  FILE *file;
+  size_t x;
+
+  set_up_connection();
+  set_up_schema("test_stmt_long_data");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_long_data.t1 (a LONGBLOB, b LONGBLOB)");
+  drizzle_result_free(result);
+
+  data= (unsigned char *)malloc(DATA_SIZE);
+  ASSERT_NOT_NULL(data);
+  for (x= 0; x < DATA_SIZE; x++)
+  {
+    data[x]= (unsigned char)('a' + x % 26);
+  }
+
+  file= tmpfile();
+  ASSERT_NOT_NULL(file);
+  ASSERT_EQ(DATA_SIZE, fwrite(data, 1, DATA_SIZE, file));
+  fflush(file);
+  rewind(file);
+
+  iov[0].iov_base= data;
+  iov[0].iov_len= 10;
+  iov[1].iov_base= data + 10;
+  iov[1].iov_len= DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE;
+  iov[2].iov_base= data + 10 + DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE;
+  iov[2].iov_len= DATA_SIZE - 10 - DRIZZLE_STMT_LONG_DATA_CHUNK_SIZE;
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_stmt_send_long_data_iov(stmt, 0, NULL, 1));
+  ASSERT_EQ(DRIZZLE_RETURN_INVALID_ARGUMENT,
+            drizzle_stmt_send_long_data_fd(stmt, 2, fileno(file)));
+
+  CHECK(drizzle_stmt_send_long_data_iov(stmt, 0, iov, 3));
+  CHECK(drizzle_stmt_send_long_data_fd(stmt, 1, fileno(file)));
+  CHECK(drizzle_stmt_execute(stmt));
+  ASSERT_EQ(1, drizzle_stmt_affected_rows(stmt));
+  CHECK(drizzle_stmt_close(stmt));
+  fclose(file);
+  free(data);
+
+  CHECKED_QUERY("SELECT LENGTH(a), a = b, SUBSTRING(a, 2000001, 3) "
+                "FROM test_stmt_long_data.t1");
+  drizzle_result_buffer(result);
+  row= drizzle_row_next(result);
+  ASSERT_NOT_NULL_(row, "Could not get the row");
+  ASSERT_EQ(DATA_SIZE, atoi(row[0]));
+  ASSERT_EQ(1, atoi(row[1]));
+  /* Bytes are 'a' + offset % 26 */
+  ASSERT_STREQ("cde", row[2]);
+  drizzle_result_free(result);
+
+  tear_down_schema("test_stmt_long_data");
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  const char *query= "SELECT a, b FROM test_stmt_metadata.t1 WHERE a > ? ORDER BY a";
+  const char *value;
+  size_t length;
+  uint32_t execution;
+
+  opts= drizzle_options_create();
+  ASSERT_NOT_NULL(opts);
+  drizzle_options_set_cache_metadata(opts, true);
+
+  set_up_connection();
+  set_up_schema("test_stmt_metadata");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_metadata.t1 (a INT, b VARCHAR(10))");
+  drizzle_result_free(result);
+  CHECKED_QUERY("INSERT INTO test_stmt_metadata.t1 VALUES (1, 'one'), (2, 'two'), (3, 'three')");
+  drizzle_result_free(result);
+
+  stmt= drizzle_stmt_prepare(con, query, strlen(query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  /* Later executions may get the column definitions from the cache, the
+   * results must be the same */
+  for (execution= 0; execution < 3; execution++)
+  {
+    CHECK(drizzle_stmt_set_int(stmt, 0, execution, false));
+    CHECK(drizzle_stmt_execute(stmt));
+    CHECK(drizzle_stmt_buffer(stmt));
+    ASSERT_EQ(2, drizzle_stmt_column_count(stmt));
+    ASSERT_EQ(3 - execution, drizzle_stmt_row_count(stmt));
+
+    CHECK(drizzle_stmt_fetch(stmt));
+    ASSERT_EQ(execution + 1, drizzle_stmt_get_int_from_name(stmt, "a", &driz_ret));
+    ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+    value= drizzle_stmt_get_string_from_name(stmt, "b", &length, &driz_ret);
+    ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+    ASSERT_NOT_NULL(value);
+    ASSERT_EQ(strlen(execution == 0 ? "one" : "two"), length);
+  }
+
+  CHECK(drizzle_stmt_close(stmt));
+
+  tear_down_schema("test_stmt_metadata");
+
+  return EXIT_SUCCESS;
+}
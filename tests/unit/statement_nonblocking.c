@@ -0,0 +1,137 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+/* Wait for the connection if the call returned DRIZZLE_RETURN_IO_WAIT, in
+ * which case it has to be called again */
+static bool io_wait(drizzle_return_t ret)
+{
+  if (ret != DRIZZLE_RETURN_IO_WAIT)
+  {
+    return false;
+  }
+
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, drizzle_wait(con), "%s", drizzle_error(con));
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  const char *select_query= "SELECT ? + 1, REPEAT('x', ?)";
+  const char *set_query= "SET @nonblocking = ?";
+  uint32_t values[3]= { 1, 2, 3 };
+  uint32_t x;
+
+  opts= drizzle_options_create();
+  drizzle_options_set_non_blocking(opts, true);
+  con= drizzle_create(getenv("MYSQL_SERVER"),
+                      getenv("MYSQL_PORT") ? atoi(getenv("MYSQL_PORT"))
+                                           : DRIZZLE_DEFAULT_TCP_PORT,
+                      getenv("MYSQL_USER"), getenv("MYSQL_PASSWORD"),
+                      getenv("MYSQL_SCHEMA"), opts);
+  ASSERT_NOT_NULL_(con, "Drizzle connection object creation error");
+
+  while (io_wait(driz_ret= drizzle_connect(con))) {}
+  SKIP_IF_(driz_ret == DRIZZLE_RETURN_COULD_NOT_CONNECT, "%s",
+           drizzle_strerror(driz_ret));
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  /* Every call is repeated until the statement stops waiting */
+  do
+  {
+    stmt= drizzle_stmt_prepare(con, select_query, strlen(select_query), &driz_ret);
+  } while (io_wait(driz_ret));
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  ASSERT_NOT_NULL(stmt);
+  ASSERT_EQ(2, drizzle_stmt_param_count(stmt));
+
+  for (x= 0; x < 3; x++)
+  {
+    CHECK(drizzle_stmt_set_int(stmt, 0, x, false));
+    CHECK(drizzle_stmt_set_int(stmt, 1, 100000 * x, false));
+    while (io_wait(driz_ret= drizzle_stmt_execute(stmt))) {}
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    ASSERT_EQ(2, drizzle_stmt_column_count(stmt));
+
+    /* Buffered and unbuffered fetching */
+    if (x != 1)
+    {
+      while (io_wait(driz_ret= drizzle_stmt_buffer(stmt))) {}
+      ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    }
+    while (io_wait(driz_ret= drizzle_stmt_fetch(stmt))) {}
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    ASSERT_EQ(x + 1, drizzle_stmt_get_bigint(stmt, 0, &driz_ret));
+    while (io_wait(driz_ret= drizzle_stmt_fetch(stmt))) {}
+    ASSERT_EQ(DRIZZLE_RETURN_ROW_END, driz_ret);
+  }
+
+  while (io_wait(driz_ret= drizzle_stmt_reset(stmt))) {}
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_close(stmt));
+
+  /* The close is sent along with the next command */
+  do
+  {
+    stmt= drizzle_stmt_prepare(con, set_query, strlen(set_query), &driz_ret);
+  } while (io_wait(driz_ret));
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  CHECK(drizzle_stmt_set_param_array(stmt, 0, DRIZZLE_COLUMN_TYPE_LONG, values,
+                                     NULL, NULL, false));
+  while (io_wait(driz_ret= drizzle_stmt_execute_bulk(stmt, 3))) {}
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  CHECK(drizzle_stmt_close(stmt));
+
+  /* Frees the connection even if the quit was not sent yet */
+  drizzle_quit(con);
+  con= NULL;
+  drizzle_options_destroy(opts);
+  opts= NULL;
+
+  return EXIT_SUCCESS;
+}
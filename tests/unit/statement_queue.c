@@ -0,0 +1,208 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ROWS 200
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *insert;
+  drizzle_stmt_st *select;
+  drizzle_stmt_st *stmt;
+  const char *insert_query= "INSERT INTO test_stmt_queue.t1 VALUES (?)";
+  const char *select_query= "SELECT a FROM test_stmt_queue.t1 WHERE a < ? ORDER BY a";
+  uint32_t queued= 0;
+  uint32_t read= 0;
+  drizzle_st *victim;
+  drizzle_stmt_st *sleep_stmt;
+  const char *sleep_query= "SELECT SLEEP(?)";
+  char kill_query[32];
+  int x;
+
+  set_up_connection();
+  set_up_schema("test_stmt_queue");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_queue.t1 (a INT PRIMARY KEY)");
+  drizzle_result_free(result);
+
+  insert= drizzle_stmt_prepare(con, insert_query, strlen(insert_query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  select= drizzle_stmt_prepare(con, select_query, strlen(select_query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+
+  /* Queue more executions than the limit, reading replies when it is hit */
+  CHECK(drizzle_set_stmt_queue_limit(con, 64));
+  while (read < ROWS)
+  {
+    while (queued < ROWS)
+    {
+      CHECK(drizzle_stmt_set_int(insert, 0, queued, false));
+      driz_ret= drizzle_stmt_queue(insert);
+      if (driz_ret == DRIZZLE_RETURN_NOT_READY)
+      {
+        ASSERT_EQ(64, drizzle_stmt_queue_count(con));
+        break;
+      }
+      ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+      queued++;
+    }
+
+    stmt= drizzle_stmt_queue_read(con, &driz_ret);
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    ASSERT_TRUE(stmt == insert);
+    ASSERT_EQ(1, drizzle_stmt_affected_rows(stmt));
+    read++;
+  }
+  ASSERT_NULL_(drizzle_stmt_queue_read(con, &driz_ret), "queue is empty");
+
+  /* Replies come back in order, a duplicate key only fails its execution */
+  CHECK(drizzle_stmt_set_int(select, 0, 3, false));
+  CHECK(drizzle_stmt_queue(select));
+  CHECK(drizzle_stmt_set_int(insert, 0, 5, false));
+  CHECK(drizzle_stmt_queue(insert));
+  CHECK(drizzle_stmt_set_int(select, 0, 100, false));
+  CHECK(drizzle_stmt_queue(select));
+  CHECK(drizzle_stmt_set_int(insert, 0, ROWS, false));
+  CHECK(drizzle_stmt_queue(insert));
+  CHECK(drizzle_stmt_queue_flush(con));
+  ASSERT_EQ(DRIZZLE_RETURN_NOT_READY, drizzle_stmt_execute(insert));
+
+  stmt= drizzle_stmt_queue_read(con, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  ASSERT_TRUE(stmt == select);
+  CHECK(drizzle_stmt_buffer(stmt));
+  ASSERT_EQ(3, drizzle_stmt_row_count(stmt));
+
+  stmt= drizzle_stmt_queue_read(con, &driz_ret);
+  ASSERT_TRUE(stmt == insert);
+  ASSERT_EQ(DRIZZLE_RETURN_ERROR_CODE, driz_ret);
+
+  /* Only one row is read, the others are skipped */
+  stmt= drizzle_stmt_queue_read(con, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  ASSERT_TRUE(stmt == select);
+  CHECK(drizzle_stmt_fetch(stmt));
+  ASSERT_EQ(0, drizzle_stmt_get_int(stmt, 0, &driz_ret));
+
+  stmt= drizzle_stmt_queue_read(con, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  ASSERT_TRUE(stmt == insert);
+  ASSERT_EQ(0, drizzle_stmt_queue_count(con));
+
+  /* More executions can be sent before the replies to earlier ones are
+   * read */
+  for (x= 0; x < 4; x++)
+  {
+    CHECK(drizzle_stmt_set_int(insert, 0, ROWS + 1 + x, false));
+    CHECK(drizzle_stmt_queue(insert));
+    if (x % 2 == 1)
+    {
+      CHECK(drizzle_stmt_queue_flush(con));
+    }
+    if (x == 1)
+    {
+      stmt= drizzle_stmt_queue_read(con, &driz_ret);
+      ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    }
+  }
+  ASSERT_EQ(3, drizzle_stmt_queue_count(con));
+  while (drizzle_stmt_queue_count(con) > 0)
+  {
+    stmt= drizzle_stmt_queue_read(con, &driz_ret);
+    ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+    ASSERT_EQ(1, drizzle_stmt_affected_rows(stmt));
+  }
+
+  CHECK(drizzle_stmt_close(insert));
+  CHECK(drizzle_stmt_close(select));
+
+  tear_down_schema("test_stmt_queue");
+
+  /* A connection killed while executions are queued drops the queue */
+  victim= drizzle_create(getenv("MYSQL_SERVER"),
+                         getenv("MYSQL_PORT") ? atoi(getenv("MYSQL_PORT"))
+                                              : DRIZZLE_DEFAULT_TCP_PORT,
+                         getenv("MYSQL_USER"), getenv("MYSQL_PASSWORD"),
+                         getenv("MYSQL_SCHEMA"), NULL);
+  ASSERT_NOT_NULL(victim);
+  driz_ret= drizzle_connect(victim);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(victim));
+  sleep_stmt= drizzle_stmt_prepare(victim, sleep_query, strlen(sleep_query),
+                                   &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(victim));
+  for (x= 0; x < 3; x++)
+  {
+    ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_stmt_set_int(sleep_stmt, 0, x == 1 ? 30 : 0, false));
+    ASSERT_EQ(DRIZZLE_RETURN_OK, drizzle_stmt_queue(sleep_stmt));
+  }
+  stmt= drizzle_stmt_queue_read(victim, &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(victim));
+
+  snprintf(kill_query, sizeof(kill_query), "KILL %" PRIu32,
+           drizzle_thread_id(victim));
+  CHECKED_QUERY(kill_query);
+  drizzle_result_free(result);
+
+  /* The server may report the kill before it closes the connection */
+  for (x= 0; x < 2; x++)
+  {
+    stmt= drizzle_stmt_queue_read(victim, &driz_ret);
+    if (driz_ret != DRIZZLE_RETURN_ERROR_CODE)
+    {
+      break;
+    }
+  }
+  ASSERT_NEQ_(DRIZZLE_RETURN_OK, driz_ret, "the connection was killed");
+  ASSERT_EQ(0, drizzle_stmt_queue_count(victim));
+  ASSERT_NULL_(drizzle_stmt_queue_read(victim, &driz_ret), "queue is empty");
+  ASSERT_EQ(DRIZZLE_RETURN_OK, driz_ret);
+  drizzle_quit(victim);
+
+  return EXIT_SUCCESS;
+}
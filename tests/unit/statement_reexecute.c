@@ -0,0 +1,103 @@
+/*  vim:expandtab:shiftwidth=2:tabstop=2:smarttab:
+ *
+ *  Drizzle Client & Protocol Library
+ *
+ * Copyright (C) 2013 Drizzle Developer Group
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ *     * Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following disclaimer
+ * in the documentation and/or other materials provided with the
+ * distribution.
+ *
+ *     * The names of its contributors may not be used to endorse or
+ * promote products derived from this software without specific prior
+ * written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <yatl/lite.h>
+
+#include <libdrizzle-redux/libdrizzle.h>
+#include "tests/unit/common.h"
+
+#include <string.h>
+
+/* Larger than the connection buffer, so the parameters are packed into the
+ * statement's own buffer */
+#define LARGE_SIZE (DRIZZLE_DEFAULT_BUFFER_SIZE * 2)
+
+int main(int argc, char *argv[])
+{
+  (void)argc;
+  (void)argv;
+  drizzle_result_st *result;
+  drizzle_return_t driz_ret;
+  drizzle_stmt_st *stmt;
+  const char *insert_query= "INSERT INTO test_stmt_reexecute.t1 VALUES (?, ?)";
+  const char *select_query= "SELECT a, LENGTH(b) FROM test_stmt_reexecute.t1 WHERE a = ?";
+  char *large;
+  uint32_t x;
+
+  set_up_connection();
+  set_up_schema("test_stmt_reexecute");
+
+  CHECKED_QUERY("CREATE TABLE test_stmt_reexecute.t1 (a INT, b LONGBLOB)");
+  drizzle_result_free(result);
+
+  large= (char *)malloc(LARGE_SIZE);
+  ASSERT_NOT_NULL(large);
+  memset(large, 'x', LARGE_SIZE);
+
+  stmt= drizzle_stmt_prepare(con, insert_query, strlen(insert_query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  for (x= 0; x < 3; x++)
+  {
+    CHECK(drizzle_stmt_set_int(stmt, 0, x, false));
+    CHECK(drizzle_stmt_set_string(stmt, 1, large, x == 2 ? LARGE_SIZE : x + 1));
+    CHECK(drizzle_stmt_execute(stmt));
+    ASSERT_EQ(1, drizzle_stmt_affected_rows(stmt));
+  }
+  CHECK(drizzle_stmt_close(stmt));
+  free(large);
+
+  /* Every execution reuses the result of the previous one */
+  stmt= drizzle_stmt_prepare(con, select_query, strlen(select_query), &driz_ret);
+  ASSERT_EQ_(DRIZZLE_RETURN_OK, driz_ret, "%s", drizzle_error(con));
+  for (x= 0; x < 3; x++)
+  {
+    CHECK(drizzle_stmt_set_int(stmt, 0, x, false));
+    CHECK(drizzle_stmt_execute(stmt));
+    CHECK(drizzle_stmt_buffer(stmt));
+    ASSERT_EQ(2, drizzle_stmt_column_count(stmt));
+    ASSERT_EQ(1, drizzle_stmt_row_count(stmt));
+    CHECK(drizzle_stmt_fetch(stmt));
+    ASSERT_EQ(x, drizzle_stmt_get_int(stmt, 0, &driz_ret));
+    ASSERT_EQ(x == 2 ? LARGE_SIZE : x + 1, drizzle_stmt_get_bigint(stmt, 1, &driz_ret));
+    ASSERT_EQ(DRIZZLE_RETURN_ROW_END, drizzle_stmt_fetch(stmt));
+  }
+  CHECK(drizzle_stmt_close(stmt));
+
+  tear_down_schema("test_stmt_reexecute");
+
+  return EXIT_SUCCESS;
+}